@@ -22,8 +22,10 @@
 #include "graph_properties.hh"
 
 #include "graph_clustering.hh"
+#include "graph_orbits.hh"
 
 #include "random.hh"
+#include "numpy_bind.hh"
 
 #include <boost/python.hpp>
 
@@ -80,9 +82,135 @@ void local_clustering(GraphInterface& g, boost::any prop, boost::any weight)
          weight_props_t(), writable_vertex_scalar_properties())(weight, prop);
 }
 
+// number of triangles to which each edge belongs (parallel edges are counted
+// only once)
+void edge_triangles(GraphInterface& g, boost::any prop)
+{
+    run_action<graph_tool::detail::never_directed>()
+        (g,
+         [&](auto& graph, auto eprop)
+         {
+             oriented_adjacency oa(graph);
+             vector<size_t> support(oa.num_slots());
+             oa.triangles([&](auto, auto, auto, auto uv, auto uw, auto vw)
+                          {
+                              #pragma omp atomic
+                              ++support[uv];
+                              #pragma omp atomic
+                              ++support[uw];
+                              #pragma omp atomic
+                              ++support[vw];
+                          });
+             parallel_edge_loop
+                 (graph,
+                  [&](const auto& e)
+                  {
+                      auto s = oa.slot(source(e, graph), target(e, graph));
+                      eprop[e] = (s == oriented_adjacency::null_slot) ?
+                          0 : support[s];
+                  });
+         },
+         writable_edge_scalar_properties())(prop);
+}
+
+// all the triangles, as a flat array of vertex triples, each in increasing
+// order, sorted lexicographically so that the output does not depend on the
+// number of threads
+boost::python::object list_triangles(GraphInterface& g)
+{
+    vector<size_t> flat;
+    run_action<graph_tool::detail::never_directed>()
+        (g,
+         [&](auto& graph)
+         {
+             oriented_adjacency oa(graph);
+             size_t nthreads = 1;
+#ifdef _OPENMP
+             nthreads = omp_get_max_threads();
+#endif
+             vector<vector<std::array<size_t, 3>>> ttris(nthreads);
+             oa.triangles([&](auto u, auto v, auto w, auto, auto, auto)
+                          {
+                              size_t tid = 0;
+#ifdef _OPENMP
+                              tid = omp_get_thread_num();
+#endif
+                              std::array<size_t, 3> t = {u, v, w};
+                              std::sort(t.begin(), t.end());
+                              ttris[tid].push_back(t);
+                          });
+             vector<std::array<size_t, 3>> tris;
+             for (auto& ts : ttris)
+             {
+                 tris.insert(tris.end(), ts.begin(), ts.end());
+                 vector<std::array<size_t, 3>>().swap(ts);
+             }
+             std::sort(tris.begin(), tris.end());
+             flat.reserve(3 * tris.size());
+             for (auto& t : tris)
+                 flat.insert(flat.end(), t.begin(), t.end());
+         })();
+    return wrap_vector_owned(flat);
+}
+
+// returns the graphlet orbit counts of every vertex, as a flat array with
+// num_orbits entries per vertex
+boost::python::object graphlet_orbits(GraphInterface& g)
+{
+    vector<int64_t> flat;
+    run_action<graph_tool::detail::never_directed>()
+        (g,
+         [&](auto& graph)
+         {
+             vector<std::array<int64_t, num_orbits>> orbits;
+             get_orbits(graph, orbits);
+             flat.reserve(num_orbits * orbits.size());
+             for (auto& o : orbits)
+                 flat.insert(flat.end(), o.begin(), o.end());
+         })();
+    return wrap_vector_owned(flat);
+}
+
+// estimates the global clustering coefficient by wedge sampling, and returns
+// the number of closed wedges and of samples
+boost::python::tuple sampled_global_clustering(GraphInterface& g, size_t n,
+                                               double error, double z,
+                                               rng_t& rng)
+{
+    std::pair<size_t, size_t> ret;
+    run_action<graph_tool::detail::never_directed>()
+        (g,
+         [&](auto& graph)
+         {
+             ret = sample_global_clustering(graph, n, error, z, rng);
+         })();
+    return boost::python::make_tuple(ret.first, ret.second);
+}
+
+// estimates the average local clustering of each degree by wedge sampling,
+// and returns the degrees, the number of closed wedges and of samples
+boost::python::tuple sampled_degree_clustering(GraphInterface& g, size_t n,
+                                               double error, double z,
+                                               rng_t& rng)
+{
+    vector<size_t> ks, closed, ns;
+    run_action<graph_tool::detail::never_directed>()
+        (g,
+         [&](auto& graph)
+         {
+             sample_degree_clustering(graph, n, error, z, ks, closed, ns,
+                                      rng);
+         })();
+    return boost::python::make_tuple(wrap_vector_owned(ks),
+                                     wrap_vector_owned(closed),
+                                     wrap_vector_owned(ns));
+}
+
 using namespace boost::python;
 
 void extended_clustering(GraphInterface& g, boost::python::list props);
+void do_ktruss_decomposition(GraphInterface& gi, boost::any prop);
+void export_triest();
 void get_motifs(GraphInterface& g, size_t k, boost::python::list subgraph_list,
                 boost::python::list hist, boost::python::list pvmaps, bool collect_vmaps,
                 boost::python::list p, bool comp_iso, bool fill_list, rng_t& rng);
@@ -92,6 +220,13 @@ BOOST_PYTHON_MODULE(libgraph_tool_clustering)
     docstring_options dopt(true, false);
     def("global_clustering", &global_clustering);
     def("local_clustering", &local_clustering);
+    def("edge_triangles", &edge_triangles);
+    def("list_triangles", &list_triangles);
+    def("graphlet_orbits", &graphlet_orbits);
+    def("sampled_global_clustering", &sampled_global_clustering);
+    def("sampled_degree_clustering", &sampled_degree_clustering);
     def("extended_clustering", &extended_clustering);
+    def("ktruss_decomposition", &do_ktruss_decomposition);
     def("get_motifs", &get_motifs);
+    export_triest();
 }
@@ -21,7 +21,10 @@
 #include "config.h"
 
 #include "hash_map_wrap.hh"
+#include "graph_intersect.hh"
+#include "graph_triangles.hh"
 #include <boost/mpl/if.hpp>
+#include <random>
 
 #ifdef _OPENMP
 #include "omp.h"
@@ -43,6 +46,37 @@ namespace graph_tool
 using namespace boost;
 using namespace std;
 
+// calculates the number of triangles to which v belongs in an unweighted
+// graph, by intersecting the sorted neighborhoods of v and of each of its
+// neighbors
+template <class Graph, class Mark>
+auto get_triangles_sorted(typename graph_traits<Graph>::vertex_descriptor v,
+                          Mark& mark, const Graph& g)
+{
+    auto& ns = mark.sorted.ns;
+    auto& count = mark.sorted.count;
+    bool vrep = get_sorted_neighbors(v, g, v, ns[0], count[0]);
+
+    size_t triangles = 0, k = 0;
+    for (size_t i = 0; i < ns[0].size(); ++i)
+    {
+        auto n = ns[0][i];
+        bool nrep = get_sorted_neighbors(n, g, n, ns[1], count[1]);
+        size_t t = 0;
+        if (nrep)
+            intersect_apply(ns[0].data(), ns[0].size(), ns[1].data(),
+                            ns[1].size(),
+                            [&](auto, auto j) { t += count[1][j]; });
+        else
+            t = intersect_count(ns[0].data(), ns[0].size(), ns[1].data(),
+                                ns[1].size());
+        size_t m = vrep ? count[0][i] : 1;
+        triangles += t * m;
+        k += m;
+    }
+    return make_pair(triangles, k);
+}
+
 // calculates the number of triangles to which v belongs
 template <class Graph, class EWeight, class VProp>
 auto get_triangles(typename graph_traits<Graph>::vertex_descriptor v,
@@ -51,6 +85,24 @@ auto get_triangles(typename graph_traits<Graph>::vertex_descriptor v,
     typedef typename property_traits<EWeight>::value_type val_t;
     val_t triangles = 0, k = 0;
 
+    auto ret = [&]()
+        {
+            if (graph_tool::is_directed(g))
+                return make_pair(val_t(triangles), val_t((k * (k - 1))));
+            else
+                return make_pair(val_t(triangles / 2),
+                                 val_t((k * (k - 1)) / 2));
+        };
+
+    if constexpr (is_unity_property<EWeight>::value)
+    {
+        if (has_sorted_adjacency(g))
+        {
+            std::tie(triangles, k) = get_triangles_sorted(v, mark, g);
+            return ret();
+        }
+    }
+
     for (auto e : out_edges_range(v, g))
     {
         auto n = target(e, g);
@@ -82,10 +134,7 @@ auto get_triangles(typename graph_traits<Graph>::vertex_descriptor v,
     for (auto n : adjacent_vertices_range(v, g))
         mark[n] = 0;
 
-    if (graph_tool::is_directed(g))
-        return make_pair(val_t(triangles), val_t((k * (k - 1))));
-    else
-        return make_pair(val_t(triangles / 2), val_t((k * (k - 1)) / 2));
+    return ret();
 }
 
 
@@ -95,12 +144,28 @@ auto get_global_clustering(const Graph& g, EWeight eweight)
 {
     typedef typename property_traits<EWeight>::value_type val_t;
     val_t triangles = 0, n = 0;
-    vector<val_t> mask(num_vertices(g), 0);
     vector<std::pair<val_t, val_t>> ret(num_vertices(g));
 
-    #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
-        firstprivate(mask) reduction(+:triangles, n)
-    parallel_vertex_loop_no_spawn
+    if constexpr (is_unity_property<EWeight>::value &&
+                  !is_directed_::apply<Graph>::type::value)
+    {
+        get_all_triangles(g, ret);
+        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
+            reduction(+:triangles, n)
+        parallel_vertex_loop_no_spawn
+            (g,
+             [&](auto v)
+             {
+                 triangles += ret[v].first;
+                 n += ret[v].second;
+             });
+    }
+    else
+    {
+        neighbor_mark<val_t> mask(num_vertices(g), 0);
+        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
+            firstprivate(mask) reduction(+:triangles, n)
+        parallel_vertex_loop_no_spawn
             (g,
              [&](auto v)
              {
@@ -109,6 +174,7 @@ auto get_global_clustering(const Graph& g, EWeight eweight)
                  n += temp.second;
                  ret[v] = temp;
              });
+    }
     double c = double(triangles) / n;
 
     // "jackknife" variance
@@ -134,7 +200,24 @@ void set_clustering_to_property(const Graph& g, EWeight eweight,
                                 ClustMap clust_map)
 {
     typedef typename property_traits<EWeight>::value_type val_t;
-    vector<val_t> mask(num_vertices(g), false);
+
+    if constexpr (is_unity_property<EWeight>::value &&
+                  !is_directed_::apply<Graph>::type::value)
+    {
+        vector<std::pair<val_t, val_t>> ret;
+        get_all_triangles(g, ret);
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 auto& triangles = ret[v];
+                 clust_map[v] = (triangles.second > 0) ?
+                     double(triangles.first)/triangles.second : 0.0;
+             });
+        return;
+    }
+
+    neighbor_mark<val_t> mask(num_vertices(g), 0);
 
     #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
         firstprivate(mask)
@@ -150,6 +233,210 @@ void set_clustering_to_property(const Graph& g, EWeight eweight,
          });
 }
 
+// Wedge sampling
+// ==============
+//
+// The global clustering coefficient is the fraction of closed wedges (paths
+// of length two), and the average local clustering of the vertices with degree
+// k is the probability that a wedge chosen uniformly at random among those
+// centered at a vertex of degree k, itself chosen uniformly, is closed. Both
+// can be estimated by sampling wedges independently (Seshadhri et al. 2014),
+// with an error that only depends on the number of samples, and not on the size
+// of the graph. For simple graphs the estimates are unbiased; for graphs with
+// parallel edges each pair of edges incident on the center is a wedge, which
+// is closed if their other endpoints are distinct and adjacent.
+//
+// The samples are drawn in batches with independent RNG streams, so that the
+// result does not depend on the number of threads, and the sampling stops when
+// the half-width of the Wilson score interval falls below the given error (if
+// it is positive), or after max_n samples.
+
+// half-width of the Wilson score interval for x successes in n trials
+inline double wilson_error(size_t x, size_t n, double z)
+{
+    if (n == 0)
+        return numeric_limits<double>::infinity();
+    double p = double(x) / n;
+    double z2 = z * z;
+    return z * sqrt(p * (1 - p) / n + z2 / (4. * n * n)) / (1 + z2 / n);
+}
+
+// Draws a wedge uniformly at random among those centered at v, i.e. a pair of
+// its incident edges. Returns 0 if it contains a self-loop, 1 if it is open, and
+// 2 if it is closed.
+template <class Graph, class RNG>
+int sample_wedge(typename graph_traits<Graph>::vertex_descriptor v, size_t k,
+                 const Graph& g, RNG& rng)
+{
+    std::uniform_int_distribution<size_t> sample_i(0, k - 1);
+    std::uniform_int_distribution<size_t> sample_j(0, k - 2);
+    auto i = sample_i(rng);
+    auto j = sample_j(rng);
+    if (j >= i)
+        ++j;
+    auto es = out_edges(v, g);
+    auto a = target(*std::next(es.first, i), g);
+    auto b = target(*std::next(es.first, j), g);
+    if (a == v || b == v)
+        return 0;
+    if (a == b)
+        return 1;
+    if (out_degree(a, g) > out_degree(b, g))
+        std::swap(a, b);
+    return is_adjacent(a, b, g) ? 2 : 1;
+}
+
+// Calls sample(rng) in batches, until the Wilson error is smaller than error,
+// or max_n valid samples have been drawn; sample(rng) returns as in
+// sample_wedge(). If parallel == true, several batches are drawn in parallel
+// between the checks of the error, each with its own stream. Returns the
+// number of closed wedges and of samples.
+template <class Sample, class RNG>
+std::pair<size_t, size_t>
+sample_wedges(Sample&& sample, size_t max_n, double error, double z,
+              bool parallel, RNG& rng)
+{
+    constexpr size_t batch = 4096;
+    size_t nbatches = parallel ? 64 : 1;  // per round
+    size_t closed = 0, n = 0, b = 0;
+
+    // self-loops are rejected, with a bound on the number of attempts
+    auto run_batch = [&](size_t bn, auto& r, size_t& bclosed, size_t& valid)
+        {
+            for (size_t t = 0; valid < bn && t < 64 * bn; ++t)
+            {
+                int ret = sample(r);
+                if (ret == 0)
+                    continue;
+                ++valid;
+                bclosed += (ret == 2);
+            }
+        };
+
+    while (n < max_n && (error <= 0 || wilson_error(closed, n, z) > error))
+    {
+        size_t m = std::min(batch * nbatches, max_n - n);
+        size_t nb = (m + batch - 1) / batch;
+        size_t rclosed = 0, rn = 0;
+        if (parallel)
+        {
+            #pragma omp parallel for schedule(dynamic, 1) \
+                reduction(+:rclosed, rn)
+            for (size_t i = 0; i < nb; ++i)
+            {
+                RNG r(rng);
+                r.set_stream(b + i + 1);
+                size_t bn = 0;
+                run_batch(std::min(batch, m - i * batch), r, rclosed, bn);
+                rn += bn;
+            }
+            b += nb;
+        }
+        else
+        {
+            for (size_t i = 0; i < nb; ++i)
+            {
+                size_t bn = 0;
+                run_batch(std::min(batch, m - i * batch), rng, rclosed, bn);
+                rn += bn;
+            }
+        }
+        if (rn == 0)
+            break;
+        closed += rclosed;
+        n += rn;
+    }
+    if (parallel)
+        rng.discard(1);
+    return {closed, n};
+}
+
+// estimates the global clustering coefficient by wedge sampling, returning the
+// number of closed wedges and of samples
+template <class Graph, class RNG>
+std::pair<size_t, size_t>
+sample_global_clustering(const Graph& g, size_t max_n, double error, double z,
+                         RNG& rng)
+{
+    // cumulative number of (ordered) pairs of incident edges
+    vector<size_t> vs;
+    vector<double> cum;
+    double W = 0;
+    for (auto v : vertices_range(g))
+    {
+        size_t k = out_degree(v, g);
+        if (k < 2)
+            continue;
+        W += double(k) * (k - 1);
+        vs.push_back(v);
+        cum.push_back(W);
+    }
+    if (vs.empty())
+        return {0, 0};
+
+    return sample_wedges
+        ([&](auto& r)
+         {
+             std::uniform_real_distribution<double> sample_w(0, W);
+             auto iter = std::upper_bound(cum.begin(), cum.end(),
+                                          sample_w(r));
+             if (iter == cum.end())
+                 --iter;
+             auto v = vs[iter - cum.begin()];
+             return sample_wedge(v, out_degree(v, g), g, r);
+         }, max_n, error, z, true, rng);
+}
+
+// estimates the average local clustering of the vertices of each degree by
+// wedge sampling, returning the degrees, the number of closed wedges and of
+// samples for each one; the degrees are sampled in parallel
+template <class Graph, class RNG>
+void sample_degree_clustering(const Graph& g, size_t max_n, double error,
+                              double z, vector<size_t>& ks,
+                              vector<size_t>& closed, vector<size_t>& ns,
+                              RNG& rng)
+{
+    vector<std::pair<size_t, size_t>> kvs;
+    for (auto v : vertices_range(g))
+    {
+        size_t k = out_degree(v, g);
+        if (k >= 2)
+            kvs.emplace_back(k, v);
+    }
+    std::sort(kvs.begin(), kvs.end());
+
+    vector<size_t> begin;
+    for (size_t i = 0; i < kvs.size(); ++i)
+    {
+        if (i == 0 || kvs[i].first != kvs[i - 1].first)
+        {
+            begin.push_back(i);
+            ks.push_back(kvs[i].first);
+        }
+    }
+    begin.push_back(kvs.size());
+
+    size_t K = ks.size();
+    closed.resize(K);
+    ns.resize(K);
+
+    #pragma omp parallel for schedule(dynamic, 1) if (K > 1)
+    for (size_t i = 0; i < K; ++i)
+    {
+        auto k = ks[i];
+        std::uniform_int_distribution<size_t> sample_v(begin[i],
+                                                       begin[i + 1] - 1);
+        RNG r(rng);
+        r.set_stream(i + 1);
+        std::tie(closed[i], ns[i]) = sample_wedges
+            ([&](auto& r)
+             {
+                 return sample_wedge(kvs[sample_v(r)].second, k, g, r);
+             }, max_n, error, z, false, r);
+    }
+    rng.discard(1);
+}
+
 } //graph-tool namespace
 
 #endif // GRAPH_CLUSTERING_HH
@@ -101,8 +101,6 @@ void extended_clustering(GraphInterface& g, boost::python::list props)
          {
              return get_extended_clustering()
                  (std::forward<decltype(graph)>(graph),
-                  any_cast<GraphInterface::vertex_index_map_t>(
-                      g.get_vertex_index()),
                   std::forward<decltype(a2)>(a2));
          },
          properties_vector())(vprop);
@@ -20,9 +20,8 @@
 #ifndef GRAPH_EXTENDED_CLUSTERING_HH
 #define GRAPH_EXTENDED_CLUSTERING_HH
 
-#include "hash_map_wrap.hh"
-
-#include <boost/graph/breadth_first_search.hpp>
+#include <vector>
+#include <limits>
 
 namespace graph_tool
 {
@@ -30,166 +29,187 @@ namespace graph_tool
 using namespace std;
 using namespace boost;
 
-// graph filter to remove a single vertex
-
-template <class Vertex>
-struct single_vertex_filter
-{
-    single_vertex_filter() {}
-    single_vertex_filter(Vertex v):_v(v) {}
-
-    bool operator()(Vertex v) const { return v != _v; }
-
-    Vertex _v;
-};
-
-class bfs_stop_exception {};
-
-// this will abort the BFS search when no longer useful
-
-template <class TargetSet, class DistanceMap>
-struct bfs_max_depth_watcher
-{
-    typedef on_tree_edge event_filter;
-
-    bfs_max_depth_watcher(TargetSet& targets, size_t max_depth,
-                          DistanceMap distance)
-        : _targets(targets), _max_depth(max_depth), _distance(distance) {}
-
-    template <class Graph>
-    void operator()(typename graph_traits<Graph>::edge_descriptor e,
-                    const Graph& g)
-    {
-        typename graph_traits<Graph>::vertex_descriptor v = target(e,g);
-        if (get(_distance, v) > _max_depth)
-            throw bfs_stop_exception();
-        if (_targets.find(v) != _targets.end())
-            _targets.erase(v);
-        if (_targets.empty())
-            throw bfs_stop_exception();
-    }
-
-    TargetSet& _targets;
-    size_t _max_depth;
-    DistanceMap _distance;
-};
-
 // abstract target collecting so algorithm works for bidirectional and
 // undirected graphs
 
-template<class Graph, class Vertex, class Targets, class DirectedCategory>
-void collect_targets(Vertex v, Graph& g, Targets& t, DirectedCategory)
+template<class Graph, class Vertex, class Targets, class Mark,
+         class DirectedCategory>
+void collect_targets(Vertex v, Graph& g, Targets& t, Mark& mark,
+                     DirectedCategory)
 {
     for (auto u : in_neighbors_range(v, g))
     {
         if (u == v) // no self-loops
             continue;
-        if (t.find(u) != t.end()) // avoid parallel edges
+        if (mark[u]) // avoid parallel edges
             continue;
-        t.insert(u);
+        mark[u] = true;
+        t.push_back(u);
     }
 }
 
-template<class Graph, class Vertex, class Targets>
-void collect_targets(Vertex v, Graph& g, Targets& t, undirected_tag)
+template<class Graph, class Vertex, class Targets, class Mark>
+void collect_targets(Vertex v, Graph& g, Targets& t, Mark& mark,
+                     undirected_tag)
 {
     for (auto u : out_neighbors_range(v, g))
     {
         if (u == v) // no self-loops
             continue;
-        if (t.find(u) != t.end()) // avoid parallel edges
+        if (mark[u]) // avoid parallel edges
             continue;
-        t.insert(u);
+        mark[u] = true;
+        t.push_back(u);
     }
 }
 
 // get_extended_clustering
+//
+// For every vertex v, a breadth-first search is started from each of its
+// (out-)neighbors u, in the graph without v, which finds the distances from u
+// to all the other (in-)neighbors of v at once. The search proceeds level by
+// level, and stops at depth max_depth, or as soon as all the targets are
+// found. The last level is not expanded if the targets have fewer
+// (in-)neighbors than the vertices of the previous level have
+// (out-)neighbors; instead, the targets adjacent to the previous level are
+// found by scanning their own neighborhoods. The distances and the target
+// marks are kept in arrays owned by each thread, and only the entries that
+// were touched are reset afterwards, so that the cost of each search is
+// proportional to the size of the explored region.
 
 struct get_extended_clustering
 {
-    template <class Graph, class IndexMap, class ClusteringMap>
-    void operator()(const Graph& g, IndexMap vertex_index,
-                    vector<ClusteringMap> cmaps) const
+    template <class Graph, class ClusteringMap>
+    void operator()(const Graph& g, vector<ClusteringMap> cmaps) const
     {
         typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
-
-        parallel_vertex_loop
-            (g,
-             [&](auto v)
-             {
-                 // We must disconsider paths through the original vertex
-                 typedef single_vertex_filter<vertex_t> filter_t;
-                 typedef filt_graph<Graph, keep_all, filter_t> fg_t;
-                 fg_t fg(g, keep_all(), filter_t(v));
-
-                 typedef DescriptorHash<IndexMap> hasher_t;
-                 typedef gt_hash_set<vertex_t,hasher_t> neighbor_set_t;
-                 neighbor_set_t neighbors(0, hasher_t(vertex_index));
-                 neighbor_set_t targets(0, hasher_t(vertex_index));
-
-                 // collect targets, neighbors and calculate normalization factor
-                 collect_targets(v, g, targets,
-                                 typename graph_traits<Graph>::directed_category());
-                 size_t k_in = targets.size(), k_out, k_inter=0, z;
-                 for (auto u : adjacent_vertices_range(v, g))
+        constexpr size_t null = numeric_limits<size_t>::max();
+
+        size_t N = num_vertices(g);
+        size_t max_depth = cmaps.size();
+
+        auto in_range = [&](auto t)
+            {
+                if constexpr (is_directed_::apply<Graph>::type::value)
+                    return in_neighbors_range(t, g);
+                else
+                    return out_neighbors_range(t, g);
+            };
+
+        auto in_deg = [&](auto t)
+            {
+                if constexpr (is_directed_::apply<Graph>::type::value)
+                    return in_degree(t, g);
+                else
+                    return out_degree(t, g);
+            };
+
+        #pragma omp parallel if (N > OPENMP_MIN_THRESH)
+        {
+            vector<size_t> dist(N, null);
+            vector<uint8_t> is_target(N), is_neighbor(N);
+            vector<vertex_t> targets, neighbors, visited, frontier, next;
+
+            parallel_vertex_loop_no_spawn
+                (g,
+                 [&](auto v)
                  {
-                     if (u == v) // no self-loops
-                         continue;
-                     if (neighbors.find(u) != neighbors.end()) // avoid parallel
-                         continue;                               // edges
+                     // collect targets, neighbors and calculate normalization
+                     // factor
+                     targets.clear();
+                     neighbors.clear();
+                     collect_targets(v, g, targets, is_target,
+                                     typename graph_traits<Graph>::directed_category());
+                     size_t k_in = targets.size(), k_out, k_inter=0, z;
+                     for (auto u : adjacent_vertices_range(v, g))
+                     {
+                         if (u == v) // no self-loops
+                             continue;
+                         if (is_neighbor[u]) // avoid parallel edges
+                             continue;
+                         is_neighbor[u] = true;
+                         neighbors.push_back(u);
+                         if (is_target[u])
+                             ++k_inter;
+                     }
 
-                     neighbors.insert(u);
-                     if (targets.find(u) != targets.end())
-                         ++k_inter;
-                 }
+                     k_out = neighbors.size();
+                     z = (k_in * k_out) - k_inter;
 
-                 k_out = neighbors.size();
-                 z = (k_in * k_out) - k_inter;
+                     size_t t_deg = 0;
+                     for (auto t : targets)
+                         t_deg += in_deg(t);
 
-                 // And now we setup and start the BFS bonanza
-                 for (auto u : neighbors)
-                 {
-                     typedef gt_hash_map<vertex_t,size_t,
-                                         DescriptorHash<IndexMap> > dmap_t;
-                     dmap_t dmap(0, DescriptorHash<IndexMap>(vertex_index));
-                     InitializedPropertyMap<dmap_t>
-                         distance_map(dmap, numeric_limits<size_t>::max());
-
-                     typedef gt_hash_map<vertex_t,default_color_type,
-                                         DescriptorHash<IndexMap> > cmap_t;
-                     cmap_t cmap(0, DescriptorHash<IndexMap>(vertex_index));
-                     InitializedPropertyMap<cmap_t>
-                         color_map(cmap, color_traits<default_color_type>::white());
-
-                     try
+                     for (auto u : neighbors)
                      {
-                         distance_map[u] = 0;
-                         neighbor_set_t specific_targets = targets;
-                         specific_targets.erase(u);
-                         bfs_max_depth_watcher<neighbor_set_t,
-                                               InitializedPropertyMap<dmap_t> >
-                             watcher(specific_targets, cmaps.size(),
-                                     distance_map);
-                         breadth_first_visit(fg, u,
-                                             visitor
-                                             (make_bfs_visitor
-                                              (make_pair(record_distances
-                                                         (distance_map,
-                                                          boost::on_tree_edge()),
-                                                         watcher))).
-                                             color_map(color_map));
+                         // paths through v are not considered
+                         dist[v] = null - 1;
+                         dist[u] = 0;
+                         visited.push_back(v);
+                         visited.push_back(u);
+                         frontier.clear();
+                         frontier.push_back(u);
+                         size_t f_deg = out_degree(u, g);
+
+                         size_t remaining = k_in - is_target[u];
+                         for (size_t d = 1;
+                              d <= max_depth && remaining > 0 &&
+                                  !frontier.empty();
+                              ++d)
+                         {
+                             if (d == max_depth && t_deg < f_deg)
+                             {
+                                 for (auto t : targets)
+                                 {
+                                     if (dist[t] != null)
+                                         continue;
+                                     for (auto w : in_range(t))
+                                     {
+                                         if (dist[w] == d - 1)
+                                         {
+                                             cmaps[d - 1][v] += 1. / z;
+                                             break;
+                                         }
+                                     }
+                                 }
+                                 break;
+                             }
+
+                             next.clear();
+                             f_deg = 0;
+                             for (auto w : frontier)
+                             {
+                                 for (auto x : out_neighbors_range(w, g))
+                                 {
+                                     if (dist[x] != null)
+                                         continue;
+                                     dist[x] = d;
+                                     visited.push_back(x);
+                                     next.push_back(x);
+                                     f_deg += out_degree(x, g);
+                                     if (is_target[x])
+                                     {
+                                         cmaps[d - 1][v] += 1. / z;
+                                         --remaining;
+                                     }
+                                 }
+                                 if (remaining == 0)
+                                     break;
+                             }
+                             frontier.swap(next);
+                         }
+
+                         for (auto x : visited)
+                             dist[x] = null;
+                         visited.clear();
                      }
-                     catch (bfs_stop_exception) {}
 
                      for (auto t : targets)
-                     {
-                         if (t == u) // no self-loops
-                             continue;
-                         if (distance_map[t] <= cmaps.size())
-                             cmaps[distance_map[t]-1][v] += 1. / z;
-                     }
-                 }
-             });
+                         is_target[t] = false;
+                     for (auto u : neighbors)
+                         is_neighbor[u] = false;
+                 });
+        }
     }
 };
 
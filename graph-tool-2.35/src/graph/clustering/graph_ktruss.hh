@@ -0,0 +1,242 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// you should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_KTRUSS_HH
+#define GRAPH_KTRUSS_HH
+
+#include <vector>
+#include <limits>
+
+#include "graph_triangles.hh"
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// Parallel k-truss decomposition of an undirected graph, following the PKT
+// algorithm of Kabir and Madduri. The support of each edge, i.e. the number of
+// triangles to which it belongs, is obtained with oriented_adjacency, and the
+// edges are then peeled level by level, as in parallel_kcore_decomposition():
+// at level l, the remaining edges with support l are processed concurrently,
+// and the support of the other two edges of each of their triangles that is
+// still present is decremented atomically. An edge whose support drops to l is
+// collected in a thread-local buffer, and processed in the next sub-round of
+// the same level. If two edges of a triangle are peeled in the same sub-round,
+// only the one with the smallest slot decrements the third one.
+//
+// The triangles of an edge are found by intersecting the (full) neighborhoods
+// of its endpoints, which are stored together with the slots of the
+// corresponding edges, and from which the peeled edges are periodically
+// removed. Edges peeled at level zero have no triangles left, and are skipped
+// altogether. The truss number of an edge is l + 2, where l is the level at
+// which it is peeled. Parallel edges share the same value, and self-loops,
+// which belong to no triangle, get the value 2.
+template <class Graph, class TrussMap>
+void ktruss_decomposition(Graph& g, TrussMap truss)
+{
+    size_t N = num_vertices(g);
+    oriented_adjacency oa(g);
+    size_t E = oa.num_slots();
+
+    // full neighborhoods, with the slots
+    vector<size_t> pos, ns, slots;
+    oa.get_neighborhoods(pos, ns, slots);
+    vector<size_t> src(E);
+    #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+    for (size_t u = 0; u < N; ++u)
+    {
+        for (size_t s = oa.begin(u); s < oa.end(u); ++s)
+            src[s] = u;
+    }
+
+    // the neighborhoods are in the ranges [pos[v], last[v]), from which the
+    // peeled edges are removed from time to time
+    vector<size_t> last(pos.begin() + 1, pos.end());
+    size_t E_n = E;
+
+    // calls f(s1, s2) for the other two edges of every triangle of slot s
+    auto triangles = [&](size_t s, auto&& f)
+        {
+            auto u = src[s];
+            auto v = oa.target(s);
+            intersect_apply(ns.data() + pos[u], last[u] - pos[u],
+                            ns.data() + pos[v], last[v] - pos[v],
+                            [&](auto i, auto j)
+                            {
+                                f(slots[pos[u] + i], slots[pos[v] + j]);
+                            });
+        };
+
+    vector<size_t> sup(E);
+    oa.triangles([&](auto, auto, auto, auto uv, auto uw, auto vw)
+                 {
+                     #pragma omp atomic
+                     ++sup[uv];
+                     #pragma omp atomic
+                     ++sup[uw];
+                     #pragma omp atomic
+                     ++sup[vw];
+                 });
+
+    // 0: remaining, 1: being peeled, 2: peeled
+    vector<uint8_t> state(E);
+    vector<size_t> level(E);
+    vector<size_t> remaining(E), next, curr;
+    for (size_t s = 0; s < E; ++s)
+        remaining[s] = s;
+
+    size_t l = 0;
+    while (!remaining.empty())
+    {
+        // drop the edges peeled in the previous level, and find the next
+        // non-empty level
+        size_t l_min = numeric_limits<size_t>::max();
+        next.clear();
+        #pragma omp parallel if (remaining.size() > OPENMP_MIN_THRESH) \
+            reduction(min:l_min)
+        {
+            vector<size_t> lnext;
+            parallel_loop_no_spawn
+                (remaining,
+                 [&](size_t, auto s)
+                 {
+                     if (state[s] == 2)
+                         return;
+                     lnext.push_back(s);
+                     l_min = std::min(l_min, sup[s]);
+                 });
+            #pragma omp critical (ktruss_compact)
+            next.insert(next.end(), lnext.begin(), lnext.end());
+        }
+        remaining.swap(next);
+        if (remaining.empty())
+            break;
+        l = l_min;
+
+        // remove the peeled edges from the neighborhoods, once they amount
+        // to a large fraction of them
+        if (4 * remaining.size() < 3 * E_n)
+        {
+            #pragma omp parallel for schedule(runtime) \
+                if (N > OPENMP_MIN_THRESH)
+            for (size_t u = 0; u < N; ++u)
+            {
+                auto j = pos[u];
+                for (size_t i = pos[u]; i < last[u]; ++i)
+                {
+                    if (state[slots[i]] == 2)
+                        continue;
+                    ns[j] = ns[i];
+                    slots[j++] = slots[i];
+                }
+                last[u] = j;
+            }
+            E_n = remaining.size();
+        }
+
+        curr.clear();
+        for (auto s : remaining)
+        {
+            if (sup[s] == l)
+                curr.push_back(s);
+        }
+
+        while (!curr.empty())
+        {
+            for (auto s : curr)
+                state[s] = 1;
+
+            next.clear();
+            #pragma omp parallel if (curr.size() > OPENMP_MIN_THRESH)
+            {
+                vector<size_t> lnext;
+                auto decrement = [&](size_t s)
+                    {
+                        if (sup[s] <= l)
+                            return;
+                        size_t k;
+                        #pragma omp atomic capture
+                        k = sup[s]--;
+                        if (k == l + 1)
+                        {
+                            lnext.push_back(s);
+                        }
+                        else if (k <= l)
+                        {
+                            #pragma omp atomic
+                            sup[s]++;
+                        }
+                    };
+
+                #pragma omp for schedule(dynamic, 16) nowait
+                for (size_t i = 0; i < curr.size(); ++i)
+                {
+                    auto s = curr[i];
+                    level[s] = l;
+                    // the support is an upper bound on the number of
+                    // triangles that are still present
+                    if (l == 0)
+                        continue;
+                    triangles(s,
+                              [&](auto s1, auto s2)
+                              {
+                                  if (state[s1] == 2 || state[s2] == 2)
+                                      return;
+                                  if (state[s1] == 1 && state[s2] == 1)
+                                      return;
+                                  if (state[s1] == 1)
+                                  {
+                                      if (s < s1)
+                                          decrement(s2);
+                                  }
+                                  else if (state[s2] == 1)
+                                  {
+                                      if (s < s2)
+                                          decrement(s1);
+                                  }
+                                  else
+                                  {
+                                      decrement(s1);
+                                      decrement(s2);
+                                  }
+                              });
+                }
+
+                #pragma omp critical (ktruss_next)
+                next.insert(next.end(), lnext.begin(), lnext.end());
+            }
+
+            for (auto s : curr)
+                state[s] = 2;
+            curr.swap(next);
+        }
+    }
+
+    parallel_edge_loop
+        (g,
+         [&](const auto& e)
+         {
+             auto s = oa.slot(source(e, g), target(e, g));
+             truss[e] = (s == oriented_adjacency::null_slot) ?
+                 2 : level[s] + 2;
+         });
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_KTRUSS_HH
@@ -22,6 +22,7 @@
 #include <boost/functional/hash.hpp>
 #include <algorithm>
 #include <vector>
+#include <array>
 
 #include "random.hh"
 #include "hash_map_wrap.hh"
@@ -294,7 +295,166 @@ void get_sig(Graph& g, std::vector<size_t>& sig)
     sort(sig.begin(), sig.end());
 }
 
+// Canonical labeling of small subgraphs
+// =====================================
+//
+// Subgraphs with up to max_canon_k vertices are identified by a canonical
+// code, i.e. the smallest bit string obtained by concatenating the rows of
+// their adjacency matrices under any relabeling of the vertices, so that two
+// of them are isomorphic if, and only if, their codes are the same. Only the
+// relabelings which order the vertices according to an invariant, i.e. their
+// degrees and the sum of the degrees of their neighbors, need to be
+// considered. The code also includes the number of vertices, and fits in a
+// 64-bit integer.
+
+constexpr size_t max_canon_k = 7;
+typedef std::array<uint8_t, max_canon_k> motif_adj_t;
+
+// code of the adjacency matrix (with rows given as bit masks), with the
+// vertices relabeled such that p[i] becomes i
+inline uint64_t get_adj_code(size_t n, const motif_adj_t& adj,
+                             const motif_adj_t& p)
+{
+    uint64_t code = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            code <<= 1;
+            if ((adj[p[i]] >> p[j]) & 1)
+                code |= 1;
+        }
+    }
+    return code | (uint64_t(n) << (max_canon_k * max_canon_k));
+}
+
+// returns the canonical code of the adjacency matrix, and the corresponding
+// relabeling, where perm[i] is the vertex that becomes i
+inline uint64_t get_canonical_code(size_t n, const motif_adj_t& adj,
+                                   motif_adj_t& perm)
+{
+    std::array<size_t, max_canon_k> deg = {}, inv = {};
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            if ((adj[i] >> j) & 1)
+            {
+                deg[i] += max_canon_k + 1;
+                deg[j] += 1;
+            }
+        }
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        inv[i] = deg[i] << 32;
+        for (size_t j = 0; j < n; ++j)
+        {
+            if ((adj[i] >> j) & 1)
+                inv[i] += deg[j] << 16;
+            if ((adj[j] >> i) & 1)
+                inv[i] += deg[j];
+        }
+    }
+
+    motif_adj_t p;
+    for (size_t i = 0; i < n; ++i)
+        p[i] = i;
+    std::sort(p.begin(), p.begin() + n,
+              [&](auto u, auto v)
+              {
+                  return std::make_pair(inv[u], u) < std::make_pair(inv[v], v);
+              });
+
+    // the relabelings are enumerated by permuting the vertices with the same
+    // invariant, like an odometer
+    std::array<size_t, max_canon_k + 1> cls;
+    size_t ncls = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i == 0 || inv[p[i]] != inv[p[i - 1]])
+            cls[ncls++] = i;
+    }
+    cls[ncls] = n;
+
+    uint64_t code = std::numeric_limits<uint64_t>::max();
+    while (true)
+    {
+        auto c = get_adj_code(n, adj, p);
+        if (c < code)
+        {
+            code = c;
+            perm = p;
+        }
+        size_t i = 0;
+        for (; i < ncls; ++i)
+        {
+            if (std::next_permutation(p.begin() + cls[i],
+                                      p.begin() + cls[i + 1]))
+                break;
+        }
+        if (i == ncls)
+            break;
+    }
+    return code;
+}
+
+// adjacency matrix of the subgraph induced by the (sorted) vertex list, with
+// the same edges as make_subgraph(); returns false if it has parallel edges
+template <class Graph, class Vertex>
+bool get_motif_adj(const std::vector<Vertex>& vlist, Graph& g,
+                   motif_adj_t& adj)
+{
+    adj.fill(0);
+    for (size_t i = 0; i < vlist.size(); ++i)
+    {
+        auto ov = vlist[i];
+        for (auto e : out_edges_range(ov, g))
+        {
+            auto ot = target(e, g);
+            auto viter = lower_bound(vlist.begin(), vlist.end(), ot);
+            if (viter == vlist.end() || *viter != ot)
+                continue;
+            if (!graph_tool::is_directed(g) && !(ot < ov))
+                continue;
+            size_t j = viter - vlist.begin();
+            if ((adj[i] >> j) & 1)
+                return false;
+            adj[i] |= 1 << j;
+            if (!graph_tool::is_directed(g))
+                adj[j] |= 1 << i;
+        }
+    }
+    return true;
+}
+
+// builds the subgraph with the given code
+template <class GraphSG>
+void make_code_subgraph(uint64_t code, GraphSG& sub)
+{
+    size_t n = code >> (max_canon_k * max_canon_k);
+    for (size_t i = 0; i < n; ++i)
+        add_vertex(sub);
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            if (!graph_tool::is_directed(sub) && j <= i)
+                continue;
+            size_t b = (n - i - 1) * n + (n - j - 1);
+            if ((code >> b) & 1)
+                add_edge(vertex(i, sub), vertex(j, sub), sub);
+        }
+    }
+}
+
 // gets (or samples) all the subgraphs in graph g
+//
+// The subgraphs with at most max_canon_k vertices and without parallel edges
+// are classified by their canonical codes, which are cached in each thread for
+// every labeled adjacency matrix, and are counted in thread-local hash maps,
+// merged at the end. Only the remaining subgraphs need to be compared with the
+// known motifs of the same signature, inside a critical section.
 struct get_all_motifs
 {
     get_all_motifs(bool collect_vmaps, double p, bool comp_iso, bool fill_list,
@@ -312,12 +472,29 @@ struct get_all_motifs
                     std::vector<size_t>& hist, std::vector<std::vector<VMap> >& vmaps,
                     Sampler sampler) const
     {
+        typedef typename boost::graph_traits<Graph>::vertex_descriptor vertex_t;
+
+        // returns the code of the adjacency matrix, and the relabeling
+        // that yields it; if comp_iso == false, the labels are kept
+        auto get_code = [&](size_t n, const motif_adj_t& adj,
+                            motif_adj_t& perm)
+            {
+                if (comp_iso)
+                    return get_canonical_code(n, adj, perm);
+                for (size_t i = 0; i < max_canon_k; ++i)
+                    perm[i] = i;
+                return get_adj_code(n, adj, perm);
+            };
+
         // this hashes subgraphs according to their signature
         gt_hash_map<std::vector<size_t>,
                     std::vector<std::pair<size_t, d_graph_t> >,
                     std::hash<std::vector<size_t>>> sub_list;
         std::vector<size_t> sig; // current signature
 
+        // the codes of the known motifs, their positions and relabelings
+        gt_hash_map<uint64_t, std::pair<size_t, motif_adj_t>> code_list;
+
         for (size_t i = 0; i < subgraph_list.size(); ++i)
         {
             auto& sub = subgraph_list[i];
@@ -325,6 +502,25 @@ struct get_all_motifs
                 usub(sub);
             get_sig(usub, sig);
             sub_list[sig].emplace_back(i, sub);
+
+            size_t n = num_vertices(usub);
+            if (n > max_canon_k)
+                continue;
+            std::vector<size_t> vlist(n);
+            for (size_t j = 0; j < n; ++j)
+                vlist[j] = j;
+            motif_adj_t adj, perm;
+            if (!get_motif_adj(vlist, usub, adj))
+                continue;
+            size_t E = 0;
+            for (size_t j = 0; j < n; ++j)
+                E += __builtin_popcount(adj[j]);
+            if (!graph_tool::is_directed(usub))
+                E /= 2;
+            if (E != num_edges(usub)) // self-loops
+                continue;
+            auto code = get_code(n, adj, perm);
+            code_list.emplace(code, std::make_pair(i, perm));
         }
 
         // the subgraph count
@@ -355,94 +551,200 @@ struct get_all_motifs
             V.resize(n);
         }
 
+        // the counts of the subgraphs with codes, and their vertices in the
+        // order of the relabeling
+        gt_hash_map<uint64_t, size_t> code_hist;
+        gt_hash_map<uint64_t, std::vector<std::vector<vertex_t>>> code_vlists;
+
         size_t N = (p < 1) ? V.size() : num_vertices(g);
-        #pragma omp parallel for if (num_vertices(g) > OPENMP_MIN_THRESH) \
-            private(sig)
-        for (size_t i = 0; i < N; ++i)
+        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH)
         {
-            std::vector<std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> >
-                subgraphs;
-            typename boost::graph_traits<Graph>::vertex_descriptor v =
-                (p < 1) ? V[i] : vertex(i, g);
-            if (!is_valid_vertex(v, g))
-                continue;
-
-            typename wrap_undirected::apply<Graph>::type ug(g);
-            get_subgraphs(ug, v, k, subgraphs, sampler);
-
-            for (size_t j = 0; j < subgraphs.size(); ++j)
+            gt_hash_map<uint64_t, size_t> lhist;
+            gt_hash_map<uint64_t, std::vector<std::vector<vertex_t>>> lvlists;
+            gt_hash_map<uint64_t, std::pair<uint64_t, motif_adj_t>> cache;
+            std::vector<std::vector<vertex_t>> subgraphs;
+            std::vector<size_t> sig;
+
+            #pragma omp for schedule(runtime)
+            for (size_t i = 0; i < N; ++i)
             {
-                d_graph_t sub;
-                typename wrap_directed::apply<Graph,d_graph_t>::type
-                    usub(sub);
-                make_subgraph(subgraphs[j], g, usub);
-                get_sig(usub, sig);
+                vertex_t v = (p < 1) ? V[i] : vertex(i, g);
+                if (!is_valid_vertex(v, g))
+                    continue;
 
-                #pragma omp critical (gather)
+                subgraphs.clear();
+                typename wrap_undirected::apply<Graph>::type ug(g);
+                get_subgraphs(ug, v, k, subgraphs, sampler);
+
+                for (auto& vlist : subgraphs)
                 {
-                    bool skip = false;
-                    auto iter = sub_list.find(sig);
-                    if(iter == sub_list.end())
+                    size_t n = vlist.size();
+                    motif_adj_t adj;
+                    if (n <= max_canon_k && get_motif_adj(vlist, g, adj))
                     {
-                        if (!fill_list)
-                            skip = true; // avoid inserting an element in sub_list
-                        sub_list[sig].clear();
+                        uint64_t code;
+                        motif_adj_t perm;
+                        if (comp_iso)
+                        {
+                            for (size_t c = 0; c < max_canon_k; ++c)
+                                perm[c] = c;
+                            auto key = get_adj_code(n, adj, perm);
+                            auto iter = cache.find(key);
+                            if (iter == cache.end())
+                            {
+                                code = get_canonical_code(n, adj, perm);
+                                cache[key] = std::make_pair(code, perm);
+                            }
+                            else
+                            {
+                                std::tie(code, perm) = iter->second;
+                            }
+                        }
+                        else
+                        {
+                            code = get_code(n, adj, perm);
+                        }
+
+                        if (!fill_list && code_list.find(code) == code_list.end())
+                            continue;
+                        ++lhist[code];
+                        if (collect_vmaps)
+                        {
+                            auto& vls = lvlists[code];
+                            vls.emplace_back(n);
+                            for (size_t c = 0; c < n; ++c)
+                                vls.back()[c] = vlist[perm[c]];
+                        }
+                        continue;
                     }
 
-                    if (!skip)
+                    d_graph_t sub;
+                    typename wrap_directed::apply<Graph,d_graph_t>::type
+                        usub(sub);
+                    make_subgraph(vlist, g, usub);
+                    get_sig(usub, sig);
+
+                    #pragma omp critical (gather)
                     {
-                        bool found = false;
-                        size_t pos;
-                        auto sl = sub_list.find(sig);
-                        if (sl != sub_list.end())
+                        bool skip = false;
+                        auto iter = sub_list.find(sig);
+                        if(iter == sub_list.end())
+                        {
+                            if (!fill_list)
+                                skip = true; // avoid inserting an element in sub_list
+                            sub_list[sig].clear();
+                        }
+
+                        if (!skip)
                         {
-                            for (auto& mpos : sl->second)
+                            bool found = false;
+                            size_t pos;
+                            auto sl = sub_list.find(sig);
+                            if (sl != sub_list.end())
                             {
-                                d_graph_t& motif = mpos.second;
-                                typename wrap_directed::apply<Graph,d_graph_t>::type
-                                    umotif(motif);
-                                if (comp_iso)
+                                for (auto& mpos : sl->second)
                                 {
-                                    if (isomorphism(umotif, usub,
-                                                    vertex_index1_map(get(boost::vertex_index, umotif)).
-                                                    vertex_index2_map(get(boost::vertex_index, usub))))
-                                        found = true;
-                                }
-                                else
-                                {
-                                    if (graph_cmp(umotif, usub))
-                                        found = true;
-                                }
-                                if (found)
-                                {
-                                    pos = mpos.first;
-                                    hist[pos]++;
-                                    break;
+                                    d_graph_t& motif = mpos.second;
+                                    typename wrap_directed::apply<Graph,d_graph_t>::type
+                                        umotif(motif);
+                                    if (comp_iso)
+                                    {
+                                        if (isomorphism(umotif, usub,
+                                                        vertex_index1_map(get(boost::vertex_index, umotif)).
+                                                        vertex_index2_map(get(boost::vertex_index, usub))))
+                                            found = true;
+                                    }
+                                    else
+                                    {
+                                        if (graph_cmp(umotif, usub))
+                                            found = true;
+                                    }
+                                    if (found)
+                                    {
+                                        pos = mpos.first;
+                                        hist[pos]++;
+                                        break;
+                                    }
                                 }
                             }
-                        }
 
-                        if (found == false && fill_list)
-                        {
-                            subgraph_list.push_back(sub);
-                            sub_list[sig].emplace_back(subgraph_list.size() - 1,
-                                                       sub);
-                            hist.push_back(1);
-                            pos = hist.size() - 1;
-                            found = true;
-                        }
+                            if (found == false && fill_list)
+                            {
+                                subgraph_list.push_back(sub);
+                                sub_list[sig].emplace_back(subgraph_list.size() - 1,
+                                                           sub);
+                                hist.push_back(1);
+                                pos = hist.size() - 1;
+                                found = true;
+                            }
 
-                        if (found && collect_vmaps)
-                        {
-                            if (pos >= vmaps.size())
-                                vmaps.resize(pos + 1);
-                            vmaps[pos].push_back(VMap(get(boost::vertex_index,sub)));
-                            for (size_t vi = 0; vi < num_vertices(sub); ++vi)
-                                vmaps[pos].back()[vertex(vi, sub)] = subgraphs[j][vi];
+                            if (found && collect_vmaps)
+                            {
+                                if (pos >= vmaps.size())
+                                    vmaps.resize(pos + 1);
+                                vmaps[pos].push_back(VMap(get(boost::vertex_index,sub)));
+                                for (size_t vi = 0; vi < num_vertices(sub); ++vi)
+                                    vmaps[pos].back()[vertex(vi, sub)] = vlist[vi];
+                            }
                         }
                     }
                 }
             }
+
+            #pragma omp critical (gather)
+            {
+                for (auto& kv : lhist)
+                    code_hist[kv.first] += kv.second;
+                for (auto& kv : lvlists)
+                {
+                    auto& vls = code_vlists[kv.first];
+                    vls.insert(vls.end(),
+                               std::make_move_iterator(kv.second.begin()),
+                               std::make_move_iterator(kv.second.end()));
+                }
+            }
+        }
+
+        // the new motifs are appended in the order of their codes, so that
+        // the list does not depend on the scheduling of the threads
+        std::vector<uint64_t> codes;
+        for (auto& kv : code_hist)
+            codes.push_back(kv.first);
+        std::sort(codes.begin(), codes.end());
+        for (auto code : codes)
+        {
+            size_t pos;
+            motif_adj_t perm;
+            auto iter = code_list.find(code);
+            if (iter != code_list.end())
+            {
+                std::tie(pos, perm) = iter->second;
+            }
+            else
+            {
+                subgraph_list.emplace_back();
+                typename wrap_directed::apply<Graph,d_graph_t>::type
+                    usub(subgraph_list.back());
+                make_code_subgraph(code, usub);
+                hist.push_back(0);
+                pos = hist.size() - 1;
+                for (size_t c = 0; c < max_canon_k; ++c)
+                    perm[c] = c;
+            }
+            hist[pos] += code_hist[code];
+
+            if (collect_vmaps)
+            {
+                if (pos >= vmaps.size())
+                    vmaps.resize(pos + 1);
+                auto& sub = subgraph_list[pos];
+                for (auto& vl : code_vlists[code])
+                {
+                    vmaps[pos].push_back(VMap(get(boost::vertex_index, sub)));
+                    for (size_t c = 0; c < vl.size(); ++c)
+                        vmaps[pos].back()[vertex(perm[c], sub)] = vl[c];
+                }
+            }
         }
     }
 };
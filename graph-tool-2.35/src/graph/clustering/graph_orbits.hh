@@ -0,0 +1,227 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// you should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_ORBITS_HH
+#define GRAPH_ORBITS_HH
+
+#include <vector>
+#include <array>
+
+#include "graph_triangles.hh"
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// Graphlet orbit counts
+// =====================
+//
+// Counts, for every vertex, the number of induced connected subgraphs with two
+// to four vertices (graphlets) to which it belongs, separately for each of the
+// 15 automorphism orbits of their vertices (Przulj 2007):
+//
+//   0: edge
+//   1, 2: path of length two (end, center)
+//   3: triangle
+//   4, 5: path of length three (end, inner)
+//   6, 7: star with three leaves (leaf, center)
+//   8: cycle of length four
+//   9, 10, 11: triangle with a tail (tail end, triangle vertex of degree two,
+//              vertex of degree three)
+//   12, 13: cycle of length four with a chord (vertex of degree two, endpoint
+//           of the chord)
+//   14: complete graph of four vertices
+//
+// No subgraph is ever enumerated, except the cliques. Instead, as in ORCA
+// (Hocevar and Demsar 2014) and ESCAPE (Pinar et al. 2017), the number of
+// (not necessarily induced) copies of each graphlet in which a vertex occupies
+// each orbit is obtained from degrees, edge supports (the number of triangles
+// of each edge), and the counts of 4-cycles and 4-cliques, and the induced
+// counts are obtained by inverting the (triangular) linear relation between
+// both, given by the number of times each graphlet appears as a subgraph of
+// another on the same vertices.
+//
+// The triangles and 4-cliques are enumerated with oriented_adjacency, and the
+// 4-cycles following Chiba and Nishizeki: each cycle is found from its vertex
+// u of highest rank, by counting the paths of length two from u to every other
+// vertex w via vertices of lower rank, which takes O(a(G) E) time, where a(G)
+// is the arboricity of the graph. All the steps are done in parallel.
+//
+// The graph is taken to be undirected, self-loops are ignored, and parallel
+// edges are counted only once.
+
+constexpr size_t num_orbits = 15;
+
+template <class Graph>
+void get_orbits(const Graph& g, vector<std::array<int64_t, num_orbits>>& orbits)
+{
+    typedef int64_t val_t;
+    size_t N = num_vertices(g);
+    oriented_adjacency oa(g);
+
+    vector<size_t> pos, ns, slots;
+    oa.get_neighborhoods(pos, ns, slots);
+
+    auto deg = [&](size_t v) -> val_t { return pos[v + 1] - pos[v]; };
+
+    // edge supports
+    vector<val_t> sup(oa.num_slots());
+    oa.triangles([&](auto, auto, auto, auto uv, auto uw, auto vw)
+                 {
+                     #pragma omp atomic
+                     ++sup[uv];
+                     #pragma omp atomic
+                     ++sup[uw];
+                     #pragma omp atomic
+                     ++sup[vw];
+                 });
+
+    // triangles, and the sum of the degrees of the neighbors of each vertex
+    vector<val_t> tri(N), sdeg(N);
+    #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+    for (size_t v = 0; v < N; ++v)
+    {
+        for (size_t i = pos[v]; i < pos[v + 1]; ++i)
+        {
+            tri[v] += sup[slots[i]];
+            sdeg[v] += deg(oa.vertex(ns[i])) - 1;
+        }
+        tri[v] /= 2;
+    }
+
+    // non-induced counts, with the same indices as the orbits
+    orbits.clear();
+    orbits.resize(N);
+    auto& c = orbits;
+
+    // tips of 4-cycles with a chord, from the triangles
+    oa.triangles([&](auto u, auto v, auto w, auto uv, auto uw, auto vw)
+                 {
+                     #pragma omp atomic
+                     c[u][12] += sup[vw] - 1;
+                     #pragma omp atomic
+                     c[v][12] += sup[uw] - 1;
+                     #pragma omp atomic
+                     c[w][12] += sup[uv] - 1;
+                 });
+
+    // 4-cliques
+    oa.four_cliques([&](auto u, auto v, auto w, auto x)
+                    {
+                        #pragma omp atomic
+                        ++c[u][14];
+                        #pragma omp atomic
+                        ++c[v][14];
+                        #pragma omp atomic
+                        ++c[w][14];
+                        #pragma omp atomic
+                        ++c[x][14];
+                    });
+
+    // 4-cycles
+    #pragma omp parallel if (N > OPENMP_MIN_THRESH)
+    {
+        vector<val_t> count(N);
+        vector<size_t> touched;
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t u = 0; u < N; ++u)
+        {
+            size_t r = oa.rank(u);
+            auto paths = [&](auto&& f)
+                {
+                    for (size_t i = pos[u]; i < pos[u + 1] && ns[i] < r; ++i)
+                    {
+                        auto v = oa.vertex(ns[i]);
+                        for (size_t j = pos[v]; j < pos[v + 1] && ns[j] < r;
+                             ++j)
+                            f(v, oa.vertex(ns[j]));
+                    }
+                };
+            paths([&](auto, auto w)
+                  {
+                      if (count[w]++ == 0)
+                          touched.push_back(w);
+                  });
+            val_t k_u = 0;
+            for (auto w : touched)
+            {
+                val_t k = (count[w] * (count[w] - 1)) / 2;
+                k_u += k;
+                #pragma omp atomic
+                c[w][8] += k;
+            }
+            #pragma omp atomic
+            c[u][8] += k_u;
+            paths([&](auto v, auto w)
+                  {
+                      #pragma omp atomic
+                      c[v][8] += count[w] - 1;
+                  });
+            for (auto w : touched)
+                count[w] = 0;
+            touched.clear();
+        }
+    }
+
+    // the remaining non-induced counts, and the induced ones
+    #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+    for (size_t v = 0; v < N; ++v)
+    {
+        auto& o = c[v];
+        val_t d = deg(v);
+        val_t t = tri[v];
+        for (size_t i = pos[v]; i < pos[v + 1]; ++i)
+        {
+            auto u = oa.vertex(ns[i]);
+            val_t d_u = deg(u);
+            val_t t_vu = sup[slots[i]];
+            o[4] += sdeg[u] - d + 1;
+            o[5] += (d - 1) * (d_u - 1);
+            o[6] += ((d_u - 1) * (d_u - 2)) / 2;
+            o[9] += tri[u] - t_vu;
+            o[10] += t_vu * (d_u - 2);
+            o[13] += (t_vu * (t_vu - 1)) / 2;
+        }
+        o[4] -= 2 * t;
+        o[5] -= 2 * t;
+        o[7] = (d * (d - 1) * (d - 2)) / 6;
+        o[11] = t * (d - 2);
+
+        o[13] -= 3 * o[14];
+        o[12] -= 3 * o[14];
+        o[11] -= 2 * o[13] + 3 * o[14];
+        o[10] -= 2 * o[12] + 2 * o[13] + 6 * o[14];
+        o[9] -= 2 * o[12] + 3 * o[14];
+        o[8] -= o[12] + o[13] + 3 * o[14];
+        o[7] -= o[11] + o[13] + o[14];
+        o[6] -= o[9] + o[10] + 2 * o[12] + o[13] + 3 * o[14];
+        o[5] -= 2 * o[8] + o[10] + 2 * o[11] + 2 * o[12] + 4 * o[13] +
+            6 * o[14];
+        o[4] -= 2 * o[8] + 2 * o[9] + o[10] + 4 * o[12] + 2 * o[13] +
+            6 * o[14];
+
+        o[0] = d;
+        o[1] = sdeg[v] - 2 * t;
+        o[2] = (d * (d - 1)) / 2 - t;
+        o[3] = t;
+    }
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_ORBITS_HH
@@ -0,0 +1,402 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// you should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_TRIANGLES_HH
+#define GRAPH_TRIANGLES_HH
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "graph_intersect.hh"
+
+namespace graph_tool
+{
+using namespace boost;
+using namespace std;
+
+// Degree-ordered orientation of an undirected graph, used to enumerate its
+// triangles (Schank and Wagner 2005, Latapy 2008).
+//
+// The vertices are ranked by (degree, index), and each edge is only stored at
+// its endpoint of lowest rank, so that the out-degree of every vertex is
+// O(sqrt(E)). Each triangle u < v < w (in rank order) is then found exactly
+// once, when intersecting the list of u with the list of v ("forward"
+// algorithm). The lists hold the ranks of the neighbors in increasing order,
+// hence only the part of the list of u that comes after v needs to be
+// intersected ("compact forward"). The intersections are done with
+// intersect_count() or intersect_apply(), and the vertices are distributed
+// dynamically among the threads, since the amount of work per vertex is very
+// heterogeneous in graphs with broad degree distributions.
+//
+// Self-loops are ignored, and parallel edges are stored only once, together
+// with their multiplicities. Every (distinct) pair of adjacent vertices has a
+// "slot", i.e. its position in the oriented lists, which can be used to index
+// per-edge quantities, such as the number of triangles to which it belongs.
+class oriented_adjacency
+{
+public:
+    template <class Graph>
+    oriented_adjacency(const Graph& g)
+    {
+        size_t N = num_vertices(g);
+
+        // the ranks are obtained by counting sort
+        vector<size_t> deg(N);
+        size_t kmax = 0;
+        #pragma omp parallel if (N > OPENMP_MIN_THRESH) reduction(max:kmax)
+        parallel_vertex_loop_no_spawn
+            (g,
+             [&](auto v)
+             {
+                 deg[v] = out_degree(v, g);
+                 kmax = std::max(kmax, deg[v]);
+             });
+        vector<size_t> count(kmax + 2);
+        size_t n = 0;
+        for (auto v : vertices_range(g))
+        {
+            ++count[deg[v] + 1];
+            ++n;
+        }
+        for (size_t k = 0; k <= kmax; ++k)
+            count[k + 1] += count[k];
+        _rank.resize(N);
+        _order.resize(n);
+        for (auto v : vertices_range(g))
+        {
+            auto r = count[deg[v]]++;
+            _rank[v] = r;
+            _order[r] = v;
+        }
+
+        // the neighbors of higher rank, with repetitions, in the space
+        // reserved for all the neighbors
+        vector<size_t> pos(N + 1), adj;
+        for (size_t v = 0; v < N; ++v)
+            pos[v + 1] = pos[v] + deg[v];
+        adj.resize(pos[N]);
+
+        _pos.resize(N + 1);
+        size_t multi = 0;
+        #pragma omp parallel if (N > OPENMP_MIN_THRESH) reduction(+:multi)
+        parallel_vertex_loop_no_spawn
+            (g,
+             [&](auto v)
+             {
+                 auto i = pos[v];
+                 for (auto w : out_neighbors_range(v, g))
+                 {
+                     if (_rank[w] > _rank[v])
+                         adj[i++] = _rank[w];
+                 }
+                 deg[v] = i - pos[v];
+                 std::sort(adj.begin() + pos[v], adj.begin() + i);
+                 size_t k = 0;
+                 for (size_t j = pos[v]; j < i; ++j)
+                 {
+                     if (j == pos[v] || adj[j] != adj[j - 1])
+                         ++k;
+                 }
+                 _pos[v + 1] = k;
+                 if (k < deg[v])
+                     ++multi;
+             });
+        for (size_t v = 0; v < N; ++v)
+            _pos[v + 1] += _pos[v];
+
+        _adj.resize(_pos[N]);
+        if (multi > 0)
+            _mult.resize(_pos[N]);
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 auto j = _pos[v];
+                 for (size_t i = pos[v]; i < pos[v] + deg[v]; ++i)
+                 {
+                     if (i > pos[v] && adj[i] == adj[i - 1])
+                     {
+                         ++_mult[j - 1];
+                         continue;
+                     }
+                     _adj[j] = adj[i];
+                     if (multi > 0)
+                         _mult[j] = 1;
+                     ++j;
+                 }
+             });
+    }
+
+    // Calls f(u, v, w, uv, uw, vw) for every triangle, exactly once, where
+    // rank(u) < rank(v) < rank(w), and uv, uw and vw are the slots of its
+    // edges. The function is called concurrently from several threads, if
+    // parallel == true.
+    template <class F>
+    void triangles(F&& f, bool parallel = true) const
+    {
+        size_t N = _pos.size() - 1;
+        #pragma omp parallel for schedule(dynamic, 64) \
+            if (parallel && N > OPENMP_MIN_THRESH)
+        for (size_t u = 0; u < N; ++u)
+        {
+            auto a = _adj.data() + _pos[u];
+            size_t na = _pos[u + 1] - _pos[u];
+            for (size_t i = 0; i + 1 < na; ++i)
+            {
+                auto v = _order[a[i]];
+                auto b = _adj.data() + _pos[v];
+                size_t nb = _pos[v + 1] - _pos[v];
+                intersect_apply(a + i + 1, na - i - 1, b, nb,
+                                [&](auto j, auto k)
+                                {
+                                    f(u, v, _order[b[k]], _pos[u] + i,
+                                      _pos[u] + i + 1 + j, _pos[v] + k);
+                                });
+            }
+        }
+    }
+
+    // Calls f(u, v, w, x) for every 4-clique, exactly once, where
+    // rank(u) < rank(v) < rank(w) < rank(x), by intersecting the list of w
+    // with the common neighbors of higher rank of u and v.
+    template <class F>
+    void four_cliques(F&& f, bool parallel = true) const
+    {
+        size_t N = _pos.size() - 1;
+        #pragma omp parallel if (parallel && N > OPENMP_MIN_THRESH)
+        {
+            vector<size_t> common;
+            #pragma omp for schedule(dynamic, 64)
+            for (size_t u = 0; u < N; ++u)
+            {
+                auto a = _adj.data() + _pos[u];
+                size_t na = _pos[u + 1] - _pos[u];
+                for (size_t i = 0; i + 2 < na; ++i)
+                {
+                    auto v = _order[a[i]];
+                    common.clear();
+                    intersect_apply(a + i + 1, na - i - 1,
+                                    _adj.data() + _pos[v],
+                                    _pos[v + 1] - _pos[v],
+                                    [&](auto j, auto)
+                                    {
+                                        common.push_back(a[i + 1 + j]);
+                                    });
+                    for (size_t j = 0; j + 1 < common.size(); ++j)
+                    {
+                        auto w = _order[common[j]];
+                        auto c = _adj.data() + _pos[w];
+                        intersect_apply(common.data() + j + 1,
+                                        common.size() - j - 1,
+                                        c, _pos[w + 1] - _pos[w],
+                                        [&](auto, auto k)
+                                        {
+                                            f(u, v, w, _order[c[k]]);
+                                        });
+                    }
+                }
+            }
+        }
+    }
+
+    // Adds to t[v] the number of triangles to which each vertex v belongs,
+    // multiplied by two, where each triangle (u, v, w) contributes
+    // (m_uv + m_uw) m_vw to u, etc., with m_uv being the number of parallel
+    // edges between u and v, as in get_triangles(). The contributions to u and
+    // v are accumulated locally, and only the one to w is done atomically.
+    template <class Val>
+    void vertex_triangles(vector<Val>& t, bool parallel = true) const
+    {
+        size_t N = _pos.size() - 1;
+        #pragma omp parallel for schedule(dynamic, 64) \
+            if (parallel && N > OPENMP_MIN_THRESH)
+        for (size_t u = 0; u < N; ++u)
+        {
+            auto a = _adj.data() + _pos[u];
+            size_t na = _pos[u + 1] - _pos[u];
+            Val tu = 0;
+            for (size_t i = 0; i + 1 < na; ++i)
+            {
+                auto v = _order[a[i]];
+                auto b = _adj.data() + _pos[v];
+                size_t nb = _pos[v + 1] - _pos[v];
+                Val tv = 0;
+                Val m_uv = multiplicity(_pos[u] + i);
+                intersect_apply(a + i + 1, na - i - 1, b, nb,
+                                [&](auto j, auto k)
+                                {
+                                    auto s = _pos[u] + i + 1 + j;
+                                    Val m_uw = multiplicity(s);
+                                    Val m_vw = multiplicity(_pos[v] + k);
+                                    tu += (m_uv + m_uw) * m_vw;
+                                    tv += (m_uv + m_vw) * m_uw;
+                                    Val tw = (m_uw + m_vw) * m_uv;
+                                    auto w = _order[b[k]];
+                                    #pragma omp atomic
+                                    t[w] += tw;
+                                });
+                #pragma omp atomic
+                t[v] += tv;
+            }
+            #pragma omp atomic
+            t[u] += tu;
+        }
+    }
+
+    // total number of triangles, disregarding the edge multiplicities
+    size_t count_triangles(bool parallel = true) const
+    {
+        size_t N = _pos.size() - 1;
+        size_t count = 0;
+        #pragma omp parallel for schedule(dynamic, 64) reduction(+:count) \
+            if (parallel && N > OPENMP_MIN_THRESH)
+        for (size_t u = 0; u < N; ++u)
+        {
+            auto a = _adj.data() + _pos[u];
+            size_t na = _pos[u + 1] - _pos[u];
+            for (size_t i = 0; i + 1 < na; ++i)
+            {
+                auto v = _order[a[i]];
+                count += intersect_count(a + i + 1, na - i - 1,
+                                         _adj.data() + _pos[v],
+                                         _pos[v + 1] - _pos[v]);
+            }
+        }
+        return count;
+    }
+
+    // number of distinct pairs of adjacent vertices
+    size_t num_slots() const { return _adj.size(); }
+
+    // slot of the pair (u, v), or null_slot if they are not adjacent
+    size_t slot(size_t u, size_t v) const
+    {
+        if (u == v)
+            return null_slot;
+        auto ru = _rank[u];
+        auto rv = _rank[v];
+        if (ru > rv)
+        {
+            std::swap(u, v);
+            std::swap(ru, rv);
+        }
+        auto begin = _adj.begin() + _pos[u];
+        auto end = _adj.begin() + _pos[u + 1];
+        auto iter = std::lower_bound(begin, end, rv);
+        if (iter == end || *iter != rv)
+            return null_slot;
+        return iter - _adj.begin();
+    }
+
+    // number of parallel edges in the slot
+    size_t multiplicity(size_t s) const
+    {
+        return _mult.empty() ? 1 : _mult[s];
+    }
+
+    bool has_parallel_edges() const { return !_mult.empty(); }
+
+    // the slots of vertex v, with the neighbors of higher rank, are in the
+    // range [begin(v), end(v)), and target(s) is the neighbor in slot s
+    size_t begin(size_t v) const { return _pos[v]; }
+    size_t end(size_t v) const { return _pos[v + 1]; }
+    size_t target(size_t s) const { return _order[_adj[s]]; }
+
+    size_t rank(size_t v) const { return _rank[v]; }
+    size_t vertex(size_t r) const { return _order[r]; }
+
+    // Stores in ns[pos[v]:pos[v+1]] the ranks of all the (distinct) neighbors
+    // of each vertex v, in increasing order, and in slots the slots of the
+    // corresponding edges.
+    void get_neighborhoods(vector<size_t>& pos, vector<size_t>& ns,
+                           vector<size_t>& slots) const
+    {
+        size_t N = _pos.size() - 1;
+        vector<size_t> nlow(N);
+        for (auto r : _adj)
+            ++nlow[_order[r]];
+        pos.resize(N + 1);
+        pos[0] = 0;
+        for (size_t v = 0; v < N; ++v)
+            pos[v + 1] = pos[v] + nlow[v] + _pos[v + 1] - _pos[v];
+        ns.resize(pos[N]);
+        slots.resize(pos[N]);
+
+        // the neighbors of lower rank are appended in increasing order, and
+        // followed by those of higher rank, which are already sorted
+        vector<size_t> p(pos.begin(), pos.end() - 1);
+        for (size_t r = 0; r < _order.size(); ++r)
+        {
+            auto u = _order[r];
+            for (size_t s = _pos[u]; s < _pos[u + 1]; ++s)
+            {
+                auto w = _order[_adj[s]];
+                ns[p[w]] = r;
+                slots[p[w]++] = s;
+            }
+        }
+        #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+        {
+            for (size_t s = _pos[v]; s < _pos[v + 1]; ++s)
+            {
+                auto i = pos[v] + nlow[v] + s - _pos[v];
+                ns[i] = _adj[s];
+                slots[i] = s;
+            }
+        }
+    }
+
+    static constexpr size_t null_slot = numeric_limits<size_t>::max();
+
+private:
+    vector<size_t> _rank;   // rank of each vertex
+    vector<size_t> _order;  // vertex of each rank
+    vector<size_t> _pos;    // start of the list of each vertex
+    vector<size_t> _adj;    // ranks of the neighbors of higher rank
+    vector<size_t> _mult;   // multiplicities (empty if there are none)
+};
+
+// Counts the triangles to which each vertex of an undirected and unweighted
+// graph belongs, and the number of pairs of its neighbors, with the same
+// conventions as get_triangles().
+template <class Graph, class Val>
+void get_all_triangles(const Graph& g, vector<std::pair<Val, Val>>& ret)
+{
+    size_t N = num_vertices(g);
+    ret.resize(N);
+    vector<Val> tri(N);
+    oriented_adjacency(g).vertex_triangles(tri);
+
+    parallel_vertex_loop
+        (g,
+         [&](auto v)
+         {
+             Val k = 0;
+             for (auto n : out_neighbors_range(v, g))
+             {
+                 if (n != v)
+                     ++k;
+             }
+             ret[v] = make_pair(Val(tri[v] / 2), Val((k * (k - 1)) / 2));
+         });
+}
+
+} //graph-tool namespace
+
+#endif // GRAPH_TRIANGLES_HH
@@ -0,0 +1,67 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// you should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "graph.hh"
+
+#include "graph_triest.hh"
+
+#include "random.hh"
+#include "numpy_bind.hh"
+
+#include <boost/python.hpp>
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+TriestEstimator* make_triest(size_t M, rng_t& rng)
+{
+    return new TriestEstimator(M, rng);
+}
+
+// ingests the rows of an (E, 2) array of vertex indices, in order
+void triest_add_edges(TriestEstimator& state, boost::python::object oedges)
+{
+    auto edges = get_array<uint64_t, 2>(oedges);
+    if (edges.shape()[0] > 0 && edges.shape()[1] < 2)
+        throw ValueException("edge list must have at least two columns");
+    for (size_t i = 0; i < edges.shape()[0]; ++i)
+        state.insert(edges[i][0], edges[i][1]);
+}
+
+boost::python::object triest_get_local(TriestEstimator& state)
+{
+    return wrap_vector_owned(state.get_local());
+}
+
+void export_triest()
+{
+    using namespace boost::python;
+    class_<TriestEstimator, boost::noncopyable>("TriestEstimator", no_init)
+        .def("__init__", make_constructor(&make_triest))
+        .def("insert", &TriestEstimator::insert)
+        .def("add_edges", &triest_add_edges)
+        .def("num_edges", &TriestEstimator::num_edges)
+        .def("sample_size", &TriestEstimator::sample_size)
+        .def("triangles", &TriestEstimator::triangles)
+        .def("vertex_triangles", &TriestEstimator::vertex_triangles)
+        .def("wedges", &TriestEstimator::wedges)
+        .def("degree", &TriestEstimator::degree)
+        .def("global_clustering", &TriestEstimator::global_clustering)
+        .def("local_clustering", &TriestEstimator::local_clustering)
+        .def("get_local", &triest_get_local);
+}
@@ -0,0 +1,183 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// you should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_TRIEST_HH
+#define GRAPH_TRIEST_HH
+
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "graph_intersect.hh"
+#include "random.hh"
+
+namespace graph_tool
+{
+using namespace std;
+
+// Streaming estimates of the global and local triangle counts of an
+// undirected graph whose edges are observed one at a time, following
+// TRIEST-IMPR (De Stefani et al. 2016).
+//
+// A uniform sample of at most M edges is kept by reservoir sampling. When the
+// t-th edge (u, v) arrives, the triangles it closes with the sampled edges,
+// i.e. the common neighbors of u and v in the sample, are counted before the
+// sample is updated, and each of them is weighted by
+//
+//    eta(t) = max(1, (t - 1) (t - 2) / (M (M - 1))),
+//
+// the inverse of the probability that both of its other edges are in the
+// sample. The counts are never decremented, and are unbiased estimates of
+// the number of triangles in the graph seen so far, which are exact as long
+// as t <= M. The degrees, and hence the number of wedges, are kept exactly,
+// so that the clustering coefficients can be estimated as well. All queries
+// take constant time, and the memory use is O(M + V).
+//
+// The sampled neighborhoods are kept as sorted lists, which are intersected
+// with intersect_apply(). The edges are assumed to be distinct, and
+// self-loops are ignored.
+class TriestEstimator
+{
+public:
+    TriestEstimator(size_t M, rng_t& rng)
+        : _M(std::max(M, size_t(2))), _rng(rng)
+    {
+        _rng.set_stream(1);
+        rng.discard(1);
+        _sample.reserve(_M);
+    }
+
+    void insert(size_t u, size_t v)
+    {
+        if (u == v)
+            return;
+        ++_t;
+        size_t n = std::max(u, v) + 1;
+        if (n > _deg.size())
+        {
+            _deg.resize(n);
+            _local.resize(n);
+            _adj.resize(n);
+        }
+
+        _wedges += _deg[u] + _deg[v];
+        ++_deg[u];
+        ++_deg[v];
+
+        double eta = std::max(1., (double(_t - 1) * (_t - 2)) /
+                                  (double(_M) * (_M - 1)));
+        auto& a = _adj[u];
+        auto& b = _adj[v];
+        double c = 0;
+        intersect_apply(a.data(), a.size(), b.data(), b.size(),
+                        [&](auto i, auto)
+                        {
+                            _local[a[i]] += eta;
+                            c += eta;
+                        });
+        _local[u] += c;
+        _local[v] += c;
+        _global += c;
+
+        if (_t <= _M)
+        {
+            _sample.emplace_back(u, v);
+            add_sampled(u, v);
+            return;
+        }
+
+        std::uniform_real_distribution<> coin;
+        if (coin(_rng) >= double(_M) / _t)
+            return;
+        std::uniform_int_distribution<size_t> sample(0, _M - 1);
+        auto& e = _sample[sample(_rng)];
+        remove_sampled(e.first, e.second);
+        e = {u, v};
+        add_sampled(u, v);
+    }
+
+    // number of edges seen so far, excluding self-loops
+    size_t num_edges() const { return _t; }
+
+    // number of edges in the sample
+    size_t sample_size() const { return _sample.size(); }
+
+    double triangles() const { return _global; }
+
+    double vertex_triangles(size_t v) const
+    {
+        return (v < _local.size()) ? _local[v] : 0;
+    }
+
+    double wedges() const { return _wedges; }
+
+    size_t degree(size_t v) const
+    {
+        return (v < _deg.size()) ? _deg[v] : 0;
+    }
+
+    double global_clustering() const
+    {
+        return (_wedges > 0) ? (3 * _global) / _wedges : 0;
+    }
+
+    double local_clustering(size_t v) const
+    {
+        double k = degree(v);
+        if (k < 2)
+            return 0;
+        return vertex_triangles(v) / ((k * (k - 1)) / 2);
+    }
+
+    const vector<double>& get_local() const { return _local; }
+
+private:
+    void add_sampled(size_t u, size_t v)
+    {
+        auto insert_sorted = [](auto& ns, size_t w)
+            {
+                ns.insert(std::lower_bound(ns.begin(), ns.end(), w), w);
+            };
+        insert_sorted(_adj[u], v);
+        insert_sorted(_adj[v], u);
+    }
+
+    void remove_sampled(size_t u, size_t v)
+    {
+        auto erase_sorted = [](auto& ns, size_t w)
+            {
+                ns.erase(std::lower_bound(ns.begin(), ns.end(), w));
+            };
+        erase_sorted(_adj[u], v);
+        erase_sorted(_adj[v], u);
+    }
+
+    size_t _M;
+    rng_t _rng;
+    size_t _t = 0;
+    double _global = 0;
+    double _wedges = 0;
+
+    vector<size_t> _deg;                 // degrees in the stream
+    vector<double> _local;               // local triangle estimates
+    vector<vector<size_t>> _adj;         // sorted sampled neighborhoods
+    vector<std::pair<size_t, size_t>> _sample;
+};
+
+} // graph_tool namespace
+
+#endif // GRAPH_TRIEST_HH
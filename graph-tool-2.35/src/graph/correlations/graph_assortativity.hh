@@ -18,7 +18,11 @@
 #ifndef GRAPH_ASSORTATIVITY_HH
 #define GRAPH_ASSORTATIVITY_HH
 
+#include <array>
+#include <limits>
+
 #include "shared_map.hh"
+#include "graph_properties.hh"
 #include "graph_util.hh"
 #include "hash_map_wrap.hh"
 
@@ -31,9 +35,199 @@ namespace graph_tool
 using namespace std;
 using namespace boost;
 
+// Joint histogram of the values at the endpoints of the out-edges, as a list
+// of (i, j, n) entries, meaning that n edges go from a vertex with value
+// k_min + i to one with value k_min + j. The same pair may appear in more than
+// one entry.
+//
+// This is only done for integer values spanning a range of size K not much
+// larger than the number of vertices, otherwise false is returned. The
+// vertices are sorted by value, and the values of the neighbors of each run of
+// vertices with the same value are counted in a dense array, so that the
+// number of entries is typically much smaller than the number of edges.
+template <class Graph, class DegreeSelector, class Val>
+bool get_deg_pair_hist(const Graph& g, DegreeSelector deg,
+                       vector<std::array<size_t, 3>>& hist, Val& k_min,
+                       size_t& K)
+{
+    typedef typename DegreeSelector::value_type val_t;
+    if constexpr (!std::is_integral<val_t>::value)
+    {
+        return false;
+    }
+    else
+    {
+        size_t N = num_vertices(g);
+        vector<val_t> k(N);
+        val_t k_lo = numeric_limits<val_t>::max();
+        val_t k_hi = numeric_limits<val_t>::min();
+        #pragma omp parallel if (N > OPENMP_MIN_THRESH) \
+            reduction(min:k_lo) reduction(max:k_hi)
+        parallel_vertex_loop_no_spawn
+            (g,
+             [&](auto v)
+             {
+                 k[v] = deg(v, g);
+                 k_lo = std::min(k_lo, k[v]);
+                 k_hi = std::max(k_hi, k[v]);
+             });
+
+        hist.clear();
+        k_min = k_lo;
+        K = 0;
+        if (k_lo > k_hi)
+            return true;
+        if (size_t(k_hi) - size_t(k_lo) >= std::max(N, size_t(1) << 16))
+            return false;
+        K = size_t(k_hi) - size_t(k_lo) + 1;
+
+        auto idx = [&](auto v) { return size_t(k[v]) - size_t(k_lo); };
+
+        // counting sort of the vertices by value
+        vector<size_t> pos(K + 1);
+        for (auto v : vertices_range(g))
+            ++pos[idx(v) + 1];
+        for (size_t i = 0; i < K; ++i)
+            pos[i + 1] += pos[i];
+        vector<size_t> order(pos[K]);
+        for (auto v : vertices_range(g))
+            order[pos[idx(v)]++] = v;
+
+        #pragma omp parallel if (N > OPENMP_MIN_THRESH)
+        {
+            vector<size_t> count(K), touched;
+            vector<std::array<size_t, 3>> lhist;
+            size_t i = K;
+            auto flush = [&]()
+                {
+                    for (auto j : touched)
+                    {
+                        lhist.push_back({i, j, count[j]});
+                        count[j] = 0;
+                    }
+                    touched.clear();
+                };
+
+            #pragma omp for schedule(static)
+            for (size_t n = 0; n < order.size(); ++n)
+            {
+                auto v = order[n];
+                if (idx(v) != i)
+                {
+                    flush();
+                    i = idx(v);
+                }
+                for (auto u : out_neighbors_range(v, g))
+                {
+                    auto j = idx(u);
+                    if (count[j]++ == 0)
+                        touched.push_back(j);
+                }
+            }
+            flush();
+
+            #pragma omp critical (deg_pair_hist)
+            hist.insert(hist.end(), lhist.begin(), lhist.end());
+        }
+        return true;
+    }
+}
+
+// Computes the assortativity coefficient, and its jackknife variance, from the
+// total weight n_edges of the edges, the weight e_kk of the edges between
+// vertices of the same type, and t2 = sum_k a_k b_k, where a_k and b_k are the
+// weights of the edges leaving and arriving at vertices of type k. The
+// function jackknife(dev) must return the sum of dev(w, b_k1, a_k2, k1 == k2)
+// over all edges of weight w between vertices of types k1 and k2.
+template <class Jackknife>
+void assortativity_from_marginals(double n_edges, double e_kk, double t2,
+                                  bool directed, Jackknife&& jackknife,
+                                  double& r, double& r_err)
+{
+    double t1 = e_kk / n_edges;
+    t2 /= n_edges * n_edges;
+
+#if (BOOST_VERSION >= 106000)
+    bool defined = boost::math::relative_difference(1., t2) > 1e-8;
+#else
+    bool defined = abs(1.-t2) > 1e-8;
+#endif
+    if (defined)
+        r = (t1 - t2)/(1.0 - t2);
+    else
+        r = std::numeric_limits<double>::quiet_NaN();
+
+    // "jackknife" variance
+    double one = directed ? 1 : 2;
+
+    // the squared deviation of the coefficient obtained without an edge of
+    // weight w between vertices of types k1 and k2, given b[k1], a[k2] and
+    // whether k1 == k2
+    auto dev = [&](double w, double b_k1, double a_k2, bool same)
+        {
+            double tl2 = (t2 * (n_edges * n_edges)
+                          - w * one * b_k1 - w * one * a_k2) /
+                ((n_edges - w * one) * (n_edges - w * one));
+            double tl1 = t1 * n_edges;
+            if (same)
+                tl1 -= one * w;
+            tl1 /= n_edges - one * w;
+            double rl = (tl1 - tl2) / (1.0 - tl2);
+            return (r - rl) * (r - rl);
+        };
+
+    double err = jackknife(dev);
+    if (!directed)
+        err /= 2;
+    if (defined)
+        r_err = sqrt(err);
+    else
+        r_err = std::numeric_limits<double>::quiet_NaN();
+}
+
+// Computes the assortativity coefficient, and its jackknife variance, from a
+// joint histogram of value indices as given by get_deg_pair_hist(), with K
+// distinct values.
+inline void get_hist_assortativity(const vector<std::array<size_t, 3>>& hist,
+                                   size_t K, bool directed, double& r,
+                                   double& r_err)
+{
+    vector<size_t> da(K), db(K);
+    size_t n_edges = 0, e_kk = 0;
+    for (auto& [i, j, n] : hist)
+    {
+        da[i] += n;
+        db[j] += n;
+        n_edges += n;
+        if (i == j)
+            e_kk += n;
+    }
+    double t2 = 0;
+    for (size_t i = 0; i < K; ++i)
+        t2 += double(da[i]) * db[i];
+
+    assortativity_from_marginals
+        (n_edges, e_kk, t2, directed,
+         [&](auto& dev)
+         {
+             double err = 0;
+             #pragma omp parallel for schedule(runtime) \
+                 if (hist.size() > OPENMP_MIN_THRESH) reduction(+:err)
+             for (size_t l = 0; l < hist.size(); ++l)
+             {
+                 auto& [i, j, n] = hist[l];
+                 err += n * dev(1, db[i], da[j], i == j);
+             }
+             return err;
+         }, r, r_err);
+}
 
 // this will calculate the assortativity coefficient, based on the property
 // pointed by 'deg'
+//
+// For unweighted graphs and integer-valued properties, everything is obtained
+// from the joint histogram above, including the jackknife variance, which
+// then takes a single pass over the edges.
 
 struct get_assortativity_coefficient
 {
@@ -41,12 +235,26 @@ struct get_assortativity_coefficient
     void operator()(const Graph& g, DegreeSelector deg, Eweight eweight,
                     double& r, double& r_err) const
     {
+        typedef typename DegreeSelector::value_type val_t;
+        bool directed = graph_tool::is_directed(g);
+
+        if constexpr (is_unity_property<Eweight>::value)
+        {
+            vector<std::array<size_t, 3>> hist;
+            val_t k_min;
+            size_t K;
+            if (get_deg_pair_hist(g, deg, hist, k_min, K))
+            {
+                get_hist_assortativity(hist, K, directed, r, r_err);
+                return;
+            }
+        }
+
         typedef typename property_traits<Eweight>::value_type wval_t;
         wval_t n_edges = 0;
         wval_t e_kk = 0;
 
-        typedef typename DegreeSelector::value_type val_t;
-        typedef gt_hash_map<val_t, size_t> map_t;
+        typedef gt_hash_map<val_t, double> map_t;
         map_t a, b;
 
         SharedMap<map_t> sa(a), sb(b);
@@ -73,65 +281,173 @@ struct get_assortativity_coefficient
         sa.Gather();
         sb.Gather();
 
-        double t1 = double(e_kk) / n_edges, t2 = 0.0;
-
+        double t2 = 0.0;
         for (auto& ai : a)
         {
             auto bi = b.find(ai.first);
             if (bi != b.end())
                 t2 += ai.second * bi->second;
         }
-        t2 /= n_edges * n_edges;
 
+        auto get = [](const map_t& m, const val_t& k) -> double
+            {
+                auto iter = m.find(k);
+                return (iter != m.end()) ? iter->second : 0;
+            };
 
-#if (BOOST_VERSION >= 106000)
-        if (boost::math::relative_difference(1., t2) > 1e-8)
-#else
-        if (abs(1.-t2) > 1e-8)
-#endif
-            r = (t1 - t2)/(1.0 - t2);
-        else
-            r = std::numeric_limits<double>::quiet_NaN();
-
-        // "jackknife" variance
-        double err = 0;
-        size_t one = (graph_tool::is_directed(g)) ? 1 : 2;
-        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
-            reduction(+:err)
-        parallel_vertex_loop_no_spawn
-            (g,
-             [&](auto v)
+        assortativity_from_marginals
+            (n_edges, e_kk, t2, directed,
+             [&](auto& dev)
              {
-                 val_t k1 = deg(v, g);
-                 for (auto e : out_edges_range(v, g))
-                 {
-                     auto u = target(e, g);
-                     auto w = eweight[e];
-                     val_t k2 = deg(u, g);
-                     double tl2 = (t2 * (n_edges * n_edges)
-                                   - w * one * b[k1] - w * one * a[k2]) /
-                         ((n_edges - w * one) * (n_edges - w * one));
-                     double tl1 = t1 * n_edges;
-                     if (k1 == k2)
-                         tl1 -= one * w;
-                     tl1 /= n_edges - one * w;
-                     double rl = (tl1 - tl2) / (1.0 - tl2);
-                     err += (r - rl) * (r - rl);
-                }
-             });
-        if (!graph_tool::is_directed(g))
-            err /= 2;
-#if (BOOST_VERSION >= 106000)
-        if (boost::math::relative_difference(1., t2) > 1e-8)
-#else
-        if (abs(1.-t2) > 1e-8)
-#endif
-            r_err = sqrt(err);
-        else
-            r_err = std::numeric_limits<double>::quiet_NaN();
+                 double err = 0;
+                 #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
+                     reduction(+:err)
+                 parallel_vertex_loop_no_spawn
+                     (g,
+                      [&](auto v)
+                      {
+                          val_t k1 = deg(v, g);
+                          double b_k1 = get(b, k1);
+                          for (auto e : out_edges_range(v, g))
+                          {
+                              auto u = target(e, g);
+                              auto w = eweight[e];
+                              val_t k2 = deg(u, g);
+                              err += dev(w, b_k1, get(a, k2), k1 == k2);
+                          }
+                      });
+                 return err;
+             }, r, r_err);
+    }
+};
+
+// Weighted means, variances and covariance of the values at the endpoints of
+// the edges, accumulated in a single pass with Welford's method, and merged
+// across threads following Chan et al. Unlike the raw sums of squares, these
+// do not lose precision when the variances are small compared to the means.
+
+struct edge_moments
+{
+    double n = 0;            // total weight
+    double a = 0, b = 0;     // means
+    double da = 0, db = 0;   // sums of squared deviations
+    double dab = 0;          // sum of products of deviations
+
+    void put(double k1, double k2, double w)
+    {
+        if (w == 0)
+            return;
+        n += w;
+        double d1 = k1 - a;
+        double d2 = k2 - b;
+        a += d1 * (w / n);
+        b += d2 * (w / n);
+        da += w * d1 * (k1 - a);
+        db += w * d2 * (k2 - b);
+        dab += w * d1 * (k2 - b);
+    }
+
+    void merge(const edge_moments& m)
+    {
+        if (m.n == 0)
+            return;
+        double n_ = n + m.n;
+        double d1 = m.a - a;
+        double d2 = m.b - b;
+        double f = (n * m.n) / n_;
+        da += m.da + d1 * d1 * f;
+        db += m.db + d2 * d2 * f;
+        dab += m.dab + d1 * d2 * f;
+        a += d1 * (m.n / n_);
+        b += d2 * (m.n / n_);
+        n = n_;
     }
 };
 
+// Computes the scalar assortativity coefficient, and its jackknife variance,
+// from the moments m of the values at the endpoints of the edges. The function
+// jackknife(dev) must return the sum of dev(k1, k2, w) over all edges of
+// weight w between vertices with values k1 and k2.
+template <class Jackknife>
+void scalar_assortativity_from_moments(const edge_moments& m, bool directed,
+                                       Jackknife&& jackknife, double& r,
+                                       double& r_err)
+{
+    double n_edges = m.n;
+    double a = m.a;
+    double b = m.b;
+    double var_a = m.da / n_edges;
+    double var_b = m.db / n_edges;
+    double stda = (var_a > 1e-8 * a * a) ? sqrt(var_a) : 0;
+    double stdb = (var_b > 1e-8 * b * b) ? sqrt(var_b) : 0;
+
+    if (stda*stdb > 0)
+        r = (m.dab / n_edges)/(stda*stdb);
+    else
+        r = std::numeric_limits<double>::quiet_NaN();
+
+    // "jackknife" variance
+    double one = directed ? 1 : 2;
+
+    // raw sums of the squares and products
+    double da = m.da + n_edges * a * a;
+    double db = m.db + n_edges * b * b;
+    double e_xy = m.dab + n_edges * a * b;
+
+    // the squared deviation of the coefficient obtained without an edge of
+    // weight w between vertices with values k1 and k2
+    auto dev = [&](double k1, double k2, double w)
+        {
+            double al = (a * n_edges - k1) / (n_edges - one);
+            double dal = sqrt((da - k1 * k1) / (n_edges - one) - al * al);
+            double bl = (b * n_edges - k2 * one * w) / (n_edges - one * w);
+            double dbl = sqrt((db - k2 * k2 * one * w) / (n_edges - one * w) - bl * bl);
+            double t1l = (e_xy - k1 * k2 * one * w)/(n_edges - one * w);
+            double rl;
+            if (dal * dbl > 0)
+                rl = (t1l - al * bl)/(dal * dbl);
+            else
+                rl = (t1l - al * bl);
+            return (r - rl) * (r - rl);
+        };
+
+    double err = jackknife(dev);
+    if (!directed)
+        err /= 2;
+    if (stda*stdb > 0)
+        r_err = sqrt(err);
+    else
+        r_err = std::numeric_limits<double>::quiet_NaN();
+}
+
+// Computes the scalar assortativity coefficient, and its jackknife variance,
+// from a joint histogram of value indices as given by get_deg_pair_hist(),
+// where val(i) is the value with index i.
+template <class Value>
+void get_hist_scalar_assortativity(const vector<std::array<size_t, 3>>& hist,
+                                   Value&& val, bool directed, double& r,
+                                   double& r_err)
+{
+    edge_moments m;
+    for (auto& [i, j, n] : hist)
+        m.put(val(i), val(j), n);
+
+    scalar_assortativity_from_moments
+        (m, directed,
+         [&](auto& dev)
+         {
+             double err = 0;
+             #pragma omp parallel for schedule(runtime) \
+                 if (hist.size() > OPENMP_MIN_THRESH) reduction(+:err)
+             for (size_t l = 0; l < hist.size(); ++l)
+             {
+                 auto& [i, j, n] = hist[l];
+                 err += n * dev(val(i), val(j), 1);
+             }
+             return err;
+         }, r, r_err);
+}
+
 // this will calculate the _scalar_ assortativity coefficient, based on the
 // scalar property pointed by 'deg'
 
@@ -141,100 +457,67 @@ struct get_scalar_assortativity_coefficient
     void operator()(const Graph& g, DegreeSelector deg, Eweight eweight,
                     double& r, double& r_err) const
     {
-        typedef typename property_traits<Eweight>::value_type val_t;
-        val_t n_edges = 0;
-        double e_xy = 0;
-        double a = 0, b = 0, da = 0, db = 0;
-
-        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
-            reduction(+:e_xy,n_edges,a,b,da,db)
-        parallel_vertex_loop_no_spawn
-            (g,
-             [&](auto v)
-             {
-                 auto k1 = deg(v, g);
-                 for (auto e : out_edges_range(v, g))
-                 {
-                     auto u = target(e, g);
-                     auto w = eweight[e];
-                     auto k2 = deg(u, g);
-                     a += k1 * w;
-                     da += k1 * k1 * w;
-                     b += k2 * w;
-                     db += k2 * k2 * w;
-                     e_xy += k1 * k2 * w;
-                     n_edges += w;
-                 }
-             });
-
-        double t1 = e_xy/n_edges;
-        a /= n_edges;
-        b /= n_edges;
-        double stda;
-        double stdb;
+        typedef typename DegreeSelector::value_type val_t;
+        bool directed = graph_tool::is_directed(g);
 
-#if (BOOST_VERSION >= 106000)
-        if (boost::math::relative_difference(da/n_edges, a*a) < 1e-8)
-            stda = 0;
-        else
-            stda = sqrt(da/n_edges - a*a);
-        if (boost::math::relative_difference(db/n_edges, b*b) < 1e-8)
-            stdb = 0;
-        else
-            stdb = sqrt(db/n_edges - b*b);
-#else
-        if (sqrt(abs(da/n_edges - a*a)) < 1e-8)
-            stda = 0;
-        else
-            stda = sqrt(da/n_edges - a*a);
-        if (sqrt(abs(db/n_edges - b*b)) < 1e-8)
-            stdb = 0;
-        else
-            stdb = sqrt(db/n_edges - b*b);
-#endif
+        if constexpr (is_unity_property<Eweight>::value)
+        {
+            vector<std::array<size_t, 3>> hist;
+            val_t k_min = val_t();
+            size_t K;
+            if (get_deg_pair_hist(g, deg, hist, k_min, K))
+            {
+                get_hist_scalar_assortativity
+                    (hist, [&](size_t i) { return double(k_min) + i; },
+                     directed, r, r_err);
+                return;
+            }
+        }
 
-        if (stda*stdb > 0)
-            r = (t1 - a*b)/(stda*stdb);
-        else
-            r = std::numeric_limits<double>::quiet_NaN();
+        edge_moments m;
+        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH)
+        {
+            edge_moments lm;
+            parallel_vertex_loop_no_spawn
+                (g,
+                 [&](auto v)
+                 {
+                     double k1 = deg(v, g);
+                     for (auto e : out_edges_range(v, g))
+                     {
+                         auto u = target(e, g);
+                         auto w = eweight[e];
+                         double k2 = deg(u, g);
+                         lm.put(k1, k2, w);
+                     }
+                 });
 
-        // "jackknife" variance
-        r_err = 0.0;
+            #pragma omp critical (scalar_assortativity)
+            m.merge(lm);
+        }
 
-        double err = 0.0;
-        size_t one = (graph_tool::is_directed(g)) ? 1 : 2;
-        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
-            reduction(+:err)
-        parallel_vertex_loop_no_spawn
-            (g,
-             [&](auto v)
+        scalar_assortativity_from_moments
+            (m, directed,
+             [&](auto& dev)
              {
-                 double k1 = double(deg(v, g));
-                 double al = (a * n_edges - k1) / (n_edges - one);
-                 double dal = sqrt((da - k1 * k1) / (n_edges - one) - al * al);
-
-                 for (auto e : out_edges_range(v, g))
-                 {
-                     auto u = target(e, g);
-                     auto w = eweight[e];
-                     double k2 = deg(u, g);
-                     double bl = (b * n_edges - k2 * one * w) / (n_edges - one * w);
-                     double dbl = sqrt((db - k2 * k2 * one * w) / (n_edges - one * w) - bl * bl);
-                     double t1l = (e_xy - k1 * k2 * one * w)/(n_edges - one * w);
-                     double rl;
-                     if (dal * dbl > 0)
-                         rl = (t1l - al * bl)/(dal * dbl);
-                     else
-                         rl = (t1l - al * bl);
-                     err += (r - rl) * (r - rl);
-                 }
-             });
-        if (!graph_tool::is_directed(g))
-            err /= 2;
-        if (stda*stdb > 0)
-            r_err = sqrt(err);
-        else
-            r_err = std::numeric_limits<double>::quiet_NaN();
+                 double err = 0;
+                 #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
+                     reduction(+:err)
+                 parallel_vertex_loop_no_spawn
+                     (g,
+                      [&](auto v)
+                      {
+                          double k1 = deg(v, g);
+                          for (auto e : out_edges_range(v, g))
+                          {
+                              auto u = target(e, g);
+                              auto w = eweight[e];
+                              double k2 = deg(u, g);
+                              err += dev(k1, k2, w);
+                          }
+                      });
+                 return err;
+             }, r, r_err);
     }
 };
 
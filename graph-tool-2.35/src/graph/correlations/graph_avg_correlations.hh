@@ -61,18 +61,23 @@ struct get_avg_correlation
         sum_t sum2(bins);
         count_t count(bins);
 
-        SharedHistogram<sum_t> s_sum(sum);
-        SharedHistogram<sum_t> s_sum2(sum2);
-        SharedHistogram<count_t> s_count(count);
-
-        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
-            firstprivate(s_sum, s_sum2, s_count)
-        parallel_vertex_loop_no_spawn
-            (g,
-             [&](auto v)
-             {
-                 put_point(v, deg1, deg2, g, weight, s_sum, s_sum2, s_count);
-             });
+        SharedSparseHistogram<sum_t> s_sum(sum);
+        SharedSparseHistogram<sum_t> s_sum2(sum2);
+        SharedSparseHistogram<count_t> s_count(count);
+
+        #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH)
+        {
+            auto& l_sum = s_sum.local();
+            auto& l_sum2 = s_sum2.local();
+            auto& l_count = s_count.local();
+            parallel_vertex_loop_no_spawn
+                (g,
+                 [&](auto v)
+                 {
+                     put_point(v, deg1, deg2, g, weight, l_sum, l_sum2,
+                               l_count);
+                 });
+        }
         s_sum.gather();
         s_sum2.gather();
         s_count.gather();
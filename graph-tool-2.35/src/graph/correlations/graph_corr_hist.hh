@@ -56,16 +56,18 @@ struct get_correlation_histogram
 
         hist_t hist(bins);
         {
-            SharedHistogram<hist_t> s_hist(hist);
+            SharedSparseHistogram<hist_t> s_hist(hist);
 
-            #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
-                firstprivate(s_hist)
-            parallel_vertex_loop_no_spawn
-                (g,
-                 [&](auto v)
-                 {
-                     put_point(v, deg1, deg2, g, weight, s_hist);
-                 });
+            #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH)
+            {
+                auto& l_hist = s_hist.local();
+                parallel_vertex_loop_no_spawn
+                    (g,
+                     [&](auto v)
+                     {
+                         put_point(v, deg1, deg2, g, weight, l_hist);
+                     });
+            }
         }
 
         bins = hist.get_bins();
@@ -85,6 +85,8 @@ public:
     bool get_reversed() {return _reversed;}
     void set_keep_epos(bool keep) {_mg->set_keep_epos(keep);}
     bool get_keep_epos() {return _mg->get_keep_epos();}
+    void sort_edges() {_mg->sort_edges();}
+    bool get_sorted_edges() {return _mg->is_sorted();}
 
 
     // graph filtering
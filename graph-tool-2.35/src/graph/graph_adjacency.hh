@@ -23,6 +23,7 @@
 #include <utility>
 #include <numeric>
 #include <tuple>
+#include <algorithm>
 #include <boost/iterator.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/range/irange.hpp>
@@ -214,7 +215,8 @@ public:
     typedef std::vector<std::pair<size_t, edge_list_t>> vertex_list_t;
     typedef typename integer_range<Vertex>::iterator vertex_iterator;
 
-    adj_list(): _n_edges(0), _edge_index_range(0), _keep_epos(false) {}
+    adj_list(): _n_edges(0), _edge_index_range(0), _keep_epos(false),
+                _sorted(false) {}
 
     struct get_vertex
     {
@@ -469,6 +471,33 @@ public:
         return _keep_epos;
     }
 
+    // Sorts the out- and in-edge lists of every vertex by neighbor (and edge
+    // index). The ordering is not maintained by edge insertions, which remain
+    // O(1): is_sorted() will return false after any insertion that breaks it
+    // (in particular, if the source already has more than one in-edge), or
+    // after an edge removal if fast removal is enabled, until this is called
+    // again.
+    void sort_edges()
+    {
+        size_t N = _edges.size();
+        #pragma omp parallel for schedule(runtime) if (N > 1000)
+        for (size_t i = 0; i < N; ++i)
+        {
+            auto pos = _edges[i].first;
+            auto& es = _edges[i].second;
+            std::sort(es.begin(), es.begin() + pos);
+            std::sort(es.begin() + pos, es.end());
+        }
+        if (_keep_epos)
+            rebuild_epos();
+        _sorted = true;
+    }
+
+    bool is_sorted() const
+    {
+        return _sorted;
+    }
+
     size_t get_edge_index_range() const { return _edge_index_range; }
 
     static Vertex null_vertex() { return std::numeric_limits<Vertex>::max(); }
@@ -544,6 +573,7 @@ private:
                                       // memory use
     bool _keep_epos;
     std::vector<std::pair<uint32_t, uint32_t>> _epos; // out, in
+    bool _sorted; // edge lists are sorted by neighbor
 
     void rebuild_epos()
     {
@@ -977,6 +1007,8 @@ add_edge(Vertex s, Vertex t, adj_list<Vertex>& g)
     if (s_pos < s_es.size())
     {
         //in-list is not empty: push first element to the back
+        if (s_es.size() - s_pos > 1)
+            g._sorted = false;
         s_es.push_back(s_es[s_pos]);
         s_es[s_pos] = {t, idx};
         if (g._keep_epos)
@@ -987,10 +1019,15 @@ add_edge(Vertex s, Vertex t, adj_list<Vertex>& g)
         s_es.emplace_back(t, idx);
     }
     s_pos++;
+    if (s_pos > 1)
+        g._sorted &= (s_es[s_pos - 2].first <= t);
 
     // put source on back of target's in-list
-    auto& t_es = g._edges[t].second;
+    auto& t_pes = g._edges[t];
+    auto& t_es = t_pes.second;
     t_es.emplace_back(s, idx);
+    if (t_es.size() - t_pes.first > 1)
+        g._sorted &= (t_es[t_es.size() - 2].first <= s);
 
     g._n_edges++;
 
@@ -1052,6 +1089,9 @@ void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
         //g.check_epos();
         assert (idx < g._epos.size());
 
+        // swapping with the back does not preserve the ordering
+        g._sorted = false;
+
         // swap with back, and pop back
         auto remove_e = [&] (auto& elist, auto&& begin, auto&& end,
                              auto&& get_pos, bool swap_back)
@@ -1224,6 +1264,7 @@ void remove_vertex_fast(Vertex v, adj_list<Vertex>& g)
     clear_vertex(v, g);
     if (v < back)
     {
+        g._sorted = false;
         g._edges[v] = g._edges[back];
 
         auto pos = g._edges[v].first;
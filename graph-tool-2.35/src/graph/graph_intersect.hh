@@ -0,0 +1,274 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_INTERSECT_HH
+#define GRAPH_INTERSECT_HH
+
+#include <vector>
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+# include <immintrin.h>
+#endif
+
+#include "graph_adjacency.hh"
+#include "graph_adaptor.hh"
+#include "graph_filtered.hh"
+#include "graph_reverse.hh"
+#include "graph_properties.hh"
+#include "graph_util.hh"
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// Intersection of sorted neighborhoods
+// ====================================
+//
+// If the edge lists of the underlying adj_list are sorted (see
+// adj_list::sort_edges()), the neighborhoods of two vertices can be
+// intersected by merging, instead of marking one of them in an array of size
+// O(N), which incurs a cache miss for almost every access in large graphs.
+
+// Returns whether the adjacency of the underlying graph is sorted.
+template <class Vertex>
+bool has_sorted_adjacency(const adj_list<Vertex>& g);
+template <class Graph, class GraphRef>
+bool has_sorted_adjacency(const reversed_graph<Graph, GraphRef>& g);
+template <class Graph>
+bool has_sorted_adjacency(const undirected_adaptor<Graph>& g);
+template <class Graph, class EdgePredicate, class VertexPredicate>
+bool has_sorted_adjacency(const filt_graph<Graph, EdgePredicate,
+                                           VertexPredicate>& g);
+
+template <class Vertex>
+bool has_sorted_adjacency(const adj_list<Vertex>& g)
+{
+    return g.is_sorted();
+}
+
+template <class Graph, class GraphRef>
+bool has_sorted_adjacency(const reversed_graph<Graph, GraphRef>& g)
+{
+    return has_sorted_adjacency(g._g);
+}
+
+template <class Graph>
+bool has_sorted_adjacency(const undirected_adaptor<Graph>& g)
+{
+    return has_sorted_adjacency(g.original_graph());
+}
+
+template <class Graph, class EdgePredicate, class VertexPredicate>
+bool has_sorted_adjacency(const filt_graph<Graph, EdgePredicate,
+                                           VertexPredicate>& g)
+{
+    return has_sorted_adjacency(g._g);
+}
+
+// Stores the distinct out-neighbors of v (other than `skip`) in `ns`, in
+// ascending order, assuming the underlying adjacency is sorted. If some
+// neighbor is repeated, due to parallel edges, the multiplicities are stored
+// in `count` and true is returned, otherwise `count` is left untouched.
+//
+// The out-edges of undirected views are the concatenation of two sorted runs
+// (the out- and in-edges of the underlying graph), which are merged here.
+template <class Graph>
+bool get_sorted_neighbors(typename graph_traits<Graph>::vertex_descriptor v,
+                          const Graph& g, size_t skip, vector<size_t>& ns,
+                          vector<size_t>& count)
+{
+    assert(has_sorted_adjacency(g));
+    ns.clear();
+    for (auto u : out_neighbors_range(v, g))
+    {
+        if (u != skip)
+            ns.push_back(u);
+    }
+
+    auto iter = std::is_sorted_until(ns.begin(), ns.end());
+    if (iter != ns.end())
+        std::inplace_merge(ns.begin(), iter, ns.end());
+
+    auto pos = std::adjacent_find(ns.begin(), ns.end());
+    if (pos == ns.end())
+        return false;
+
+    count.clear();
+    count.resize(pos - ns.begin(), 1);
+    auto last = pos;
+    count.push_back(1);
+    for (++pos; pos != ns.end(); ++pos)
+    {
+        if (*pos == *last)
+        {
+            count.back()++;
+            continue;
+        }
+        *(++last) = *pos;
+        count.push_back(1);
+    }
+    ns.erase(last + 1, ns.end());
+    return true;
+}
+
+// Calls f(i, j) for every a[i] == b[j], where both sequences are strictly
+// increasing. If their sizes are very different, each element of the shorter
+// one is searched in the longer one by galloping (exponential search), which
+// takes O(n log(m / n)) time, instead of O(n + m) for the plain merge.
+template <class F>
+void intersect_apply(const size_t* a, size_t na, const size_t* b, size_t nb,
+                     F&& f)
+{
+    constexpr size_t gallop_ratio = 32;
+    if (na * gallop_ratio < nb || nb * gallop_ratio < na)
+    {
+        bool swap = nb < na;
+        const size_t* s = swap ? b : a;
+        const size_t* l = swap ? a : b;
+        size_t ns = swap ? nb : na;
+        size_t nl = swap ? na : nb;
+        size_t j = 0;
+        for (size_t i = 0; i < ns && j < nl; ++i)
+        {
+            auto x = s[i];
+            size_t step = 1;
+            size_t hi = j;
+            while (hi < nl && l[hi] < x)
+            {
+                j = hi + 1;
+                hi += step;
+                step *= 2;
+            }
+            j = std::lower_bound(l + j, l + std::min(hi, nl), x) - l;
+            if (j < nl && l[j] == x)
+            {
+                if (swap)
+                    f(j, i);
+                else
+                    f(i, j);
+                ++j;
+            }
+        }
+        return;
+    }
+
+    size_t i = 0, j = 0;
+    while (i < na && j < nb)
+    {
+        if (a[i] < b[j])
+        {
+            ++i;
+        }
+        else if (b[j] < a[i])
+        {
+            ++j;
+        }
+        else
+        {
+            f(i, j);
+            ++i;
+            ++j;
+        }
+    }
+}
+
+// Number of common elements of two strictly increasing sequences. The merge is
+// done in blocks with SIMD instructions, if the library was compiled with
+// support for them (e.g. with -mavx2 or -march=native), comparing every
+// element of a block of `a` against every element of a block of `b`, and
+// advancing the block with the smallest last element.
+inline size_t intersect_count(const size_t* a, size_t na, const size_t* b,
+                              size_t nb)
+{
+    size_t count = 0;
+    if (na * 32 < nb || nb * 32 < na)
+    {
+        intersect_apply(a, na, b, nb, [&](auto, auto) { ++count; });
+        return count;
+    }
+
+    size_t i = 0, j = 0;
+
+#if defined(__AVX2__)
+    static_assert(sizeof(size_t) == 8, "64-bit vertex indexes expected");
+    while (i + 4 <= na && j + 4 <= nb)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        __m256i m = _mm256_cmpeq_epi64(va, vb);
+        vb = _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi64(va, vb));
+        vb = _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi64(va, vb));
+        vb = _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi64(va, vb));
+        count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(m)));
+        auto x = a[i + 3];
+        auto y = b[j + 3];
+        i += (x <= y) * 4;
+        j += (y <= x) * 4;
+    }
+#elif defined(__SSE4_1__)
+    static_assert(sizeof(size_t) == 8, "64-bit vertex indexes expected");
+    while (i + 2 <= na && j + 2 <= nb)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        __m128i m = _mm_cmpeq_epi64(va, vb);
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+        m = _mm_or_si128(m, _mm_cmpeq_epi64(va, vb));
+        count += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(m)));
+        auto x = a[i + 1];
+        auto y = b[j + 1];
+        i += (x <= y) * 2;
+        j += (y <= x) * 2;
+    }
+#endif
+
+    // branchless scalar merge
+    while (i < na && j < nb)
+    {
+        auto x = a[i];
+        auto y = b[j];
+        count += (x == y);
+        i += (x <= y);
+        j += (y <= x);
+    }
+    return count;
+}
+
+// Scratch space for the intersections above, to be kept thread-local
+struct sorted_neighbors_buffer
+{
+    vector<size_t> ns[2];
+    vector<size_t> count[2];
+};
+
+// Mark array used for intersecting neighborhoods, together with the buffers
+// used instead when the adjacency is sorted.
+template <class Val>
+struct neighbor_mark: public vector<Val>
+{
+    neighbor_mark(size_t N, Val x = Val()): vector<Val>(N, x) {}
+    sorted_neighbors_buffer sorted;
+};
+
+} // graph_tool namespace
+
+#endif // GRAPH_INTERSECT_HH
@@ -606,6 +606,12 @@ public:
 template <class Value, class Key>
 void put(const UnityPropertyMap<Value, Key>&, const Key&, const Value&) {}
 
+template <class Property>
+struct is_unity_property: std::false_type {};
+
+template <class Value, class Key>
+struct is_unity_property<UnityPropertyMap<Value, Key>>: std::true_type {};
+
 template <class Property>
 struct is_constant_property
 {
@@ -22,6 +22,7 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <tuple>
+#include <array>
 #include <vector>
 #include <utility>
 #include <limits>
@@ -64,6 +65,17 @@ struct empty_key<std::vector<Key, Allocator>>
     }
 };
 
+template <class Key, size_t N>
+struct empty_key<std::array<Key, N>>
+{
+    static std::array<Key, N> get()
+    {
+        std::array<Key, N> k;
+        k.fill(empty_key<Key>::get());
+        return k;
+    }
+};
+
 template <class Val1, class Val2>
 struct empty_key<std::pair<Val1, Val2>>
 {
@@ -137,6 +149,17 @@ struct deleted_key<std::vector<Key, Allocator>>
     }
 };
 
+template <class Key, size_t N>
+struct deleted_key<std::array<Key, N>>
+{
+    static std::array<Key, N> get()
+    {
+        std::array<Key, N> k;
+        k.fill(deleted_key<Key>::get());
+        return k;
+    }
+};
+
 template <class Val1, class Val2>
 struct deleted_key<std::pair<Val1, Val2>>
 {
@@ -29,37 +29,39 @@
 #include <boost/mpl/int.hpp>
 
 #include <boost/python/object.hpp>
+#include <boost/functional/hash.hpp>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+#include "hash_map_wrap.hh"
 
 //
-// This is a generic multidimensional histogram type
+// These are the bin edges of a multidimensional histogram, which are used to
+// obtain the bin of a point
 //
 
-template <class ValueType, class CountType, size_t Dim>
-class Histogram
+template <class ValueType, size_t Dim>
+class HistogramBins
 {
 public:
     typedef std::array<ValueType,Dim> point_t; // point type to be
                                                // histogrammed
     typedef std::array<size_t,Dim> bin_t;      // bin type
 
-    typedef boost::multi_array<CountType,Dim> count_t; // the histogram itself
-
     typedef boost::mpl::int_<Dim> dim;
-    typedef CountType count_type;
     typedef ValueType value_type;
 
-    // floating point type to calculate the mean
-    typedef typename boost::mpl::if_<boost::is_floating_point<ValueType>,
-                                     ValueType, double>::type mean_t;
-
-    Histogram(const std::array<std::vector<ValueType>, Dim>& bins)
+    HistogramBins(const std::array<std::vector<ValueType>, Dim>& bins)
         : _bins(bins)
     {
-        bin_t new_shape;
         for (size_t j = 0; j < Dim; ++j)
         {
             if (_bins[j].size() < 1)
                 throw std::range_error("invalid bin edge number < 1!");
+            if (_bins[j].size() < 2)
+                throw std::range_error("invalid bin edge number < 2!");
 
             _data_range[j] = std::make_pair(0, 0);
             value_type delta = _bins[j][1] - _bins[j][0];
@@ -69,6 +71,9 @@ public:
                 _data_range[j] = std::make_pair(_bins[j][0], _bins[j][0]);
                 delta = _bins[j][1];
                 _const_width[j] = true;
+
+                // the second value is the bin width, not its upper edge
+                _bins[j][1] = _bins[j][0] + delta;
             }
             else
             {
@@ -88,48 +93,35 @@ public:
             }
             if (delta == 0)
                 throw std::range_error("invalid bin size of zero!");
-
-            new_shape[j] = _bins[j].size() - 1;
+            _delta[j] = delta;
         }
-        _counts.resize(new_shape);
     }
 
-    void put_value(const point_t& v, const CountType& weight = 1)
+    // Obtains the bin of the given point, and returns false if it is out of
+    // bounds. If the bins are open-ended, their edges are extended as needed.
+    bool get_bin(const point_t& v, bin_t& bin)
     {
-        bin_t bin;
         for (size_t i = 0; i < Dim; ++i)
         {
             if (_const_width[i])
             {
-                value_type delta;
+                value_type delta = _delta[i];
 
                 if (_data_range[i].first == _data_range[i].second)
                 {
-                    delta = _bins[i][1];
-
                     if (v[i] < _data_range[i].first)
-                        return; // out of bounds
+                        return false; // out of bounds
                 }
                 else
                 {
-                    delta = _bins[i][1] - _bins[i][0];
-
                     if (v[i] < _data_range[i].first ||
                         v[i] >= _data_range[i].second)
-                        return; // out of bounds
+                        return false; // out of bounds
                 }
 
                 bin[i] = size_t((v[i] - _data_range[i].first) / delta);
-                if (bin[i] >= _counts.shape()[i]) // modify shape
-                {
-                    bin_t new_shape;
-                    for (size_t j = 0; j < Dim; ++j)
-                        new_shape[j] = _counts.shape()[j];
-                    new_shape[i] = bin[i] + 1;
-                    _counts.resize(new_shape);
-                    while (_bins[i].size() < new_shape[i] + 1)
-                        _bins[i].push_back(_bins[i].back() + delta);
-                }
+                while (_bins[i].size() < bin[i] + 2)
+                    _bins[i].push_back(_bins[i].back() + delta);
             }
             else // arbitrary bins widths. do a binary search
             {
@@ -137,35 +129,177 @@ public:
                 auto iter = upper_bound(bins.begin(), bins.end(), v[i]);
                 if (iter == bins.end())
                 {
-                    return;  // falls off from last bin, do not count
+                    return false;  // falls off from last bin, do not count
                 }
                 else
                 {
                     bin[i] = iter - bins.begin();
                     if (bin[i] == 0)
-                        return; // falls off from fist bin, do not count
+                        return false; // falls off from fist bin, do not count
                     else
                        --bin[i];
                 }
             }
         }
-        _counts(bin) += weight;
+        return true;
     }
 
-    boost::multi_array<CountType,Dim>& get_array() { return _counts; }
-
     std::array<std::pair<ValueType,ValueType>,Dim>& get_data_range()
     { return _data_range; }
 
     std::array<std::vector<ValueType>, Dim>& get_bins() { return _bins; }
 
 protected:
-    boost::multi_array<CountType,Dim> _counts;
     std::array<std::vector<ValueType>, Dim> _bins;
     std::array<std::pair<ValueType,ValueType>,Dim> _data_range;
     std::array<bool,Dim> _const_width;
+    std::array<ValueType,Dim> _delta;
+};
+
+//
+// This is a generic multidimensional histogram type
+//
+
+template <class ValueType, class CountType, size_t Dim>
+class Histogram: public HistogramBins<ValueType, Dim>
+{
+public:
+    typedef HistogramBins<ValueType, Dim> base_t;
+    typedef typename base_t::point_t point_t;
+    typedef typename base_t::bin_t bin_t;
+
+    typedef boost::multi_array<CountType,Dim> count_t; // the histogram itself
+
+    typedef boost::mpl::int_<Dim> dim;
+    typedef CountType count_type;
+    typedef ValueType value_type;
+
+    // floating point type to calculate the mean
+    typedef typename boost::mpl::if_<boost::is_floating_point<ValueType>,
+                                     ValueType, double>::type mean_t;
+
+    Histogram(const std::array<std::vector<ValueType>, Dim>& bins)
+        : base_t(bins)
+    {
+        bin_t new_shape;
+        for (size_t j = 0; j < Dim; ++j)
+            new_shape[j] = this->_bins[j].size() - 1;
+        _counts.resize(new_shape);
+    }
+
+    void put_value(const point_t& v, const CountType& weight = 1)
+    {
+        bin_t bin;
+        if (!this->get_bin(v, bin))
+            return;
+        grow(bin);
+        _counts(bin) += weight;
+    }
+
+    // makes sure the given bin is within the shape of the histogram
+    void grow(const bin_t& bin)
+    {
+        bin_t new_shape;
+        bool resize = false;
+        for (size_t j = 0; j < Dim; ++j)
+        {
+            new_shape[j] = _counts.shape()[j];
+            if (bin[j] >= new_shape[j])
+            {
+                new_shape[j] = bin[j] + 1;
+                resize = true;
+            }
+        }
+        if (resize)
+            _counts.resize(new_shape);
+    }
+
+    boost::multi_array<CountType,Dim>& get_array() { return _counts; }
+
+protected:
+    boost::multi_array<CountType,Dim> _counts;
 };
 
+//
+// This is a histogram with the same bins, which stores only the counts of the
+// occupied bins, so that its memory usage does not depend on the total number
+// of bins, which can be very large for broad distributions.
+//
+
+template <class ValueType, class CountType, size_t Dim>
+class SparseHistogram: public HistogramBins<ValueType, Dim>
+{
+public:
+    typedef HistogramBins<ValueType, Dim> base_t;
+    typedef typename base_t::point_t point_t;
+    typedef typename base_t::bin_t bin_t;
+
+    typedef CountType count_type;
+    typedef ValueType value_type;
+
+    SparseHistogram(const std::array<std::vector<ValueType>, Dim>& bins)
+        : base_t(bins) {}
+
+    // uses the same bins as an existing histogram
+    explicit SparseHistogram(const base_t& bins)
+        : base_t(bins) {}
+
+    void put_value(const point_t& v, const CountType& weight = 1)
+    {
+        bin_t bin;
+        if (!this->get_bin(v, bin))
+            return;
+        _counts[bin] += weight;
+    }
+
+    // adds the counts of another histogram with the same bins
+    void merge(const SparseHistogram& h)
+    {
+        for (auto& bc : h._counts)
+            _counts[bc.first] += bc.second;
+        for (size_t j = 0; j < Dim; ++j)
+        {
+            if (this->_bins[j].size() < h._bins[j].size())
+                this->_bins[j] = h._bins[j];
+        }
+    }
+
+    // adds the counts to a dense histogram with the same bins
+    template <class Histogram>
+    void add_to(Histogram& hist) const
+    {
+        bin_t max_bin = {};
+        for (auto& bc : _counts)
+            for (size_t j = 0; j < Dim; ++j)
+                max_bin[j] = std::max(max_bin[j], bc.first[j]);
+        if (!_counts.empty())
+            hist.grow(max_bin);
+        auto& counts = hist.get_array();
+        for (auto& bc : _counts)
+            counts(bc.first) += bc.second;
+        for (size_t j = 0; j < Dim; ++j)
+        {
+            if (hist.get_bins()[j].size() < this->_bins[j].size())
+                hist.get_bins()[j] = this->_bins[j];
+        }
+    }
+
+    size_t size() const { return _counts.size(); }
+
+    void clear() { _counts = map_t(); }
+
+private:
+    struct bin_hash
+    {
+        size_t operator()(const bin_t& bin) const
+        {
+            return boost::hash_range(bin.begin(), bin.end());
+        }
+    };
+
+    typedef gt_hash_map<bin_t, CountType, bin_hash> map_t;
+    map_t _counts;
+};
 
 // This class will encapsulate a histogram, and atomically sum it to a given
 // resulting histogram (which is shared among all copies) after it is
@@ -221,6 +355,68 @@ private:
 };
 
 
+// This class will hold thread-local sparse copies of a histogram, and sum them
+// to it in a tree reduction when the gather() member function is called, so
+// that the memory used during the parallel accumulation is proportional to the
+// number of occupied bins. The local() member function returns the copy of the
+// calling thread.
+
+template <class Histogram>
+class SharedSparseHistogram
+{
+public:
+    typedef SparseHistogram<typename Histogram::value_type,
+                            typename Histogram::count_type,
+                            Histogram::dim::value> sparse_t;
+
+    SharedSparseHistogram(Histogram& hist)
+        : _sum(&hist)
+    {
+        size_t nthreads = 1;
+#ifdef _OPENMP
+        nthreads = omp_get_max_threads();
+#endif
+        _hists.resize(nthreads, sparse_t(hist));
+    }
+
+    ~SharedSparseHistogram()
+    {
+        gather();
+    }
+
+    sparse_t& local()
+    {
+        size_t tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        return _hists[tid];
+    }
+
+    void gather()
+    {
+        if (_sum == nullptr)
+            return;
+        size_t n = _hists.size();
+        for (size_t s = 1; s < n; s *= 2)
+        {
+            #pragma omp parallel for schedule(static) if (n > 2 * s)
+            for (size_t i = 0; i < n - s; i += 2 * s)
+            {
+                _hists[i].merge(_hists[i + s]);
+                _hists[i + s].clear();
+            }
+        }
+        _hists[0].add_to(*_sum);
+        _hists.clear();
+        _sum = nullptr;
+    }
+
+private:
+    Histogram* _sum;
+    std::vector<sparse_t> _hists;
+};
+
 //
 // useful functions to get the the mean and standard deviations from simple
 // map-based, non-binned histograms. Not to be used with the above type.
@@ -0,0 +1,72 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "graph.hh"
+#include "graph_filtering.hh"
+#include "graph_properties.hh"
+#include "graph_selectors.hh"
+
+#include "graph_profile.hh"
+
+#include <boost/python.hpp>
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+// this will return a dictionary with the requested vertex, edge and
+// correlation statistics, computed in a single pass
+python::object
+get_graph_profile(GraphInterface& gi, GraphInterface::deg_t deg,
+                  boost::any prop, unsigned int stats,
+                  const vector<long double>& vbins,
+                  const vector<long double>& ebins,
+                  const vector<long double>& xbins,
+                  const vector<long double>& ybins)
+{
+    typedef DynamicPropertyMapWrap<double, GraphInterface::edge_t> eprop_t;
+    eprop_t eprop;
+    if (stats & (PROFILE_EDGE_HIST | PROFILE_EDGE_AVERAGE))
+    {
+        if (!belongs<edge_scalar_properties>()(prop))
+            throw ValueException("Edge property must be of scalar type.");
+        eprop = eprop_t(prop, edge_scalar_properties());
+    }
+
+    std::array<vector<long double>, 2> cbins;
+    cbins[0] = xbins;
+    cbins[1] = ybins;
+
+    python::dict ret;
+    run_action<>()
+        (gi,
+         [&](auto&& graph, auto&& d)
+         {
+             get_profile(stats, vbins, ebins, cbins, ret)
+                 (std::forward<decltype(graph)>(graph),
+                  std::forward<decltype(d)>(d), eprop);
+         },
+         scalar_selectors())(degree_selector(deg));
+    return ret;
+}
+
+using namespace boost::python;
+
+void export_profile()
+{
+    def("get_graph_profile", &get_graph_profile);
+}
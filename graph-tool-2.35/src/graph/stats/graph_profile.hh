@@ -0,0 +1,326 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_PROFILE_HH
+#define GRAPH_PROFILE_HH
+
+#include <boost/python/dict.hpp>
+#include "graph_util.hh"
+#include "hash_map_wrap.hh"
+#include "shared_map.hh"
+#include "histogram.hh"
+#include "numpy_bind.hh"
+#include "../correlations/graph_correlations.hh"
+#include "../correlations/graph_assortativity.hh"
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// statistics computed by get_profile(), in the same order as in
+// graph_tool.stats.graph_profile()
+enum profile_stat
+{
+    PROFILE_VERTEX_HIST = 1 << 0,
+    PROFILE_VERTEX_AVERAGE = 1 << 1,
+    PROFILE_EDGE_HIST = 1 << 2,
+    PROFILE_EDGE_AVERAGE = 1 << 3,
+    PROFILE_ASSORTATIVITY = 1 << 4,
+    PROFILE_SCALAR_ASSORTATIVITY = 1 << 5,
+    PROFILE_CORR_HIST = 1 << 6
+};
+
+// Computes the requested statistics of the vertex values given by 'deg' and of
+// the edge property 'eprop', in a single parallel pass over the vertices and
+// their out-edges, with thread-local accumulators. The out-edges are those of
+// the underlying directed graph, so that every edge is visited only once.
+//
+// The assortativity coefficients and the correlation histogram depend on the
+// values at both endpoints of the edges, taken in both directions for
+// undirected graphs. For integer values, they are all obtained from the joint
+// histogram given by get_deg_pair_hist(). Otherwise, the marginal counts of the
+// assortativity, the moments of the scalar assortativity and the correlation
+// histogram are accumulated during the pass, and the jackknife variances of
+// the coefficients take another pass over the edges, as in
+// get_assortativity_coefficient() and get_scalar_assortativity_coefficient().
+// No edge weights are used.
+struct get_profile
+{
+    get_profile(unsigned int stats, const vector<long double>& vbins,
+                const vector<long double>& ebins,
+                const std::array<vector<long double>, 2>& cbins,
+                python::dict& ret)
+        : _stats(stats), _vbins(vbins), _ebins(ebins), _cbins(cbins),
+          _ret(ret) {}
+
+    template <class Graph, class DegreeSelector, class EdgeProperty>
+    void operator()(const Graph& g, DegreeSelector deg,
+                    EdgeProperty eprop) const
+    {
+        typedef typename DegreeSelector::value_type val_t;
+        typedef Histogram<val_t, size_t, 1> vhist_t;
+        typedef Histogram<double, size_t, 1> ehist_t;
+        typedef Histogram<val_t, size_t, 2> chist_t;
+        typedef gt_hash_map<val_t, size_t> map_t;
+
+        bool vhist = _stats & PROFILE_VERTEX_HIST;
+        bool vavg = _stats & PROFILE_VERTEX_AVERAGE;
+        bool ehist = _stats & PROFILE_EDGE_HIST;
+        bool eavg = _stats & PROFILE_EDGE_AVERAGE;
+        bool assort = _stats & PROFILE_ASSORTATIVITY;
+        bool sassort = _stats & PROFILE_SCALAR_ASSORTATIVITY;
+        bool corr = _stats & PROFILE_CORR_HIST;
+        bool directed = graph_tool::is_directed(g);
+
+        vector<std::array<size_t, 3>> hist;
+        val_t k_min = val_t();
+        size_t K = 0;
+        bool dense = ((assort || sassort || corr) &&
+                      get_deg_pair_hist(g, deg, hist, k_min, K));
+        bool marginals = assort && !dense;
+        bool moments = sassort && !dense;
+        bool chist = corr && !dense;
+        bool pairs = marginals || moments || chist;
+        bool edges = ehist || eavg || pairs;
+
+        std::array<vector<val_t>, 1> vbins;
+        clean_bins(_vbins, vbins[0]);
+        std::array<vector<double>, 1> ebins;
+        clean_bins(_ebins, ebins[0]);
+        std::array<vector<val_t>, 2> cbins;
+        for (size_t i = 0; i < cbins.size(); ++i)
+            clean_bins(_cbins[i], cbins[i]);
+
+        vhist_t v_hist(vbins);
+        ehist_t e_hist(ebins);
+        chist_t c_hist(cbins);
+        long double v_a = 0, v_aa = 0, e_a = 0, e_aa = 0;
+        size_t v_count = 0, e_count = 0;
+        size_t n_edges = 0, e_kk = 0;
+        map_t a, b;
+        edge_moments m;
+
+        auto&& u = get_dir(g, typename is_directed_::apply<Graph>::type());
+
+        {
+            SharedSparseHistogram<vhist_t> s_vhist(v_hist);
+            SharedSparseHistogram<ehist_t> s_ehist(e_hist);
+            SharedSparseHistogram<chist_t> s_chist(c_hist);
+
+            #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
+                reduction(+:v_a, v_aa, v_count, e_a, e_aa, e_count, n_edges, \
+                          e_kk)
+            {
+                auto& l_vhist = s_vhist.local();
+                auto& l_ehist = s_ehist.local();
+                auto& l_chist = s_chist.local();
+                SharedMap<map_t> l_a(a), l_b(b);
+                edge_moments l_m;
+
+                auto put_pair = [&](const val_t& k1, const val_t& k2)
+                    {
+                        if (marginals)
+                        {
+                            ++l_a[k1];
+                            ++l_b[k2];
+                            if (k1 == k2)
+                                ++e_kk;
+                            ++n_edges;
+                        }
+                        if (moments)
+                            l_m.put(k1, k2, 1);
+                        if (chist)
+                            l_chist.put_value({k1, k2});
+                    };
+
+                parallel_vertex_loop_no_spawn
+                    (g,
+                     [&](auto v)
+                     {
+                         val_t k1 = deg(v, g);
+                         if (vhist)
+                             l_vhist.put_value({k1});
+                         if (vavg)
+                         {
+                             long double x = k1;
+                             v_a += x;
+                             v_aa += x * x;
+                             ++v_count;
+                         }
+                         if (!edges)
+                             return;
+                         for (auto e : out_edges_range(v, u))
+                         {
+                             if (ehist || eavg)
+                             {
+                                 double x = get(eprop, e);
+                                 if (ehist)
+                                     l_ehist.put_value({x});
+                                 if (eavg)
+                                 {
+                                     long double y = x;
+                                     e_a += y;
+                                     e_aa += y * y;
+                                     ++e_count;
+                                 }
+                             }
+                             if (!pairs)
+                                 continue;
+                             val_t k2 = deg(target(e, u), g);
+                             put_pair(k1, k2);
+                             if (!directed)
+                                 put_pair(k2, k1);
+                         }
+                     });
+
+                if (moments)
+                {
+                    #pragma omp critical (profile_moments)
+                    m.merge(l_m);
+                }
+            }
+        }
+
+        if (vhist)
+            _ret["vertex_hist"] =
+                python::make_tuple(wrap_multi_array_owned(v_hist.get_array()),
+                                   wrap_vector_owned(v_hist.get_bins()[0]));
+        if (vavg)
+            _ret["vertex_average"] = python::make_tuple(v_a, v_aa, v_count);
+        if (ehist)
+            _ret["edge_hist"] =
+                python::make_tuple(wrap_multi_array_owned(e_hist.get_array()),
+                                   wrap_vector_owned(e_hist.get_bins()[0]));
+        if (eavg)
+            _ret["edge_average"] = python::make_tuple(e_a, e_aa, e_count);
+
+        if (assort)
+        {
+            double r, r_err;
+            if (dense)
+            {
+                get_hist_assortativity(hist, K, directed, r, r_err);
+            }
+            else
+            {
+                auto get = [](const map_t& m, const val_t& k) -> double
+                    {
+                        auto iter = m.find(k);
+                        return (iter != m.end()) ? iter->second : 0;
+                    };
+
+                double t2 = 0;
+                for (auto& [k, n] : a)
+                    t2 += double(n) * get(b, k);
+
+                assortativity_from_marginals
+                    (n_edges, e_kk, t2, directed,
+                     [&](auto& dev)
+                     {
+                         double err = 0;
+                         #pragma omp parallel \
+                             if (num_vertices(g) > OPENMP_MIN_THRESH) \
+                             reduction(+:err)
+                         parallel_vertex_loop_no_spawn
+                             (g,
+                              [&](auto v)
+                              {
+                                  val_t k1 = deg(v, g);
+                                  double a_k1 = get(a, k1);
+                                  double b_k1 = get(b, k1);
+                                  for (auto w : out_neighbors_range(v, u))
+                                  {
+                                      val_t k2 = deg(w, g);
+                                      err += dev(1, b_k1, get(a, k2),
+                                                 k1 == k2);
+                                      if (!directed)
+                                          err += dev(1, get(b, k2), a_k1,
+                                                     k1 == k2);
+                                  }
+                              });
+                         return err;
+                     }, r, r_err);
+            }
+            _ret["assortativity"] = python::make_tuple(r, r_err);
+        }
+
+        if (sassort)
+        {
+            double r, r_err;
+            if (dense)
+            {
+                get_hist_scalar_assortativity
+                    (hist, [&](size_t i) { return double(k_min) + i; },
+                     directed, r, r_err);
+            }
+            else
+            {
+                scalar_assortativity_from_moments
+                    (m, directed,
+                     [&](auto& dev)
+                     {
+                         double err = 0;
+                         #pragma omp parallel \
+                             if (num_vertices(g) > OPENMP_MIN_THRESH) \
+                             reduction(+:err)
+                         parallel_vertex_loop_no_spawn
+                             (g,
+                              [&](auto v)
+                              {
+                                  double k1 = deg(v, g);
+                                  for (auto w : out_neighbors_range(v, u))
+                                  {
+                                      double k2 = deg(w, g);
+                                      err += dev(k1, k2, 1);
+                                      if (!directed)
+                                          err += dev(k2, k1, 1);
+                                  }
+                              });
+                         return err;
+                     }, r, r_err);
+            }
+            _ret["scalar_assortativity"] = python::make_tuple(r, r_err);
+        }
+
+        if (corr)
+        {
+            if (dense)
+            {
+                for (auto& [i, j, n] : hist)
+                    c_hist.put_value({val_t(k_min + i), val_t(k_min + j)}, n);
+            }
+            cbins = c_hist.get_bins();
+            python::list ret_bins;
+            ret_bins.append(wrap_vector_owned(cbins[0]));
+            ret_bins.append(wrap_vector_owned(cbins[1]));
+            _ret["corr_hist"] =
+                python::make_tuple(wrap_multi_array_owned(c_hist.get_array()),
+                                   ret_bins);
+        }
+    }
+
+    unsigned int _stats;
+    const vector<long double>& _vbins;
+    const vector<long double>& _ebins;
+    const std::array<vector<long double>, 2>& _cbins;
+    python::dict& _ret;
+};
+
+} // graph_tool namespace
+
+#endif // GRAPH_PROFILE_HH
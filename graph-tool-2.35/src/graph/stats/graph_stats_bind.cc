@@ -22,6 +22,7 @@ using namespace boost;
 void export_parallel();
 void export_histograms();
 void export_average();
+void export_profile();
 void export_distance();
 void export_sampled_distance();
 
@@ -31,6 +32,7 @@ BOOST_PYTHON_MODULE(libgraph_tool_stats)
     export_parallel();
     export_histograms();
     export_average();
+    export_profile();
     export_distance();
     export_sampled_distance();
 }
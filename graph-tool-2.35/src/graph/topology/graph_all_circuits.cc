@@ -22,19 +22,25 @@
 #include "coroutine.hh"
 #include "graph_python_interface.hh"
 
+#include "graph_all_circuits.hh"
+
 using namespace std;
 using namespace graph_tool;
 
 template <class Yield>
 struct CircuitVisitor
 {
-    CircuitVisitor(Yield& yield)
-        : _yield(yield) {}
+    CircuitVisitor(Yield& yield, bool unique)
+        : _yield(yield), _unique(unique) {}
     Yield& _yield;
+    bool _unique;
 
     template <class Vs, class Graph>
     void cycle(const Vs& vs, Graph&)
     {
+        // hawick_unique_circuits() still reports self-loops
+        if (_unique && vs.size() == 1)
+            return;
         auto c = wrap_vector_owned(vs);
         _yield(c);
     }
@@ -50,7 +56,7 @@ boost::python::object get_all_circuits(GraphInterface& gi, bool unique)
                 (gi,
                  [&](auto& g)
                  {
-                     CircuitVisitor<decltype(yield)> visitor(yield);
+                     CircuitVisitor<decltype(yield)> visitor(yield, unique);
                      if (unique)
                          hawick_unique_circuits(g, visitor);
                      else
@@ -63,8 +69,104 @@ boost::python::object get_all_circuits(GraphInterface& gi, bool unique)
 #endif // HAVE_BOOST_COROUTINE
 }
 
+// Returns either the number of circuits of each length, if count_only ==
+// true, or the circuits concatenated in a flat array, together with the
+// offsets of each circuit in it. The circuits are grouped by their vertex of
+// smallest index, in increasing order, so that the output does not depend on
+// the number of threads.
+boost::python::object get_bounded_circuits(GraphInterface& gi, size_t max_len,
+                                           bool unique, bool count_only,
+                                           bool generator)
+{
+    if (generator)
+    {
+#ifdef HAVE_BOOST_COROUTINE
+        auto dispatch = [&](auto& yield)
+            {
+                run_action<>()
+                    (gi,
+                     [&](auto& g)
+                     {
+                         bounded_circuits(g, max_len, unique, false,
+                                          [&](size_t, size_t, auto& path)
+                                          {
+                                              yield(wrap_vector_owned(path));
+                                              return true;
+                                          });
+                     })();
+            };
+        return boost::python::object(CoroGenerator(dispatch));
+#else
+        throw GraphException("This functionality is not available because boost::coroutine was not found at compile-time");
+#endif // HAVE_BOOST_COROUTINE
+    }
+
+    std::vector<size_t> hist, flat, offsets;
+    run_action<>()
+        (gi,
+         [&](auto& g)
+         {
+             size_t nthreads = 1;
+#ifdef _OPENMP
+             nthreads = omp_get_max_threads();
+#endif
+             std::vector<std::vector<size_t>> thist(nthreads), tflat(nthreads);
+             // (root, position, thread, length) of each circuit
+             std::vector<std::vector<std::array<size_t, 4>>> trecs(nthreads);
+
+             bounded_circuits(g, max_len, unique, true,
+                              [&](size_t tid, size_t s, auto& path)
+                              {
+                                  auto& h = thist[tid];
+                                  if (h.size() <= path.size())
+                                      h.resize(path.size() + 1);
+                                  h[path.size()]++;
+                                  if (!count_only)
+                                  {
+                                      auto& f = tflat[tid];
+                                      trecs[tid].push_back({s, f.size(), tid,
+                                                            path.size()});
+                                      f.insert(f.end(), path.begin(),
+                                               path.end());
+                                  }
+                                  return true;
+                              });
+
+             if (max_len > 0)
+                 hist.resize(max_len + 1);
+             for (auto& h : thist)
+             {
+                 if (hist.size() < h.size())
+                     hist.resize(h.size());
+                 for (size_t l = 0; l < h.size(); ++l)
+                     hist[l] += h[l];
+             }
+             if (count_only)
+                 return;
+
+             std::vector<std::array<size_t, 4>> recs;
+             for (auto& r : trecs)
+                 recs.insert(recs.end(), r.begin(), r.end());
+             std::sort(recs.begin(), recs.end());
+             offsets.reserve(recs.size() + 1);
+             offsets.push_back(0);
+             for (auto& r : recs)
+             {
+                 auto& f = tflat[r[2]];
+                 flat.insert(flat.end(), f.begin() + r[1],
+                             f.begin() + r[1] + r[3]);
+                 offsets.push_back(flat.size());
+             }
+         })();
+
+    if (count_only)
+        return wrap_vector_owned(hist);
+    return boost::python::make_tuple(wrap_vector_owned(flat),
+                                     wrap_vector_owned(offsets));
+}
 
 void export_all_circuits()
 {
     boost::python::def("get_all_circuits", &get_all_circuits);
+    boost::python::def("get_bounded_circuits", &get_bounded_circuits);
 };
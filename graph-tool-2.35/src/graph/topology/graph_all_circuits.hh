@@ -0,0 +1,261 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_ALL_CIRCUITS_HH
+#define GRAPH_ALL_CIRCUITS_HH
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+namespace graph_tool
+{
+
+using namespace boost;
+
+// Enumeration of the circuits of a directed graph with at most max_len edges
+// (or all of them, if max_len == 0).
+//
+// As in Johnson's and Read-Tarjan's algorithms, every circuit is found exactly
+// once, from its vertex s of smallest index, by a depth-first search of simple
+// paths starting at s that only visit vertices of index larger than s, and
+// from which s can be reached, as determined by a breadth-first search over
+// the reversed edges restricted to the same vertices.
+//
+// If max_len == 0, the search uses Johnson's blocking: a vertex stays blocked
+// after it is left without having closed a circuit, until one of its
+// successors is unblocked, so that the search takes O(V + E) time between
+// consecutive circuits. Since this is not valid if the length is bounded,
+// otherwise the search is instead pruned with the distances back to s given by
+// the breadth-first search: a path ending in w with l edges is only extended
+// if l + dist(w, s) <= max_len. Hence the search never enters a vertex from
+// which s cannot be reached in time, and its cost only depends on the
+// neighborhood of radius max_len around s.
+//
+// Self-loops give rise to circuits of length one, and parallel edges to
+// distinct circuits with the same vertices, unless unique == true, in which
+// case self-loops are ignored and parallel edges are traversed only once.
+//
+// The search is split at the root vertex s, which are distributed dynamically
+// among the threads. The function f(tid, s, path) is called for every circuit
+// found, where path contains its vertices in order, starting at s. If f
+// returns false, the whole search is stopped.
+template <class Graph, class F>
+void bounded_circuits(Graph& g, size_t max_len, bool unique, bool parallel,
+                      F&& f)
+{
+    constexpr size_t null = std::numeric_limits<size_t>::max();
+    size_t N = num_vertices(g);
+    bool blocking = (max_len == 0);
+    if (max_len == 0)
+        max_len = null;
+
+    // compact adjacency, in both directions
+    std::vector<size_t> opos(N + 1), ipos(N + 1), out, in;
+    for (auto v : vertices_range(g))
+    {
+        auto& os = opos[v + 1];
+        for (auto w : out_neighbors_range(v, g))
+        {
+            if (unique && size_t(w) == size_t(v))
+                continue;
+            out.push_back(w);
+            ++os;
+        }
+        auto begin = out.end() - os;
+        std::sort(begin, out.end());
+        if (unique)
+        {
+            auto end = std::unique(begin, out.end());
+            os = end - begin;
+            out.erase(end, out.end());
+        }
+    }
+    for (size_t v = 0; v < N; ++v)
+        opos[v + 1] += opos[v];
+    in.resize(out.size());
+    for (auto w : out)
+        ++ipos[w + 1];
+    for (size_t v = 0; v < N; ++v)
+        ipos[v + 1] += ipos[v];
+    {
+        std::vector<size_t> pos(ipos.begin(), ipos.end() - 1);
+        for (size_t v = 0; v < N; ++v)
+        {
+            for (size_t i = opos[v]; i < opos[v + 1]; ++i)
+                in[pos[out[i]]++] = v;
+        }
+    }
+
+    bool stop = false;
+
+    #pragma omp parallel if (parallel && N > OPENMP_MIN_THRESH)
+    {
+        size_t tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        std::vector<size_t> dist(N), mark(N, null);
+        std::vector<uint8_t> onpath(N);
+        std::vector<size_t> reach, path;
+        std::vector<size_t> iter;  // next out-edge of each vertex in the path
+
+        // with Johnson's blocking, onpath also marks the blocked vertices, and
+        // blist[v] holds the blocked vertices to be unblocked together with v
+        std::vector<uint8_t> found;  // whether a path vertex closed a circuit
+        std::vector<std::vector<size_t>> blist(blocking ? N : 0);
+        std::vector<size_t> unblock;
+
+        auto get_stop = [&]()
+            {
+                bool s;
+                #pragma omp atomic read
+                s = stop;
+                return s;
+            };
+
+        #pragma omp for schedule(dynamic, 1)
+        for (size_t s = 0; s < N; ++s)
+        {
+            if (get_stop() || opos[s] == opos[s + 1])
+                continue;
+
+            // vertices that reach s, and their distances to it, up to
+            // max_len - 1
+            mark[s] = s;
+            dist[s] = 0;
+            reach.clear();
+            reach.push_back(s);
+            size_t begin = 0;
+            for (size_t d = 1; d < max_len && begin < reach.size(); ++d)
+            {
+                size_t end = reach.size();
+                for (size_t j = begin; j < end; ++j)
+                {
+                    auto v = reach[j];
+                    for (size_t i = ipos[v]; i < ipos[v + 1]; ++i)
+                    {
+                        auto u = in[i];
+                        if (u <= s || mark[u] == s)
+                            continue;
+                        mark[u] = s;
+                        dist[u] = d;
+                        reach.push_back(u);
+                    }
+                }
+                begin = end;
+            }
+
+            path.clear();
+            iter.clear();
+            found.clear();
+            path.push_back(s);
+            iter.push_back(opos[s]);
+            found.push_back(false);
+            onpath[s] = true;
+            while (!path.empty())
+            {
+                auto v = path.back();
+                auto& i = iter.back();
+                if (i == opos[v + 1])
+                {
+                    bool closed = found.back();
+                    onpath[v] = false;
+                    path.pop_back();
+                    iter.pop_back();
+                    found.pop_back();
+                    if (!blocking)
+                        continue;
+                    if (closed)
+                    {
+                        // unblock v, and recursively the vertices waiting on it
+                        unblock.push_back(v);
+                        while (!unblock.empty())
+                        {
+                            auto u = unblock.back();
+                            unblock.pop_back();
+                            for (auto w : blist[u])
+                            {
+                                if (!onpath[w])
+                                    continue;
+                                onpath[w] = false;
+                                unblock.push_back(w);
+                            }
+                            blist[u].clear();
+                        }
+                        if (!found.empty())
+                            found.back() = true;
+                    }
+                    else
+                    {
+                        // v remains blocked until one of its successors is
+                        // unblocked
+                        onpath[v] = true;
+                        for (size_t j = opos[v]; j < opos[v + 1]; ++j)
+                        {
+                            auto w = out[j];
+                            if (w <= s || mark[w] != s)
+                                continue;
+                            auto& b = blist[w];
+                            if (std::find(b.begin(), b.end(), v) == b.end())
+                                b.push_back(v);
+                        }
+                    }
+                    continue;
+                }
+                auto w = out[i++];
+                if (w == s)
+                {
+                    found.back() = true;
+                    if (!f(tid, s, path))
+                    {
+                        #pragma omp atomic write
+                        stop = true;
+                    }
+                    if (get_stop())
+                        break;
+                    continue;
+                }
+                if (w < s || mark[w] != s || onpath[w] ||
+                    path.size() + dist[w] > max_len)
+                    continue;
+                path.push_back(w);
+                iter.push_back(opos[w]);
+                found.push_back(false);
+                onpath[w] = true;
+            }
+            for (auto v : path)
+                onpath[v] = false;
+            if (blocking)
+            {
+                for (auto v : reach)
+                {
+                    onpath[v] = false;
+                    blist[v].clear();
+                }
+            }
+        }
+    }
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_ALL_CIRCUITS_HH
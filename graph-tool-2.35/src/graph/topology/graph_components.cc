@@ -30,13 +30,18 @@ using namespace std;
 using namespace boost;
 using namespace graph_tool;
 
-python::object do_label_components(GraphInterface& gi, boost::any prop)
+python::object do_label_components(GraphInterface& gi, boost::any prop,
+                                   bool parallel)
 {
     vector<size_t> hist;
     run_action<graph_tool::all_graph_views, mpl::true_>()
         (gi,
          [&](auto&& graph, auto&& a2)
          {
+             if (parallel)
+                 return label_components()
+                     (graph, a2.get_unchecked(num_vertices(graph)), hist,
+                      true);
              return label_components()
                  (std::forward<decltype(graph)>(graph),
                   std::forward<decltype(a2)>(a2), hist);
@@ -47,7 +52,7 @@ python::object do_label_components(GraphInterface& gi, boost::any prop)
 
 python::object
 do_label_biconnected_components(GraphInterface& gi, boost::any comp,
-                                boost::any art)
+                                boost::any art, bool parallel)
 {
     vector<size_t> hist;
     run_action<graph_tool::detail::never_directed>()
@@ -55,9 +60,9 @@ do_label_biconnected_components(GraphInterface& gi, boost::any comp,
          [&](auto&& graph, auto&& a2, auto&& a3)
          {
              return label_biconnected_components()
-                 (std::forward<decltype(graph)>(graph),
+                 (std::forward<decltype(graph)>(graph), gi.get_edge_index(),
                   std::forward<decltype(a2)>(a2),
-                  std::forward<decltype(a3)>(a3), hist);
+                  std::forward<decltype(a3)>(a3), hist, parallel);
          },
          writable_edge_scalar_properties(),
          writable_vertex_scalar_properties())(comp, art);
@@ -22,6 +22,10 @@
 #include <boost/graph/strong_components.hpp>
 #include <boost/graph/biconnected_components.hpp>
 
+#include <atomic>
+
+#include "hash_map_wrap.hh"
+
 namespace graph_tool
 {
 template <class PropertyMap>
@@ -96,6 +100,405 @@ void put(HistogramPropertyMap<PropertyMap> pmap,
 }
 
 
+// Concurrent disjoint-set forest. The union operation always hooks the root
+// with the larger index onto the one with the smaller index via
+// compare-and-swap, hence the root of every set is its smallest element, and
+// the result does not depend on the order of the operations. Path halving is
+// used during the lookups.
+class concurrent_union_find
+{
+public:
+    concurrent_union_find(size_t N)
+        : _parent(N)
+    {
+        #pragma omp parallel for if (N > OPENMP_MIN_THRESH) schedule(runtime)
+        for (size_t v = 0; v < N; ++v)
+            _parent[v].store(v, std::memory_order_relaxed);
+    }
+
+    size_t find(size_t v)
+    {
+        while (true)
+        {
+            size_t p = _parent[v].load(std::memory_order_relaxed);
+            size_t gp = _parent[p].load(std::memory_order_relaxed);
+            if (p == gp)
+                return p;
+            _parent[v].compare_exchange_weak(p, gp,
+                                             std::memory_order_relaxed);
+            v = gp;
+        }
+    }
+
+    void link(size_t u, size_t v)
+    {
+        while (true)
+        {
+            u = find(u);
+            v = find(v);
+            if (u == v)
+                return;
+            if (u < v)
+                std::swap(u, v);
+            size_t r = u;
+            if (_parent[u].compare_exchange_strong(r, v))
+                return;
+        }
+    }
+
+    // Points v directly to its root; should not be called concurrently with
+    // link().
+    size_t compress(size_t v)
+    {
+        size_t r = find(v);
+        _parent[v].store(r, std::memory_order_relaxed);
+        return r;
+    }
+
+    size_t size() { return _parent.size(); }
+
+private:
+    vector<std::atomic<size_t>> _parent;
+};
+
+// Parallel level-synchronous BFS from `source`, which marks the reached
+// vertices (traversing the edges in the opposite direction if `reversed` is
+// true). Only the vertices for which `valid(v)` is true are traversed.
+template <bool reversed, class Graph, class Mark, class Valid>
+void parallel_bfs_mark(const Graph& g, size_t source, Mark& mark,
+                       Valid&& valid)
+{
+    vector<size_t> frontier = {source}, next;
+    mark[source] = true;
+    while (!frontier.empty())
+    {
+        next.clear();
+        #pragma omp parallel if (frontier.size() > OPENMP_MIN_THRESH)
+        {
+            vector<size_t> local;
+            #pragma omp for schedule(runtime) nowait
+            for (size_t i = 0; i < frontier.size(); ++i)
+            {
+                auto visit = [&](auto u)
+                    {
+                        if (!valid(u))
+                            return;
+                        uint8_t old;
+                        #pragma omp atomic capture
+                        { old = mark[u]; mark[u] = true; }
+                        if (!old)
+                            local.push_back(u);
+                    };
+                auto v = frontier[i];
+                if constexpr (reversed)
+                {
+                    for (auto u : in_or_out_neighbors_range(v, g))
+                        visit(u);
+                }
+                else
+                {
+                    for (auto u : out_neighbors_range(v, g))
+                        visit(u);
+                }
+            }
+
+            #pragma omp critical (bfs_merge)
+            next.insert(next.end(), local.begin(), local.end());
+        }
+        frontier.swap(next);
+    }
+}
+
+// Writes to comp_map the rank of each vertex's representative, where the
+// representatives are ordered according to the smallest vertex index in each
+// component, so that the labels are the same as those obtained with a
+// sequential traversal of the vertices. Returns the number of components.
+template <class Graph, class Rep, class CompMap>
+size_t rank_components(const Graph& g, Rep&& rep, CompMap comp_map,
+                       vector<size_t>& hist)
+{
+    size_t N = num_vertices(g);
+    vector<size_t> label(N, numeric_limits<size_t>::max());
+    size_t c = 0;
+    for (auto v : vertices_range(g))
+    {
+        auto& l = label[rep(v)];
+        if (l == numeric_limits<size_t>::max())
+            l = c++;
+    }
+
+    hist.clear();
+    hist.resize(c);
+    parallel_vertex_loop
+        (g,
+         [&](auto v)
+         {
+             auto l = label[rep(v)];
+             put(comp_map, v, l);
+             #pragma omp atomic
+             hist[l]++;
+         });
+    return c;
+}
+
+// Parallel connected components via the Afforest algorithm (Sutton et al.,
+// 2018). The union-find forest is first built from a small number of
+// neighbors of each vertex, after which the largest component is usually
+// already found. It is identified by sampling, and the vertices that belong
+// to it do not need to process their remaining edges.
+template <class Graph>
+void afforest_components(const Graph& g, concurrent_union_find& uf)
+{
+    constexpr size_t n_rounds = 2;
+
+    size_t N = num_vertices(g);
+
+    for (size_t r = 0; r < n_rounds; ++r)
+    {
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 size_t i = 0;
+                 for (auto u : out_neighbors_range(v, g))
+                 {
+                     if (i++ < r)
+                         continue;
+                     uf.link(v, u);
+                     break;
+                 }
+             });
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 uf.compress(v);
+             });
+    }
+
+    // find the most frequent component among equally spaced samples
+    constexpr size_t n_samples = 1024;
+    gt_hash_map<size_t, size_t> count;
+    size_t c = numeric_limits<size_t>::max();
+    size_t c_count = 0;
+    for (size_t i = 0; i < n_samples; ++i)
+    {
+        auto v = vertex((i * N) / n_samples, g);
+        if (!is_valid_vertex(v, g))
+            continue;
+        auto& k = count[uf.find(v)];
+        if (++k > c_count)
+        {
+            c = uf.find(v);
+            c_count = k;
+        }
+    }
+
+    parallel_vertex_loop
+        (g,
+         [&](auto v)
+         {
+             if (uf.find(v) == c)
+                 return;
+             size_t i = 0;
+             for (auto u : out_neighbors_range(v, g))
+             {
+                 if (i++ < n_rounds)
+                     continue;
+                 uf.link(v, u);
+             }
+         });
+
+    parallel_vertex_loop
+        (g,
+         [&](auto v)
+         {
+             uf.compress(v);
+         });
+}
+
+// Parallel strongly connected components. Vertices without incoming or
+// outgoing edges are first trimmed as trivial components, and a
+// forward-backward search from the vertex with the largest degree product
+// extracts the (typically) giant component. The remaining components are found
+// by the coloring algorithm of Orzan (2004): The largest vertex index is
+// propagated forward until convergence, after which the component of each
+// color root is obtained with a backward search restricted to its color.
+template <class Graph>
+void parallel_strong_components(const Graph& g, vector<size_t>& scc)
+{
+    constexpr size_t null = numeric_limits<size_t>::max();
+    size_t N = num_vertices(g);
+
+    scc.clear();
+    scc.resize(N, null);
+
+    auto active = [&](auto v) { return scc[v] == null; };
+
+    // trimming
+    vector<uint8_t> trim(N);
+    for (size_t iter = 0; iter < 3; ++iter)
+    {
+        size_t ntrim = 0;
+        #pragma omp parallel if (N > OPENMP_MIN_THRESH) reduction(+:ntrim)
+        parallel_vertex_loop_no_spawn
+            (g,
+             [&](auto v)
+             {
+                 trim[v] = false;
+                 if (!active(v))
+                     return;
+                 bool has_in = false, has_out = false;
+                 for (auto u : out_neighbors_range(v, g))
+                 {
+                     if (u != v && active(u))
+                     {
+                         has_out = true;
+                         break;
+                     }
+                 }
+                 for (auto u : in_or_out_neighbors_range(v, g))
+                 {
+                     if (u != v && active(u))
+                     {
+                         has_in = true;
+                         break;
+                     }
+                 }
+                 if (!has_in || !has_out)
+                 {
+                     trim[v] = true;
+                     ntrim++;
+                 }
+             });
+        if (ntrim == 0)
+            break;
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 if (trim[v])
+                     scc[v] = v;
+             });
+    }
+
+    // forward-backward search from the pivot
+    size_t pivot = null;
+    size_t kmax = 0;
+    for (auto v : vertices_range(g))
+    {
+        if (!active(v))
+            continue;
+        size_t k = in_degreeS()(v, g) * out_degree(v, g);
+        if (pivot == null || k > kmax)
+        {
+            pivot = v;
+            kmax = k;
+        }
+    }
+
+    if (pivot != null)
+    {
+        vector<uint8_t> fw(N), bw(N);
+        parallel_bfs_mark<false>(g, pivot, fw, active);
+        parallel_bfs_mark<true>(g, pivot, bw,
+                                [&](auto v) { return fw[v] && active(v); });
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 if (bw[v])
+                     scc[v] = pivot;
+             });
+    }
+
+    // coloring
+    vector<std::atomic<size_t>> color(N);
+    vector<size_t> roots;
+    while (true)
+    {
+        bool empty = true;
+        #pragma omp parallel if (N > OPENMP_MIN_THRESH) reduction(&&:empty)
+        parallel_vertex_loop_no_spawn
+            (g,
+             [&](auto v)
+             {
+                 if (!active(v))
+                     return;
+                 color[v].store(v, std::memory_order_relaxed);
+                 empty = false;
+             });
+        if (empty)
+            break;
+
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            #pragma omp parallel if (N > OPENMP_MIN_THRESH) \
+                reduction(||:changed)
+            parallel_vertex_loop_no_spawn
+                (g,
+                 [&](auto v)
+                 {
+                     if (!active(v))
+                         return;
+                     size_t c = color[v].load(std::memory_order_relaxed);
+                     for (auto u : out_neighbors_range(v, g))
+                     {
+                         if (!active(u))
+                             continue;
+                         size_t cu = color[u].load(std::memory_order_relaxed);
+                         while (cu < c)
+                         {
+                             if (color[u].compare_exchange_weak
+                                 (cu, c, std::memory_order_relaxed))
+                             {
+                                 changed = true;
+                                 break;
+                             }
+                         }
+                     }
+                 });
+        }
+
+        roots.clear();
+        for (auto v : vertices_range(g))
+        {
+            if (active(v) && color[v].load(std::memory_order_relaxed) == v)
+                roots.push_back(v);
+        }
+
+        // the color classes are disjoint, so the backward searches can proceed
+        // independently
+        #pragma omp parallel if (roots.size() > 1)
+        {
+            vector<size_t> queue;
+            #pragma omp for schedule(dynamic)
+            for (size_t i = 0; i < roots.size(); ++i)
+            {
+                size_t r = roots[i];
+                queue.clear();
+                queue.push_back(r);
+                scc[r] = r;
+                while (!queue.empty())
+                {
+                    auto v = queue.back();
+                    queue.pop_back();
+                    for (auto u : in_or_out_neighbors_range(v, g))
+                    {
+                        if (color[u].load(std::memory_order_relaxed) != r ||
+                            scc[u] != null)
+                            continue;
+                        scc[u] = r;
+                        queue.push_back(u);
+                    }
+                }
+            }
+        }
+    }
+}
+
 // this will label the components of a graph to a given vertex property, from
 // [0, number of components - 1], and keep an histogram. If the graph is
 // directed the strong components are used.
@@ -113,6 +516,37 @@ struct label_components
                                                     directed_tag>::type());
     }
 
+    // parallel version; the labels are ordered according to the smallest
+    // vertex index in each component
+    template <class Graph, class CompMap>
+    void operator()(Graph& g, CompMap comp_map, vector<size_t>& hist,
+                    bool parallel) const
+    {
+        typedef typename graph_traits<Graph>::directed_category
+            directed_category;
+        if (!parallel)
+        {
+            (*this)(g, comp_map, hist);
+            return;
+        }
+
+        if constexpr (std::is_convertible<directed_category,
+                                          directed_tag>::value)
+        {
+            vector<size_t> scc;
+            parallel_strong_components(g, scc);
+            rank_components(g, [&](auto v) { return scc[v]; }, comp_map,
+                            hist);
+        }
+        else
+        {
+            concurrent_union_find uf(num_vertices(g));
+            afforest_components(g, uf);
+            rank_components(g, [&](auto v) { return uf.find(v); }, comp_map,
+                            hist);
+        }
+    }
+
     template <class Graph, class CompMap>
     void get_components(Graph& g, CompMap comp_map,
                         std::true_type) const
@@ -159,6 +593,283 @@ struct label_biconnected_components
         biconnected_components(g, cm,
                                vertex_inserter<ArtMap>(art_map));
     }
+
+    // Parallel version, using the algorithm of Tarjan and Vishkin (1985). A
+    // spanning forest is obtained with a parallel BFS, and the preorder
+    // numbers, subtree sizes and the lowest/highest preorder numbers reachable
+    // from each subtree via a non-tree edge are computed level by level. Two
+    // tree edges belong to the same component if they are connected in an
+    // auxiliary graph, which is obtained from the non-tree edges between
+    // unrelated vertices, and from the tree edges whose subtrees reach outside
+    // the subtree of the parent. The connected components of the auxiliary
+    // graph are found with a concurrent union-find, and every non-tree edge
+    // belongs to the component of the tree edge above its lower endpoint.
+    //
+    // The component labels are ordered according to the smallest edge index
+    // in each component.
+    template <class Graph, class EIndex, class CompMap, class ArtMap>
+    void operator()(Graph& g, EIndex eindex, CompMap comp_map, ArtMap art_map,
+                    vector<size_t>& hist, bool parallel) const
+    {
+        if (!parallel)
+        {
+            (*this)(g, comp_map, art_map, hist);
+            return;
+        }
+
+        constexpr size_t null = numeric_limits<size_t>::max();
+        size_t N = num_vertices(g);
+
+        // spanning forest, rooted at the smallest vertex of each component
+        concurrent_union_find cuf(N);
+        afforest_components(g, cuf);
+
+        vector<size_t> parent(N, null), tedge(N, null);
+        vector<uint8_t> claimed(N, false);
+        vector<vector<size_t>> levels(1);
+        for (auto v : vertices_range(g))
+        {
+            if (cuf.find(v) != v)
+                continue;
+            levels[0].push_back(v);
+            parent[v] = v;
+            claimed[v] = true;
+        }
+
+        while (true)
+        {
+            auto& frontier = levels.back();
+            vector<size_t> next;
+            #pragma omp parallel if (frontier.size() > OPENMP_MIN_THRESH)
+            {
+                vector<size_t> local;
+                #pragma omp for schedule(runtime) nowait
+                for (size_t i = 0; i < frontier.size(); ++i)
+                {
+                    auto v = frontier[i];
+                    for (auto e : out_edges_range(v, g))
+                    {
+                        auto u = target(e, g);
+                        uint8_t old;
+                        #pragma omp atomic capture
+                        { old = claimed[u]; claimed[u] = true; }
+                        if (old)
+                            continue;
+                        parent[u] = v;
+                        tedge[u] = eindex[e];
+                        local.push_back(u);
+                    }
+                }
+                #pragma omp critical (bfs_merge)
+                next.insert(next.end(), local.begin(), local.end());
+            }
+            if (next.empty())
+                break;
+            levels.push_back(std::move(next));
+        }
+
+        auto is_tree_edge = [&](auto v, auto u, size_t ei)
+            {
+                return tedge[v] == ei || tedge[u] == ei;
+            };
+
+        // children lists, in CSR format
+        vector<size_t> cpos(N + 1, 0), children;
+        for (auto v : vertices_range(g))
+        {
+            if (parent[v] != v)
+                cpos[parent[v] + 1]++;
+        }
+        for (size_t v = 0; v < N; ++v)
+            cpos[v + 1] += cpos[v];
+        children.resize(cpos[N]);
+        {
+            vector<size_t> pos(cpos.begin(), cpos.end() - 1);
+            for (auto& level : levels)
+            {
+                for (auto v : level)
+                {
+                    if (parent[v] != v)
+                        children[pos[parent[v]]++] = v;
+                }
+            }
+        }
+
+        auto children_range = [&](auto v)
+            {
+                return boost::make_iterator_range(children.begin() + cpos[v],
+                                                  children.begin() + cpos[v + 1]);
+            };
+
+        // subtree sizes, bottom up
+        vector<size_t> nd(N, 1);
+        for (auto l = levels.rbegin(); l != levels.rend(); ++l)
+        {
+            parallel_loop(*l,
+                          [&](size_t, auto v)
+                          {
+                              for (auto c : children_range(v))
+                                  nd[v] += nd[c];
+                          });
+        }
+
+        // preorder numbers, top down
+        vector<size_t> pre(N);
+        size_t offset = 0;
+        for (auto r : levels[0])
+        {
+            pre[r] = offset;
+            offset += nd[r];
+        }
+        for (auto& level : levels)
+        {
+            parallel_loop(level,
+                          [&](size_t, auto v)
+                          {
+                              size_t p = pre[v] + 1;
+                              for (auto c : children_range(v))
+                              {
+                                  pre[c] = p;
+                                  p += nd[c];
+                              }
+                          });
+        }
+
+        // lowest and highest preorder numbers reachable via non-tree edges,
+        // bottom up
+        vector<size_t> low(N), high(N);
+        for (auto l = levels.rbegin(); l != levels.rend(); ++l)
+        {
+            parallel_loop(*l,
+                          [&](size_t, auto v)
+                          {
+                              auto& lo = low[v] = pre[v];
+                              auto& hi = high[v] = pre[v];
+                              for (auto e : out_edges_range(v, g))
+                              {
+                                  auto u = target(e, g);
+                                  if (is_tree_edge(v, u, eindex[e]))
+                                      continue;
+                                  lo = std::min(lo, pre[u]);
+                                  hi = std::max(hi, pre[u]);
+                              }
+                              for (auto c : children_range(v))
+                              {
+                                  lo = std::min(lo, low[c]);
+                                  hi = std::max(hi, high[c]);
+                              }
+                          });
+        }
+
+        auto is_ancestor = [&](auto u, auto v)
+            {
+                return pre[u] <= pre[v] && pre[v] < pre[u] + nd[u];
+            };
+
+        // components of the auxiliary graph, where the tree edges are
+        // identified by their lower endpoints
+        concurrent_union_find uf(N);
+        parallel_vertex_loop
+            (g,
+             [&](auto w)
+             {
+                 auto v = parent[w];
+                 if (v == w)
+                     return;
+
+                 for (auto e : out_edges_range(w, g))
+                 {
+                     auto u = target(e, g);
+                     if (pre[w] < pre[u] && !is_ancestor(w, u) &&
+                         !is_tree_edge(w, u, eindex[e]))
+                         uf.link(w, u);
+                 }
+
+                 if (parent[v] != v &&
+                     (low[w] < pre[v] || high[w] >= pre[v] + nd[v]))
+                     uf.link(w, v);
+             });
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 uf.compress(v);
+             });
+
+        // label the edges from their lower endpoints
+        vector<std::atomic<size_t>> min_idx(N);
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 min_idx[v].store(null, std::memory_order_relaxed);
+             });
+
+        auto get_rep = [&](auto v, auto u)
+            {
+                return uf.find((pre[v] < pre[u]) ? u : v);
+            };
+
+        parallel_edge_loop
+            (g,
+             [&](const auto& e)
+             {
+                 auto r = get_rep(source(e, g), target(e, g));
+                 size_t ei = eindex[e];
+                 size_t m = min_idx[r].load(std::memory_order_relaxed);
+                 while (ei < m &&
+                        !min_idx[r].compare_exchange_weak
+                            (m, ei, std::memory_order_relaxed));
+             });
+
+        vector<pair<size_t, size_t>> reps;
+        for (auto v : vertices_range(g))
+        {
+            size_t m = min_idx[v].load(std::memory_order_relaxed);
+            if (m != null)
+                reps.emplace_back(m, v);
+        }
+        std::sort(reps.begin(), reps.end());
+
+        vector<size_t> label(N, null);
+        for (size_t i = 0; i < reps.size(); ++i)
+            label[reps[i].second] = i;
+
+        hist.clear();
+        hist.resize(reps.size());
+        parallel_edge_loop
+            (g,
+             [&](const auto& e)
+             {
+                 auto l = label[get_rep(source(e, g), target(e, g))];
+                 comp_map[e] = l;
+                 #pragma omp atomic
+                 hist[l]++;
+             });
+
+        // articulation points belong to more than one component
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 size_t c = null;
+                 for (auto u : out_neighbors_range(v, g))
+                 {
+                     if (u == v)
+                         continue;
+                     auto l = label[get_rep(v, u)];
+                     if (c == null)
+                     {
+                         c = l;
+                     }
+                     else if (l != c)
+                     {
+                         art_map[v] = true;
+                         break;
+                     }
+                 }
+             });
+    }
 };
 
 
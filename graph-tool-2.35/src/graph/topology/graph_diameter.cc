@@ -20,6 +20,9 @@
 #include "graph_properties.hh"
 #include "graph_selectors.hh"
 
+#include "graph_diameter.hh"
+#include "numpy_bind.hh"
+
 #include <boost/graph/breadth_first_search.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 
@@ -173,7 +176,44 @@ python::object get_diam(GraphInterface& gi, size_t source, boost::any weight)
     return python::make_tuple(target, max_dist);
 }
 
+typedef UnityPropertyMap<size_t,GraphInterface::edge_t> ecmap_t;
+typedef boost::mpl::push_back<edge_scalar_properties, ecmap_t>::type
+        weight_props_t;
+
+python::object get_bounding_diam(GraphInterface& gi, size_t source,
+                                 boost::any weight, bool radius,
+                                 double max_time, bool verbose)
+{
+    if (weight.empty())
+        weight = ecmap_t();
+
+    python::object ret;
+    gt_dispatch<>()
+        ([&](const auto& g, auto w)
+         {
+             typedef typename property_traits<decltype(w)>::value_type val_t;
+             typedef typename std::conditional<std::is_floating_point<val_t>::value,
+                                               val_t, int64_t>::type dist_t;
+             dist_t diam_low, diam_up, rad_low, rad_up;
+             vector<std::array<double, 6>> history;
+             get_bounding_diameter(g, source, w, radius, max_time, verbose,
+                                   diam_low, diam_up, rad_low, rad_up,
+                                   history);
+             boost::multi_array<double, 2>
+                 hist(boost::extents[history.size()][6]);
+             for (size_t i = 0; i < history.size(); ++i)
+                 for (size_t j = 0; j < 6; ++j)
+                     hist[i][j] = history[i][j];
+             ret = python::make_tuple(diam_low, diam_up, rad_low, rad_up,
+                                      wrap_multi_array_owned(hist));
+         },
+         all_graph_views(), weight_props_t())
+        (gi.get_graph_view(), weight);
+    return ret;
+}
+
 void export_diam()
 {
     python::def("get_diam", &get_diam);
+    python::def("get_bounding_diam", &get_bounding_diam);
 };
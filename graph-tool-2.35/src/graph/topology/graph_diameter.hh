@@ -0,0 +1,342 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_DIAMETER_HH
+#define GRAPH_DIAMETER_HH
+
+#include <queue>
+#include <array>
+#include <chrono>
+#include <iostream>
+
+#include "config.h"
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// Iterates over the out-neighbors of v, or the in-neighbors if reversed is
+// true, calling f(u, e) for each of them.
+template <bool reversed, class Graph, class F>
+void ecc_step(const Graph& g, size_t v, F&& f)
+{
+    if constexpr (reversed)
+    {
+        for (auto e : in_or_out_edges_range(v, g))
+            f(source(e, g), e);
+    }
+    else
+    {
+        for (auto e : out_edges_range(v, g))
+            f(target(e, g), e);
+    }
+}
+
+// Single-source distances from s (or towards s if reversed is true). The
+// distance buffer is assumed to be filled with numeric_limits<Dist>::max(), and
+// only the entries of the reached vertices are touched. These are stored in
+// `reached`, so that the buffer can be reset in time proportional to the size
+// of the component, instead of the whole graph. A BFS is used if the weights
+// are constant, otherwise Dijkstra's algorithm.
+template <bool reversed, class Graph, class Weight, class Dist>
+void ecc_search(const Graph& g, size_t s, Weight& weight, vector<Dist>& dist,
+                vector<size_t>& reached)
+{
+    constexpr Dist inf = numeric_limits<Dist>::max();
+
+    for (auto v : reached)
+        dist[v] = inf;
+    reached.clear();
+
+    dist[s] = 0;
+    reached.push_back(s);
+
+    if constexpr (is_constant_property<Weight>::type::value)
+    {
+        // `reached` doubles as the BFS queue
+        for (size_t i = 0; i < reached.size(); ++i)
+        {
+            auto v = reached[i];
+            Dist d = dist[v] + 1;
+            ecc_step<reversed>(g, v,
+                               [&](auto u, auto&)
+                               {
+                                   if (dist[u] != inf)
+                                       return;
+                                   dist[u] = d;
+                                   reached.push_back(u);
+                               });
+        }
+    }
+    else
+    {
+        typedef pair<Dist, size_t> item_t;
+        priority_queue<item_t, vector<item_t>, std::greater<item_t>> queue;
+        queue.emplace(0, s);
+        while (!queue.empty())
+        {
+            auto [d, v] = queue.top();
+            queue.pop();
+            if (d > dist[v])
+                continue;
+            ecc_step<reversed>(g, v,
+                               [&](auto u, auto& e)
+                               {
+                                   Dist nd = d + get(weight, e);
+                                   if (nd >= dist[u])
+                                       return;
+                                   if (dist[u] == inf)
+                                       reached.push_back(u);
+                                   dist[u] = nd;
+                                   queue.emplace(nd, u);
+                               });
+        }
+    }
+}
+
+// Exact diameter and radius computation via eccentricity bounds, following
+// the BoundingDiameters algorithm of Takes and Kosters (which generalizes
+// iFUB). Every traversal from a vertex w yields its exact eccentricity e(w),
+// and bounds the eccentricity of every other vertex v via the triangle
+// inequality:
+//
+//     max(d(v,w), e(w) - d(w,v)) <= e(v) <= d(v,w) + e(w)
+//
+// For undirected graphs d(v,w) = d(w,v), and a single traversal suffices;
+// otherwise a second one is done in the reversed direction. Vertices whose
+// bounds can no longer change the diameter (or radius) bounds are discarded,
+// and the traversal sources are chosen alternately among the remaining
+// candidates with the largest upper bound and the smallest lower bound.
+//
+// Several traversals are done in parallel in each round, with thread-local
+// distance buffers, and the bounds are updated afterwards in a parallel loop
+// over the candidates. The computation is restricted to the (strongly)
+// connected component of the source vertex.
+//
+// The current bounds are appended to `history` after each round, as tuples
+// (traversals, elapsed time, diam_low, diam_up, radius_low, radius_up). If
+// `max_time` is positive, the algorithm stops after it is exceeded (in
+// seconds), and the bounds need not be tight.
+
+template <class Graph, class Weight, class Dist>
+void get_bounding_diameter(const Graph& g, size_t source, Weight weight,
+                           bool radius, double max_time, bool verbose,
+                           Dist& diam_low, Dist& diam_up, Dist& rad_low,
+                           Dist& rad_up, vector<std::array<double, 6>>& history)
+{
+    typedef typename graph_traits<Graph>::directed_category dir_cat;
+    constexpr bool directed = std::is_convertible<dir_cat, directed_tag>::value;
+    constexpr Dist inf = numeric_limits<Dist>::max();
+
+    auto start = chrono::steady_clock::now();
+    auto elapsed = [&]()
+        {
+            return chrono::duration<double>(chrono::steady_clock::now()
+                                            - start).count();
+        };
+
+    size_t N = num_vertices(g);
+
+    size_t nthreads = 1;
+#ifdef _OPENMP
+    if (N > OPENMP_MIN_THRESH)
+        nthreads = omp_get_max_threads();
+#endif
+
+    // per-thread traversal buffers, for the forward and reversed direction
+    vector<vector<Dist>> dist_f(nthreads), dist_b(directed ? nthreads : 0);
+    vector<vector<size_t>> reached_f(nthreads), reached_b(nthreads);
+    vector<size_t> srcs;
+    vector<Dist> eccs;
+
+    auto run_round =
+        [&]()
+        {
+            eccs.resize(srcs.size());
+            #pragma omp parallel for schedule(dynamic) if (srcs.size() > 1)
+            for (size_t i = 0; i < srcs.size(); ++i)
+            {
+                if (dist_f[i].empty())
+                    dist_f[i].resize(N, inf);
+                ecc_search<false>(g, srcs[i], weight, dist_f[i],
+                                  reached_f[i]);
+                if constexpr (directed)
+                {
+                    if (dist_b[i].empty())
+                        dist_b[i].resize(N, inf);
+                    ecc_search<true>(g, srcs[i], weight, dist_b[i],
+                                     reached_b[i]);
+                }
+            }
+        };
+
+    vector<Dist> ecc_low(N, 0), ecc_up(N, inf);
+    vector<uint8_t> in_comp(N, false);
+    vector<size_t> cands;
+
+    // The first traversal determines the component
+    srcs.push_back(source);
+    run_round();
+    for (auto v : reached_f[0])
+    {
+        if constexpr (directed)
+        {
+            if (dist_b[0][v] == inf)
+                continue;
+        }
+        in_comp[v] = true;
+        cands.push_back(v);
+    }
+
+    diam_low = 0;
+    diam_up = inf;
+    rad_low = 0;
+    rad_up = inf;
+
+    size_t n_iter = 0;
+    while (true)
+    {
+        // The eccentricities of the sources are only taken over the component
+        #pragma omp parallel for schedule(dynamic) if (srcs.size() > 1)
+        for (size_t i = 0; i < srcs.size(); ++i)
+        {
+            Dist e = 0;
+            for (auto v : reached_f[i])
+            {
+                if (in_comp[v])
+                    e = std::max(e, dist_f[i][v]);
+            }
+            eccs[i] = e;
+        }
+
+        n_iter += srcs.size();
+
+        Dist c_diam_low = diam_low, c_rad_up = rad_up;
+        #pragma omp parallel if (cands.size() > OPENMP_MIN_THRESH) \
+            reduction(max:c_diam_low) reduction(min:c_rad_up)
+        parallel_loop_no_spawn
+            (cands,
+             [&](size_t, size_t v)
+             {
+                 auto& lo = ecc_low[v];
+                 auto& up = ecc_up[v];
+                 for (size_t i = 0; i < srcs.size(); ++i)
+                 {
+                     Dist e = eccs[i];
+                     if (srcs[i] == v)
+                     {
+                         lo = up = e;
+                         continue;
+                     }
+                     Dist d_wv = dist_f[i][v];
+                     Dist d_vw = d_wv;
+                     if constexpr (directed)
+                         d_vw = dist_b[i][v];
+                     lo = std::max({lo, d_vw, Dist(e - d_wv)});
+                     up = std::min(up, Dist(d_vw + e));
+                 }
+                 c_diam_low = std::max(c_diam_low, lo);
+                 c_rad_up = std::min(c_rad_up, up);
+             });
+        diam_low = c_diam_low;
+        rad_up = c_rad_up;
+
+        // Discard the vertices which can no longer change the bounds
+        auto iter = std::remove_if(cands.begin(), cands.end(),
+                                   [&](auto v)
+                                   {
+                                       auto lo = ecc_low[v];
+                                       auto up = ecc_up[v];
+                                       if (radius)
+                                           return (lo == up ||
+                                                   (up <= diam_low &&
+                                                    lo >= rad_up));
+                                       return up <= diam_low;
+                                   });
+        cands.erase(iter, cands.end());
+
+        diam_up = diam_low;
+        rad_low = rad_up;
+        for (auto v : cands)
+        {
+            diam_up = std::max(diam_up, ecc_up[v]);
+            rad_low = std::min(rad_low, ecc_low[v]);
+        }
+
+        double t = elapsed();
+        history.push_back({double(n_iter), t, double(diam_low),
+                           double(diam_up), double(rad_low), double(rad_up)});
+
+        if (verbose)
+        {
+            cout << n_iter << " traversals, " << t << " s, "
+                 << cands.size() << " candidates, diameter: ["
+                 << diam_low << ", " << diam_up << "]";
+            if (radius)
+                cout << ", radius: [" << rad_low << ", " << rad_up << "]";
+            cout << endl;
+        }
+
+        if (cands.empty() || (max_time > 0 && t > max_time))
+            break;
+
+        // Choose the next sources alternately among the candidates with the
+        // largest upper bound and smallest lower bound, breaking ties in favor
+        // of higher degrees.
+        srcs.clear();
+        size_t B = std::min(nthreads, cands.size());
+        for (size_t i = 0; i < B; ++i)
+        {
+            auto pos = cands.end();
+            for (auto it = cands.begin(); it != cands.end(); ++it)
+            {
+                auto v = *it;
+                if (std::find(srcs.begin(), srcs.end(), v) != srcs.end())
+                    continue;
+                if (pos == cands.end())
+                {
+                    pos = it;
+                    continue;
+                }
+                auto u = *pos;
+                auto kv = total_degreeS()(v, g);
+                auto ku = total_degreeS()(u, g);
+                bool better;
+                if (i % 2 == 0)
+                    better = (ecc_up[v] > ecc_up[u] ||
+                              (ecc_up[v] == ecc_up[u] && kv > ku));
+                else
+                    better = (ecc_low[v] < ecc_low[u] ||
+                              (ecc_low[v] == ecc_low[u] && kv > ku));
+                if (better)
+                    pos = it;
+            }
+            srcs.push_back(*pos);
+        }
+
+        run_round();
+    }
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_DIAMETER_HH
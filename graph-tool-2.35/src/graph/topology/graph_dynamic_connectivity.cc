@@ -0,0 +1,49 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "graph.hh"
+#include "graph_selectors.hh"
+
+#include "graph_dynamic_connectivity.hh"
+
+#include <boost/python.hpp>
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+typedef DynamicConnectivity<GraphInterface::multigraph_t> dyn_conn_t;
+
+// The oracle operates on the unfiltered graph, and shares its ownership.
+dyn_conn_t* make_dynamic_connectivity(GraphInterface& gi, bool deletions)
+{
+    return new dyn_conn_t(gi.get_graph_ptr(), deletions);
+}
+
+void export_dynamic_connectivity()
+{
+    using namespace boost::python;
+    class_<dyn_conn_t, boost::noncopyable>("DynamicConnectivity", no_init)
+        .def("__init__", make_constructor(&make_dynamic_connectivity))
+        .def("rebuild", &dyn_conn_t::rebuild)
+        .def("insert", &dyn_conn_t::insert)
+        .def("remove", &dyn_conn_t::remove)
+        .def("connected", &dyn_conn_t::connected)
+        .def("component_size", &dyn_conn_t::component_size)
+        .def("component", &dyn_conn_t::component)
+        .def("num_components", &dyn_conn_t::num_components);
+}
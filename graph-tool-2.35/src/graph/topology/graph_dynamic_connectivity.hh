@@ -0,0 +1,339 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_DYNAMIC_CONNECTIVITY_HH
+#define GRAPH_DYNAMIC_CONNECTIVITY_HH
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <array>
+
+#include "graph_exceptions.hh"
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// Connectivity oracle for a graph which is modified by edge insertions and
+// deletions. Components are always taken to be weakly connected, i.e. edge
+// directions are ignored.
+//
+// Each vertex points to a node of a union-find structure, whose roots identify
+// the components and hold their sizes, so that connectivity and component size
+// queries take amortized O(alpha(N)) time. Insertions are handled by merging
+// the components of the endpoints.
+//
+// If deletions are enabled, a spanning forest of the graph is also maintained,
+// by flagging its edges. Removing a non-tree edge does not change the
+// components. If a tree edge (u, v) is removed, its tree splits in two, which
+// are traversed in an interleaved fashion from u and v until the smaller one
+// is exhausted. The edges incident on the smaller side are then scanned for a
+// replacement edge reaching the other side, which is promoted to the forest.
+// If none is found, the vertices in the smaller side are moved to a fresh
+// union-find node. The cost of a deletion is therefore proportional to the sum
+// of the degrees in the smaller side, which is small whenever the removed tree
+// edge cuts off a small portion of its tree. The initial forest is obtained by
+// BFS from the vertices in decreasing order of degree, which keeps the trees
+// shallow and most tree edges near their leaves.
+//
+// Vertices added to the graph after the construction of the oracle are
+// treated as isolated until they get incident edges. Vertex removals are not
+// tracked, and require a call to rebuild().
+
+template <class Graph>
+class DynamicConnectivity
+{
+public:
+    DynamicConnectivity(std::shared_ptr<Graph> g, bool deletions)
+        : _g(g), _eindex(get(edge_index_t(), *g)), _deletions(deletions)
+    {
+        rebuild();
+    }
+
+    void rebuild()
+    {
+        auto& g = *_g;
+        size_t N = num_vertices(g);
+
+        _node.resize(N);
+        _parent.resize(N);
+        _size.clear();
+        _size.resize(N, 1);
+        for (size_t v = 0; v < N; ++v)
+            _node[v] = _parent[v] = v;
+        _ncomp = N;
+
+        _tree.clear();
+        _mark.clear();
+        _mark.resize(N, 0);
+        _stamp = 0;
+
+        if (!_deletions)
+        {
+            for (auto e : edges_range(g))
+                merge(source(e, g), target(e, g));
+            return;
+        }
+
+        _tree.resize(g.get_edge_index_range(), false);
+
+        vector<size_t> order(N);
+        for (size_t v = 0; v < N; ++v)
+            order[v] = v;
+        std::sort(order.begin(), order.end(),
+                  [&](auto u, auto v)
+                  {
+                      auto ku = in_degree(u, g) + out_degree(u, g);
+                      auto kv = in_degree(v, g) + out_degree(v, g);
+                      return ku > kv || (ku == kv && u < v);
+                  });
+
+        // BFS forest; _mark is used to flag the visited vertices, and is
+        // reset afterwards
+        vector<size_t> queue;
+        for (auto r : order)
+        {
+            if (_mark[r] != 0)
+                continue;
+            queue.clear();
+            queue.push_back(r);
+            _mark[r] = 1;
+            for (size_t i = 0; i < queue.size(); ++i)
+            {
+                auto v = queue[i];
+                for (auto e : all_edges_range(v, g))
+                {
+                    auto u = (source(e, g) == v) ? target(e, g) : source(e, g);
+                    if (_mark[u] != 0)
+                        continue;
+                    _mark[u] = 1;
+                    _tree[_eindex[e]] = true;
+                    _node[u] = r;
+                    queue.push_back(u);
+                }
+            }
+            _size[r] = queue.size();
+            _ncomp -= queue.size() - 1;
+        }
+        std::fill(_mark.begin(), _mark.end(), 0);
+    }
+
+    // Must be called after the edge (u, v) with index idx is added to the
+    // graph.
+    void insert(size_t u, size_t v, size_t idx)
+    {
+        extend(std::max(u, v) + 1);
+        bool merged = merge(u, v);
+        if (_deletions)
+        {
+            if (idx >= _tree.size())
+                _tree.resize(std::max(idx + 1, 2 * _tree.size()), false);
+            _tree[idx] = merged;
+        }
+    }
+
+    // Must be called after the edge (u, v) with index idx is removed from the
+    // graph.
+    void remove(size_t u, size_t v, size_t idx)
+    {
+        if (!_deletions)
+            throw ValueException("edge deletions are not enabled");
+        if (idx >= _tree.size() || !_tree[idx])
+            return;
+        _tree[idx] = false;
+
+        auto& g = *_g;
+        extend(num_vertices(g));
+        if (_tree.size() < g.get_edge_index_range())
+            _tree.resize(g.get_edge_index_range(), false);
+
+        // Interleaved traversal of the two halves of the split tree. They
+        // cannot meet, so a single visitation stamp per side suffices.
+        _stamp += 2;
+        size_t mark[2] = {_stamp, _stamp + 1};
+        auto& queue = _queue;
+        queue[0].clear();
+        queue[1].clear();
+        queue[0].push_back(u);
+        queue[1].push_back(v);
+        _mark[u] = mark[0];
+        _mark[v] = mark[1];
+        size_t pos[2] = {0, 0};
+        size_t side = 0;
+        while (true)
+        {
+            if (pos[side] == queue[side].size())
+                break;
+            auto w = queue[side][pos[side]++];
+            for (auto e : all_edges_range(w, g))
+            {
+                if (!_tree[_eindex[e]])
+                    continue;
+                auto x = (source(e, g) == w) ? target(e, g) : source(e, g);
+                if (_mark[x] == mark[side])
+                    continue;
+                _mark[x] = mark[side];
+                queue[side].push_back(x);
+            }
+            side = 1 - side;
+        }
+
+        // Look for a replacement edge leaving the smaller side
+        auto& small = queue[side];
+        for (auto w : small)
+        {
+            for (auto e : all_edges_range(w, g))
+            {
+                auto x = (source(e, g) == w) ? target(e, g) : source(e, g);
+                if (_mark[x] == mark[side])
+                    continue;
+                _tree[_eindex[e]] = true;
+                return;
+            }
+        }
+
+        // No replacement; the smaller side becomes a new component
+        size_t r = find(u);
+        size_t n = _parent.size();
+        _parent.push_back(n);
+        _size.push_back(small.size());
+        _size[r] -= small.size();
+        for (auto w : small)
+            _node[w] = n;
+        _ncomp++;
+
+        // Reclaim the union-find nodes left behind by the splits
+        if (_parent.size() > 4 * _node.size() + 1024)
+            compact();
+    }
+
+    bool connected(size_t u, size_t v)
+    {
+        if (u == v)
+            return true;
+        if (std::max(u, v) >= _node.size())
+            return false;
+        return find(u) == find(v);
+    }
+
+    size_t component_size(size_t v)
+    {
+        if (v >= _node.size())
+            return 1;
+        return _size[find(v)];
+    }
+
+    // The label is the union-find root of the component, and is only stable
+    // while the graph is not modified.
+    size_t component(size_t v)
+    {
+        if (v >= _node.size())
+            return _parent.size() + (v - _node.size());
+        return find(v);
+    }
+
+    size_t num_components()
+    {
+        size_t N = num_vertices(*_g);
+        return _ncomp + (N - std::min(N, _node.size()));
+    }
+
+private:
+    void extend(size_t N)
+    {
+        while (_node.size() < N)
+        {
+            _node.push_back(_parent.size());
+            _parent.push_back(_parent.size());
+            _size.push_back(1);
+            _mark.push_back(0);
+            _ncomp++;
+        }
+    }
+
+    size_t find_root(size_t n)
+    {
+        while (_parent[n] != n)
+        {
+            _parent[n] = _parent[_parent[n]];
+            n = _parent[n];
+        }
+        return n;
+    }
+
+    size_t find(size_t v)
+    {
+        auto r = find_root(_node[v]);
+        _node[v] = r;
+        return r;
+    }
+
+    bool merge(size_t u, size_t v)
+    {
+        auto ru = find(u);
+        auto rv = find(v);
+        if (ru == rv)
+            return false;
+        if (_size[ru] < _size[rv])
+            std::swap(ru, rv);
+        _parent[rv] = ru;
+        _size[ru] += _size[rv];
+        _ncomp--;
+        return true;
+    }
+
+    void compact()
+    {
+        size_t N = _node.size();
+        vector<size_t> idx(_parent.size(), numeric_limits<size_t>::max());
+        vector<size_t> size;
+        for (size_t v = 0; v < N; ++v)
+        {
+            auto r = find(v);
+            if (idx[r] == numeric_limits<size_t>::max())
+            {
+                idx[r] = size.size();
+                size.push_back(_size[r]);
+            }
+            _node[v] = idx[r];
+        }
+        _parent.resize(size.size());
+        for (size_t i = 0; i < _parent.size(); ++i)
+            _parent[i] = i;
+        _size.swap(size);
+    }
+
+    std::shared_ptr<Graph> _g;
+    typename property_map<Graph, edge_index_t>::type _eindex;
+    bool _deletions;
+
+    vector<size_t> _node;     // vertex -> union-find node
+    vector<size_t> _parent;   // union-find forest
+    vector<size_t> _size;     // component sizes, valid at the roots
+    size_t _ncomp = 0;
+
+    vector<bool> _tree;       // spanning forest membership, by edge index
+    vector<size_t> _mark;
+    size_t _stamp = 0;
+    std::array<vector<size_t>, 2> _queue;
+};
+
+} // graph_tool namespace
+
+#endif // GRAPH_DYNAMIC_CONNECTIVITY_HH
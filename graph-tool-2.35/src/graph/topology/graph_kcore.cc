@@ -28,18 +28,39 @@ using namespace std;
 using namespace boost;
 using namespace graph_tool;
 
-void do_kcore_decomposition(GraphInterface& gi, boost::any prop)
+void do_kcore_decomposition(GraphInterface& gi, boost::any prop,
+                            bool parallel)
 {
     gt_dispatch<>()
-        ([](auto& g, auto core)
+        ([&](auto& g, auto core)
          {
-             kcore_decomposition(g, core);
+             if (parallel)
+                 parallel_kcore_decomposition(g, core);
+             else
+                 kcore_decomposition(g, core);
          },
          all_graph_views(), writable_vertex_scalar_properties())
         (gi.get_graph_view(), prop);
 }
 
+typedef DynamicKCore<GraphInterface::multigraph_t,
+                     vprop_map_t<int32_t>::type> dyn_kcore_t;
+
+// The core numbers are kept in the given int32_t vertex property map, and
+// refer to the unfiltered graph.
+dyn_kcore_t* make_dynamic_kcore(GraphInterface& gi, boost::any acore)
+{
+    auto core = any_cast<vprop_map_t<int32_t>::type>(acore);
+    return new dyn_kcore_t(gi.get_graph_ptr(), core);
+}
+
 void export_kcore()
 {
-    python::def("kcore_decomposition", &do_kcore_decomposition);
+    using namespace boost::python;
+    def("kcore_decomposition", &do_kcore_decomposition);
+    class_<dyn_kcore_t, boost::noncopyable>("DynamicKCore", no_init)
+        .def("__init__", make_constructor(&make_dynamic_kcore))
+        .def("rebuild", &dyn_kcore_t::rebuild)
+        .def("insert", &dyn_kcore_t::insert)
+        .def("remove", &dyn_kcore_t::remove);
 };
@@ -18,6 +18,10 @@
 #ifndef GRAPH_KCORE_HH
 #define GRAPH_KCORE_HH
 
+#include <memory>
+
+#include "graph_util.hh"
+
 namespace graph_tool
 {
 using namespace std;
@@ -80,6 +84,305 @@ void kcore_decomposition(Graph& g, CoreMap core_map)
     }
 }
 
+// Parallel k-core decomposition, following the PKC algorithm of Kabir and
+// Madduri. The vertices are peeled level by level: at level k, the remaining
+// vertices with degree k are first collected into thread-local buffers, which
+// are then processed concurrently, with the degrees of the neighbors
+// decremented atomically. A neighbor whose degree drops to k is appended to the
+// buffer of the thread that performed the decrement. Between levels the
+// remaining vertices are compacted, and empty levels are skipped by jumping to
+// the smallest remaining degree.
+
+template <class Graph, class CoreMap>
+void parallel_kcore_decomposition(Graph& g, CoreMap core_map)
+{
+    size_t N = num_vertices(g);
+    vector<size_t> deg(N);
+    vector<size_t> remaining, next;
+
+    for (auto v : vertices_range(g))
+    {
+        deg[v] = degree(v, g);
+        remaining.push_back(v);
+    }
+
+    size_t k = 0;
+    while (!remaining.empty())
+    {
+        // Drop the vertices peeled in the previous level, and find the next
+        // non-empty level
+        size_t k_min = numeric_limits<size_t>::max();
+        next.clear();
+        #pragma omp parallel if (remaining.size() > OPENMP_MIN_THRESH) \
+            reduction(min:k_min)
+        {
+            vector<size_t> lnext;
+            parallel_loop_no_spawn
+                (remaining,
+                 [&](size_t, auto v)
+                 {
+                     if (deg[v] < k)
+                         return;
+                     lnext.push_back(v);
+                     k_min = std::min(k_min, deg[v]);
+                 });
+            #pragma omp critical (kcore_compact)
+            next.insert(next.end(), lnext.begin(), lnext.end());
+        }
+        remaining.swap(next);
+        if (remaining.empty())
+            break;
+        k = k_min;
+
+        #pragma omp parallel if (remaining.size() > OPENMP_MIN_THRESH)
+        {
+            vector<size_t> buf;
+            parallel_loop_no_spawn
+                (remaining,
+                 [&](size_t, auto v)
+                 {
+                     if (deg[v] == k)
+                         buf.push_back(v);
+                 });
+
+            // The scan above ends with an implicit barrier, so that the
+            // vertices reaching degree k below are never collected twice.
+            while (!buf.empty())
+            {
+                auto v = buf.back();
+                buf.pop_back();
+                core_map[v] = k;
+                for (auto u : all_neighbors_range(v, g))
+                {
+                    if (deg[u] <= k)
+                        continue;
+                    size_t ku;
+                    #pragma omp atomic capture
+                    ku = deg[u]--;
+                    if (ku == k + 1)
+                    {
+                        buf.push_back(u);
+                    }
+                    else if (ku <= k)
+                    {
+                        #pragma omp atomic
+                        deg[u]++;
+                    }
+                }
+            }
+        }
+        ++k;
+    }
+}
+
+// Maintains the core numbers of a graph under edge insertions and deletions,
+// following the subcore algorithm of Li, Yu and Mao. After the insertion or
+// removal of an edge (u, v), with K = min(core[u], core[v]), only the vertices
+// with core number K that are connected to the endpoints via other vertices
+// with core number K can change, and only by one.
+//
+// For an insertion, this subcore is traversed, and the vertices in it with at
+// most K neighbors of core number K or larger are iteratively evicted; the
+// remaining ones have their core numbers increased. For a removal, the
+// vertices left with fewer than K such neighbors are lowered, starting from
+// the endpoints, and this is propagated to their neighbors. In both cases, the
+// work is proportional to the total degree of the subcore.
+//
+// The degrees are the total degrees, as in kcore_decomposition(), and hence
+// self-loops count twice, and can change the core numbers by two. Vertices
+// added to the graph are treated as isolated, i.e. with core number zero.
+
+template <class Graph, class CoreMap>
+class DynamicKCore
+{
+public:
+    DynamicKCore(std::shared_ptr<Graph> g, CoreMap core)
+        : _g(g), _core(core)
+    {
+        rebuild();
+    }
+
+    void rebuild()
+    {
+        auto& g = *_g;
+        size_t N = num_vertices(g);
+        parallel_kcore_decomposition(g, _core.get_unchecked(N));
+        _cd.clear();
+        _cd.resize(N);
+        _mark.clear();
+        _mark.resize(N);
+        _flag.clear();
+        _flag.resize(N);
+        _stamp = 0;
+    }
+
+    // Must be called after the edge (u, v) is added to the graph. Self-loops
+    // increase the degree by two, and hence the update is done twice.
+    void insert(size_t u, size_t v)
+    {
+        extend();
+        insert_step(u, v);
+        if (u == v)
+            insert_step(u, v);
+    }
+
+    // Must be called after the edge (u, v) is removed from the graph.
+    void remove(size_t u, size_t v)
+    {
+        extend();
+        remove_step(u, v);
+        if (u == v)
+            remove_step(u, v);
+    }
+
+private:
+    void insert_step(size_t u, size_t v)
+    {
+        auto& g = *_g;
+        size_t K = std::min(_core[u], _core[v]);
+
+        // Collect the subcore
+        ++_stamp;
+        _queue.clear();
+        for (auto r : {u, v})
+        {
+            if (size_t(_core[r]) != K || _mark[r] == _stamp)
+                continue;
+            _mark[r] = _stamp;
+            _queue.push_back(r);
+        }
+        for (size_t i = 0; i < _queue.size(); ++i)
+        {
+            auto w = _queue[i];
+            size_t cd = 0;
+            for (auto x : all_neighbors_range(w, g))
+            {
+                size_t kx = _core[x];
+                if (kx < K)
+                    continue;
+                ++cd;
+                if (kx == K && _mark[x] != _stamp)
+                {
+                    _mark[x] = _stamp;
+                    _queue.push_back(x);
+                }
+            }
+            _cd[w] = cd;
+        }
+
+        // Evict the vertices which cannot be in the (K+1)-core; _flag marks
+        // the evicted ones
+        _stack.clear();
+        for (auto w : _queue)
+        {
+            if (_cd[w] <= K)
+            {
+                _flag[w] = _stamp;
+                _stack.push_back(w);
+            }
+        }
+        while (!_stack.empty())
+        {
+            auto w = _stack.back();
+            _stack.pop_back();
+            for (auto x : all_neighbors_range(w, g))
+            {
+                if (_mark[x] != _stamp || _flag[x] == _stamp)
+                    continue;
+                if (--_cd[x] <= K)
+                {
+                    _flag[x] = _stamp;
+                    _stack.push_back(x);
+                }
+            }
+        }
+
+        for (auto w : _queue)
+        {
+            if (_flag[w] != _stamp)
+                _core[w] = K + 1;
+        }
+    }
+
+    void remove_step(size_t u, size_t v)
+    {
+        auto& g = *_g;
+        size_t K = std::min(_core[u], _core[v]);
+        if (K == 0)
+            return;
+
+        // _mark flags the vertices with a computed count, and _flag those
+        // which are lowered. The core numbers are only updated after the
+        // vertex is processed, so that every edge to a lowered vertex is
+        // discounted exactly once.
+        ++_stamp;
+        auto count = [&](auto w)
+            {
+                size_t cd = 0;
+                for (auto x : all_neighbors_range(w, g))
+                {
+                    if (size_t(_core[x]) >= K)
+                        ++cd;
+                }
+                _cd[w] = cd;
+                _mark[w] = _stamp;
+            };
+
+        _stack.clear();
+        for (auto r : {u, v})
+        {
+            if (size_t(_core[r]) != K || _mark[r] == _stamp)
+                continue;
+            count(r);
+            if (_cd[r] < K)
+            {
+                _flag[r] = _stamp;
+                _stack.push_back(r);
+            }
+        }
+
+        while (!_stack.empty())
+        {
+            auto w = _stack.back();
+            _stack.pop_back();
+            for (auto x : all_neighbors_range(w, g))
+            {
+                if (size_t(_core[x]) != K || _flag[x] == _stamp)
+                    continue;
+                if (_mark[x] != _stamp)
+                    count(x);
+                if (--_cd[x] < K)
+                {
+                    _flag[x] = _stamp;
+                    _stack.push_back(x);
+                }
+            }
+            _core[w] = K - 1;
+        }
+    }
+
+    void extend()
+    {
+        size_t N = num_vertices(*_g);
+        if (_cd.size() >= N)
+            return;
+        _cd.resize(N);
+        _mark.resize(N);
+        _flag.resize(N);
+        _core.get_unchecked(N);
+    }
+
+    std::shared_ptr<Graph> _g;
+    CoreMap _core;
+
+    vector<size_t> _cd;      // number of neighbors with core number >= K
+    vector<size_t> _mark;
+    vector<size_t> _flag;
+    size_t _stamp = 0;
+    vector<size_t> _queue;
+    vector<size_t> _stack;
+};
+
 } // graph_tool namespace
 
 #endif // GRAPH_KCORE_HH
@@ -48,7 +48,69 @@ boost::python::object get_max_cliques(GraphInterface& gi)
 #endif // HAVE_BOOST_COROUTINE
 }
 
+// Returns the number of maximal cliques and, unless count_only is true, their
+// vertices concatenated in a flat array, together with the array of offsets.
+// The cliques are grouped by the earliest vertex of their subproblem, in
+// increasing order of index, and the vertices of each clique are sorted, so
+// that the output does not depend on the number of threads.
+boost::python::object get_max_cliques_flat(GraphInterface& gi, bool count_only)
+{
+    size_t count = 0;
+    std::vector<size_t> flat, offsets;
+    run_action<>()
+        (gi,
+         [&](auto& g)
+         {
+             size_t nthreads = 1;
+#ifdef _OPENMP
+             nthreads = omp_get_max_threads();
+#endif
+             std::vector<size_t> counts(nthreads);
+             std::vector<std::vector<size_t>> tflat(count_only ? 0 : nthreads);
+             // (first vertex, thread, position, size) of each clique
+             std::vector<std::vector<std::array<size_t, 4>>>
+                 trecs(count_only ? 0 : nthreads);
+
+             parallel_max_cliques
+                 (g,
+                  [&](size_t tid, size_t v, auto& R)
+                  {
+                      counts[tid]++;
+                      if (count_only)
+                          return;
+                      auto& f = tflat[tid];
+                      trecs[tid].push_back({v, tid, f.size(), R.size()});
+                      f.insert(f.end(), R.begin(), R.end());
+                      std::sort(f.end() - R.size(), f.end());
+                  });
+
+             for (auto c : counts)
+                 count += c;
+             if (count_only)
+                 return;
+
+             std::vector<std::array<size_t, 4>> recs;
+             for (auto& r : trecs)
+                 recs.insert(recs.end(), r.begin(), r.end());
+             std::sort(recs.begin(), recs.end());
+             offsets.reserve(recs.size() + 1);
+             offsets.push_back(0);
+             for (auto& r : recs)
+             {
+                 auto& f = tflat[r[1]];
+                 flat.insert(flat.end(), f.begin() + r[2],
+                             f.begin() + r[2] + r[3]);
+                 offsets.push_back(flat.size());
+             }
+         })();
+    if (count_only)
+        return boost::python::object(count);
+    return boost::python::make_tuple(count, wrap_vector_owned(flat),
+                                     wrap_vector_owned(offsets));
+}
+
 void export_max_cliques()
 {
     boost::python::def("max_cliques", &get_max_cliques);
+    boost::python::def("max_cliques_flat", &get_max_cliques_flat);
 };
@@ -20,9 +20,16 @@
 
 #include <array>
 #include <deque>
+#include <vector>
+#include <algorithm>
+#include <functional>
 
 #include "hash_map_wrap.hh"
 
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
 namespace graph_tool
 {
 
@@ -138,6 +145,352 @@ void max_cliques(Graph& g, Visitor&& vis)
     }
 }
 
+// Parallel enumeration of maximal cliques, following Eppstein, Löffler and
+// Strash. The vertices are put in a degeneracy order, and the cliques are
+// split into disjoint subproblems according to their earliest vertex v in this
+// order, which are solved with Bron-Kerbosch with pivoting, starting from
+// R = {v}, P = the later neighbors of v, and X = its earlier neighbors. Since
+// |P| is bounded by the degeneracy, the subproblems are small even when the
+// degrees are large.
+//
+// The subproblems are independent tasks, dynamically scheduled among the
+// threads, largest first. Each task relabels the vertices in P and X locally,
+// and if there are not too many of them, uses adjacency rows of bitsets for
+// all set operations; otherwise it falls back to sorted vectors of vertices.
+// Vertices in X without neighbors in P are dropped beforehand, since they
+// cannot affect the maximality of any clique in the subproblem.
+//
+// The function f(tid, v, R) is called for each maximal clique R with at least
+// two vertices, with v being the first vertex of its subproblem and tid the
+// current thread. R is in no particular order.
+
+template <class Graph, class F>
+void parallel_max_cliques(Graph& g, F&& f)
+{
+    size_t N = num_vertices(g);
+
+    // simple adjacency, sorted and without self-loops or parallel edges
+    std::vector<std::vector<size_t>> adj(N);
+    parallel_vertex_loop
+        (g,
+         [&](auto v)
+         {
+             auto& vadj = adj[v];
+             for (auto u : out_neighbors_range(v, g))
+             {
+                 if (u != v)
+                     vadj.push_back(u);
+             }
+             std::sort(vadj.begin(), vadj.end());
+             vadj.erase(std::unique(vadj.begin(), vadj.end()), vadj.end());
+         });
+
+    // degeneracy order, via bucket peeling
+    std::vector<size_t> pos(N), deg(N), vs;
+    size_t max_deg = 0;
+    for (auto v : vertices_range(g))
+    {
+        deg[v] = adj[v].size();
+        max_deg = std::max(max_deg, deg[v]);
+        vs.push_back(v);
+    }
+    {
+        std::vector<size_t> bin(max_deg + 2), vert(vs.size()), vpos(N);
+        for (auto v : vs)
+            bin[deg[v] + 1]++;
+        for (size_t k = 1; k < bin.size(); ++k)
+            bin[k] += bin[k - 1];
+        for (auto v : vs)
+        {
+            vpos[v] = bin[deg[v]]++;
+            vert[vpos[v]] = v;
+        }
+        for (size_t k = bin.size() - 1; k > 0; --k)
+            bin[k] = bin[k - 1];
+        bin[0] = 0;
+        for (size_t i = 0; i < vert.size(); ++i)
+        {
+            auto v = vert[i];
+            pos[v] = i;
+            for (auto u : adj[v])
+            {
+                if (deg[u] <= deg[v])
+                    continue;
+                auto du = deg[u];
+                auto pu = vpos[u];
+                auto pw = bin[du];
+                auto w = vert[pw];
+                if (u != w)
+                {
+                    vert[pu] = w;
+                    vpos[w] = pu;
+                    vert[pw] = u;
+                    vpos[u] = pw;
+                }
+                bin[du]++;
+                deg[u]--;
+            }
+        }
+    }
+
+    // largest subproblems first
+    std::sort(vs.begin(), vs.end(),
+              [&](auto u, auto v)
+              {
+                  auto ku = adj[u].size(), kv = adj[v].size();
+                  return ku > kv || (ku == kv && u < v);
+              });
+
+    constexpr size_t max_bitset = 8192;
+
+    #pragma omp parallel if (N > OPENMP_MIN_THRESH)
+    {
+        size_t tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        std::vector<size_t> L, R, P, X;
+        gt_hash_map<size_t, size_t> lidx;
+        gt_hash_set<size_t> Pset;
+        std::vector<uint64_t> rows, stack;
+
+        // bitset recursion; the sets of each depth are stored consecutively
+        // in `stack`, as (P, X) pairs of W words each
+        std::function<void(size_t, size_t, size_t)> expand_bits =
+            [&](size_t W, size_t depth, size_t v)
+            {
+                auto P_ = [&]() { return stack.data() + 2 * W * depth; };
+                auto X_ = [&]() { return stack.data() + 2 * W * depth + W; };
+
+                bool P_empty = true, X_empty = true;
+                for (size_t i = 0; i < W; ++i)
+                {
+                    P_empty &= (P_()[i] == 0);
+                    X_empty &= (X_()[i] == 0);
+                }
+                if (P_empty)
+                {
+                    if (X_empty)
+                        f(tid, v, R);
+                    return;
+                }
+
+                // pivot maximizing |P & N(u)| over u in P | X
+                size_t u = 0, ku = 0;
+                bool first = true;
+                for (size_t i = 0; i < W; ++i)
+                {
+                    uint64_t m = P_()[i] | X_()[i];
+                    while (m != 0)
+                    {
+                        size_t w = i * 64 + __builtin_ctzll(m);
+                        m &= m - 1;
+                        auto row = rows.data() + w * W;
+                        size_t k = 0;
+                        for (size_t j = 0; j < W; ++j)
+                            k += __builtin_popcountll(P_()[j] & row[j]);
+                        if (first || k > ku)
+                        {
+                            u = w;
+                            ku = k;
+                            first = false;
+                        }
+                    }
+                }
+
+                if (stack.size() < 2 * W * (depth + 2))
+                    stack.resize(2 * W * (depth + 2));
+                auto urow = rows.data() + u * W;
+                for (size_t i = 0; i < W; ++i)
+                {
+                    uint64_t m = P_()[i] & ~urow[i];
+                    while (m != 0)
+                    {
+                        size_t w = i * 64 + __builtin_ctzll(m);
+                        uint64_t b = m & -m;
+                        m &= m - 1;
+                        auto row = rows.data() + w * W;
+                        auto nP = stack.data() + 2 * W * (depth + 1);
+                        auto nX = nP + W;
+                        for (size_t j = 0; j < W; ++j)
+                        {
+                            nP[j] = P_()[j] & row[j];
+                            nX[j] = X_()[j] & row[j];
+                        }
+                        R.push_back(L[w]);
+                        expand_bits(W, depth + 1, v);
+                        R.pop_back();
+                        P_()[i] &= ~b;
+                        X_()[i] |= b;
+                    }
+                }
+            };
+
+        // sorted-vector recursion, for large subproblems
+        auto is_adj = [&](size_t u, size_t w)
+            {
+                auto& a = adj[u];
+                return std::binary_search(a.begin(), a.end(), w);
+            };
+        auto intersect = [&](const auto& S, size_t w, auto& out)
+            {
+                out.clear();
+                auto& a = adj[w];
+                std::set_intersection(S.begin(), S.end(), a.begin(), a.end(),
+                                      std::back_inserter(out));
+            };
+        std::function<void(std::vector<size_t>&, std::vector<size_t>&, size_t)>
+            expand_vec =
+            [&](std::vector<size_t>& P, std::vector<size_t>& X, size_t v)
+            {
+                if (P.empty())
+                {
+                    if (X.empty())
+                        f(tid, v, R);
+                    return;
+                }
+
+                size_t u = 0, ku = 0;
+                bool first = true;
+                for (auto S : {&P, &X})
+                {
+                    for (auto w : *S)
+                    {
+                        size_t k = 0;
+                        for (auto x : P)
+                            k += is_adj(w, x);
+                        if (first || k > ku)
+                        {
+                            u = w;
+                            ku = k;
+                            first = false;
+                        }
+                    }
+                }
+
+                std::vector<size_t> cands, nP, nX;
+                for (auto w : P)
+                {
+                    if (!is_adj(u, w))
+                        cands.push_back(w);
+                }
+                for (auto w : cands)
+                {
+                    intersect(P, w, nP);
+                    intersect(X, w, nX);
+                    R.push_back(w);
+                    expand_vec(nP, nX, v);
+                    R.pop_back();
+                    P.erase(std::lower_bound(P.begin(), P.end(), w));
+                    X.insert(std::lower_bound(X.begin(), X.end(), w), w);
+                }
+            };
+
+        #pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < vs.size(); ++i)
+        {
+            auto v = vs[i];
+            P.clear();
+            X.clear();
+            for (auto u : adj[v])
+            {
+                if (pos[u] > pos[v])
+                    P.push_back(u);
+            }
+
+            // only the cliques with a later neighbor belong to v
+            if (P.empty())
+                continue;
+
+            Pset.clear();
+            Pset.insert(P.begin(), P.end());
+            for (auto u : adj[v])
+            {
+                if (pos[u] > pos[v])
+                    continue;
+                auto& a = adj[u];
+                bool found = false;
+                if (a.size() < P.size() * 8)
+                {
+                    for (auto w : a)
+                    {
+                        if (Pset.find(w) != Pset.end())
+                        {
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+                else
+                {
+                    for (auto w : P)
+                    {
+                        if (std::binary_search(a.begin(), a.end(), w))
+                        {
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+                if (found)
+                    X.push_back(u);
+            }
+
+            R.clear();
+            R.push_back(v);
+
+            size_t n = P.size() + X.size();
+            if (n > max_bitset)
+            {
+                expand_vec(P, X, v);
+                continue;
+            }
+
+            // local relabeling: P first, then X
+            L.clear();
+            L.insert(L.end(), P.begin(), P.end());
+            L.insert(L.end(), X.begin(), X.end());
+            lidx.clear();
+            for (size_t i = 0; i < n; ++i)
+                lidx[L[i]] = i;
+            size_t W = (n + 63) / 64;
+            rows.clear();
+            rows.resize(n * W, 0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto row = rows.data() + i * W;
+                auto& a = adj[L[i]];
+                if (a.size() < n)
+                {
+                    for (auto w : a)
+                    {
+                        auto iter = lidx.find(w);
+                        if (iter == lidx.end())
+                            continue;
+                        auto j = iter->second;
+                        row[j / 64] |= uint64_t(1) << (j % 64);
+                    }
+                }
+                else
+                {
+                    for (size_t j = 0; j < n; ++j)
+                    {
+                        if (std::binary_search(a.begin(), a.end(), L[j]))
+                            row[j / 64] |= uint64_t(1) << (j % 64);
+                    }
+                }
+            }
+            stack.clear();
+            stack.resize(4 * W, 0);
+            for (size_t i = 0; i < P.size(); ++i)
+                stack[i / 64] |= uint64_t(1) << (i % 64);
+            for (size_t i = P.size(); i < n; ++i)
+                stack[W + i / 64] |= uint64_t(1) << (i % 64);
+            expand_bits(W, 0, v);
+        }
+    }
+}
+
 } // graph_tool namespace
 
 #endif // GRAPH_MAXIMAL_CLIQUES_HH
@@ -29,144 +29,121 @@ using namespace std;
 using namespace boost;
 using namespace graph_tool;
 
+// Deterministic parallel greedy MIS, following Blelloch, Fineman and Shun
+// (2012). Each vertex gets a priority, given by its degree (lowest or highest
+// first), with ties broken by a random hash of its index. The set is
+// identical to the one obtained by the sequential greedy algorithm that
+// visits the vertices in order of priority, but it is built in rounds: in
+// each round, an undecided vertex joins the set if all its neighbors with
+// higher priority have been excluded, and is excluded if one of its neighbors
+// has joined. The decisions of a round depend only on the state at its
+// beginning, so that the result does not depend on the number of threads. The
+// number of rounds is given by the longest chain of vertices with decreasing
+// priorities that the algorithm has to resolve, which is O(log^2 V) with high
+// probability for random priorities, and is typically small otherwise.
+
 struct do_maximal_vertex_set
 {
-    template <class Graph, class VertexIndex, class VertexSet,
-              class RNG>
-    void operator()(const Graph& g, VertexIndex vertex_index, VertexSet mvs,
-                    bool high_deg, RNG& rng) const
+    template <class Graph, class VertexSet, class RNG>
+    void operator()(const Graph& g, VertexSet mvs, bool high_deg,
+                    RNG& rng) const
     {
-        typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
-
-        VertexSet marked(vertex_index, num_vertices(g));
-        vector<vertex_t> vlist;
-        double max_deg = 0, tmp_max_deg = 0;
-        typename graph_traits<Graph>::vertex_iterator v, v_end;
-        for (tie(v, v_end) = vertices(g); v != v_end; ++v)
+        size_t N = num_vertices(g);
+
+        std::uniform_int_distribution<uint64_t> sample;
+        uint64_t seed = sample(rng);
+        auto mix = [](uint64_t x)
+            {
+                // splitmix64 finalizer
+                x += 0x9e3779b97f4a7c15;
+                x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+                x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+                return x ^ (x >> 31);
+            };
+
+        // The priority and state of each vertex are stored together, to
+        // avoid two cache misses per neighbor. The priority key holds the
+        // degree in the upper half and the hash in the lower half.
+        enum : uint8_t { undecided, in, out };
+        struct node_t
         {
-            vlist.push_back(*v);
-            mvs[*v] = marked[*v] = false;
-            max_deg = max(out_degree(*v, g), max_deg);
-        }
-
-        vector<vertex_t> selected, tmp;
-        tmp.reserve(vlist.size());
-        selected.reserve(vlist.size());
-        while (!vlist.empty())
+            uint64_t key;
+            uint8_t state;
+        };
+        vector<node_t> node(N);
+        vector<uint8_t> nstate(N, undecided);
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 uint64_t k = std::min(out_degree(v, g), size_t(UINT32_MAX));
+                 if (high_deg)
+                     k = UINT32_MAX - k;
+                 node[v] = {(k << 32) | (mix(seed ^ mix(v)) >> 32), undecided};
+             });
+
+        // whether u precedes v
+        auto precedes = [&](auto u, auto v)
+            {
+                auto ku = node[u].key, kv = node[v].key;
+                return ku < kv || (ku == kv && u < v);
+            };
+
+        vector<size_t> active;
+        for (auto v : vertices_range(g))
+            active.push_back(v);
+
+        vector<size_t> next;
+        while (!active.empty())
         {
-            selected.clear();
-            tmp.clear();
-            tmp_max_deg = 0;
-
-            parallel_loop
-                (vlist,
-                 [&](size_t, auto v)
-                 {
-                     marked[v] = false;
-                     bool include = true;
-                     for (auto u : adjacent_vertices_range(v, g))
-                     {
-                         if (mvs[u])
-                         {
-                             include = false;
-                             break;
-                         }
-                     }
-                     if (!include)
-                         return;
-
-                     include = false;
-                     if (out_degree(v, g) > 0)
-                     {
-                         double p, r;
-                         if (high_deg)
-                             p = out_degree(v, g) / max_deg;
-                         else
-                             p = 1. / (2 * out_degree(v, g));
-
-
-                         uniform_real_distribution<> sample(0, 1);
-                         auto& rng_ = rng; // workaround clang
-                         #pragma omp critical
-                         {
-                             r = sample(rng_);
-                         }
-                         if (r < p)
-                             include = true;
-                     }
-                     else
-                     {
-                         include = true;
-                     }
-
-                     if (include)
-                     {
-                         marked[v] = true;
-                         auto& selected_ = selected; // workaround clang
-                         #pragma omp critical (selected)
-                         {
-                             selected_.push_back(v);
-                         }
-                     }
-                     else
-                     {
-                         auto& tmp_ = tmp;                 // workaround clang
-                         auto& tmp_max_deg_ = tmp_max_deg;
-                         #pragma omp critical (tmp)
-                         {
-                             tmp_.push_back(v);
-                             tmp_max_deg_ = max(tmp_max_deg_, out_degree(v, g));
-                         }
-                     }
-                 });
-
             parallel_loop
-                (selected,
+                (active,
                  [&](size_t, auto v)
                  {
-                     bool include = true;
-                     for (auto u : adjacent_vertices_range(v, g))
+                     bool wait = false;
+                     uint8_t s = undecided;
+                     for (auto u : out_neighbors_range(v, g))
                      {
                          if (u == v)  //skip self-loops
                              continue;
-                         if (mvs[u])
+                         auto su = node[u].state;
+                         if (su == in)
                          {
-                             include = false;
+                             s = out;
                              break;
                          }
-
-                         if (marked[u])
-                         {
-                             bool inc = ((high_deg && (out_degree(v, g) >
-                                                       out_degree(u, g))) ||
-                                         (!high_deg && (out_degree(v, g) <
-                                                   out_degree(u, g))));
-                             if (out_degree(v, g) == out_degree(u, g))
-                                 inc = v < u;
-                             include = include && inc;
-                         }
-                     }
-
-                     if (include)
-                     {
-                         mvs[v] = true;
+                         if (su == undecided && precedes(u, v))
+                             wait = true;
                      }
-                     else
-                     {
-                         auto& tmp_ = tmp;                 // workaround clang
-                         auto& tmp_max_deg_ = tmp_max_deg;
-                         #pragma omp critical (tmp)
-                         {
-                             tmp_.push_back(v);
-                             tmp_max_deg_ = max(tmp_max_deg_, out_degree(v, g));
-                         }
-                     }
-                     marked[v] = false;
+                     if (s == undecided && !wait)
+                         s = in;
+                     nstate[v] = s;
                  });
 
-            vlist = tmp;
-            max_deg = tmp_max_deg;
+            next.clear();
+            #pragma omp parallel if (active.size() > OPENMP_MIN_THRESH)
+            {
+                vector<size_t> lnext;
+                #pragma omp for schedule(static) nowait
+                for (size_t i = 0; i < active.size(); ++i)
+                {
+                    auto v = active[i];
+                    node[v].state = nstate[v];
+                    if (nstate[v] == undecided)
+                        lnext.push_back(v);
+                }
+                #pragma omp critical (next)
+                next.insert(next.end(), lnext.begin(), lnext.end());
+            }
+            active.swap(next);
         }
+
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 mvs[v] = (node[v].state == in);
+             });
     }
 };
 
@@ -178,7 +155,7 @@ void maximal_vertex_set(GraphInterface& gi, boost::any mvs, bool high_deg,
          [&](auto&& graph, auto&& a2)
          {
              return do_maximal_vertex_set()
-                 (std::forward<decltype(graph)>(graph), gi.get_vertex_index(),
+                 (std::forward<decltype(graph)>(graph),
                   std::forward<decltype(a2)>(a2), high_deg, rng);
          },
          writable_vertex_scalar_properties())(mvs);
@@ -22,6 +22,8 @@
 #include <boost/graph/kruskal_min_spanning_tree.hpp>
 #include <boost/graph/prim_minimum_spanning_tree.hpp>
 
+#include "graph_components.hh"
+
 using namespace std;
 using namespace boost;
 using namespace graph_tool;
@@ -102,6 +104,135 @@ struct get_prim_min_span_tree
     }
 };
 
+// Parallel Boruvka: in each round, every component selects its lightest
+// outgoing edge, and all the selected edges are added to the forest at once,
+// which at least halves the number of components. Ties are broken by the edge
+// index, so that the edges are totally ordered, the selected edges never form
+// cycles, and the result is the unique minimum spanning forest under this
+// order, independently of the number of threads.
+//
+// Each active vertex first finds its own lightest edge leaving its component,
+// which is stored and remains fixed during the round. The vertex with the
+// lightest such edge is then selected in each component via compare-and-swap,
+// and its edge is used to merge the components in a concurrent union-find
+// structure. Vertices without outgoing edges are never visited again, since
+// the components only grow. The whole algorithm takes O(E log V) time, but
+// the number of edges scanned typically decreases quickly with the rounds.
+
+struct get_boruvka_min_span_tree
+{
+    template <class Graph, class WeightMap, class TreeMap>
+    void operator()(const Graph& g, WeightMap weights, TreeMap tree_map) const
+    {
+        typedef typename graph_traits<Graph>::edge_descriptor edge_t;
+        typedef typename property_traits<WeightMap>::value_type val_t;
+        constexpr size_t null = numeric_limits<size_t>::max();
+
+        size_t N = num_vertices(g);
+
+        struct min_edge_t
+        {
+            val_t w;
+            size_t idx;
+            size_t u;
+            edge_t e;
+        };
+        vector<min_edge_t> vmin(N);
+        vector<size_t> comp(N);
+        vector<std::atomic<size_t>> best(N);
+        concurrent_union_find uf(N);
+
+        auto eindex = get(edge_index_t(), g);
+
+        auto lighter = [&](size_t x, size_t y)
+            {
+                auto& a = vmin[x];
+                auto& b = vmin[y];
+                return a.w < b.w || (a.w == b.w && a.idx < b.idx);
+            };
+
+        vector<size_t> active, next;
+        for (auto v : vertices_range(g))
+            active.push_back(v);
+
+        while (!active.empty())
+        {
+            parallel_loop
+                (active,
+                 [&](size_t, auto v)
+                 {
+                     auto c = uf.find(v);
+                     comp[v] = c;
+                     best[c].store(null, std::memory_order_relaxed);
+
+                     auto& m = vmin[v];
+                     m.u = null;
+                     for (auto e : out_edges_range(v, g))
+                     {
+                         auto u = target(e, g);
+                         if (uf.find(u) == c)
+                             continue;
+                         val_t w = weights[e];
+                         size_t idx = eindex[e];
+                         if (m.u == null || w < m.w ||
+                             (w == m.w && idx < m.idx))
+                             m = {w, idx, u, e};
+                     }
+                 });
+
+            parallel_loop
+                (active,
+                 [&](size_t, auto v)
+                 {
+                     if (vmin[v].u == null)
+                         return;
+                     auto& b = best[comp[v]];
+                     size_t x = b.load(std::memory_order_relaxed);
+                     while (x == null || lighter(v, x))
+                     {
+                         if (b.compare_exchange_weak(x, v))
+                             break;
+                     }
+                 });
+
+            bool merged = false;
+            #pragma omp parallel for schedule(runtime) reduction(||:merged) \
+                if (active.size() > OPENMP_MIN_THRESH)
+            for (size_t i = 0; i < active.size(); ++i)
+            {
+                auto v = active[i];
+                auto& m = vmin[v];
+                if (m.u == null ||
+                    best[comp[v]].load(std::memory_order_relaxed) != v)
+                    continue;
+                tree_map[m.e] = true;
+                uf.link(v, m.u);
+                merged = true;
+            }
+
+            if (!merged)
+                break;
+
+            next.clear();
+            #pragma omp parallel if (active.size() > OPENMP_MIN_THRESH)
+            {
+                vector<size_t> lnext;
+                #pragma omp for schedule(static) nowait
+                for (size_t i = 0; i < active.size(); ++i)
+                {
+                    auto v = active[i];
+                    uf.compress(v);
+                    if (vmin[v].u != null)
+                        lnext.push_back(v);
+                }
+                #pragma omp critical (next)
+                next.insert(next.end(), lnext.begin(), lnext.end());
+            }
+            active.swap(next);
+        }
+    }
+};
+
 typedef property_map_types::apply<mpl::vector<uint8_t>,
                                   GraphInterface::edge_index_map_t,
                                   mpl::bool_<false> >::type
@@ -154,3 +285,26 @@ void get_prim_spanning_tree(GraphInterface& gi, size_t root,
          },
          weight_maps(), tree_properties())(weight_map, tree_map);
 }
+
+void get_parallel_spanning_tree(GraphInterface& gi, boost::any weight_map,
+                                boost::any tree_map)
+{
+    typedef UnityPropertyMap<size_t,GraphInterface::edge_t> cweight_t;
+
+    if (weight_map.empty())
+        weight_map = cweight_t();
+
+    typedef mpl::push_back<edge_scalar_properties, cweight_t>::type
+        weight_maps;
+
+    run_action<graph_tool::detail::never_directed>()
+        (gi,
+         [&](auto&& graph, auto&& a2, auto&& a3)
+         {
+             return get_boruvka_min_span_tree()
+                 (std::forward<decltype(graph)>(graph),
+                  std::forward<decltype(a2)>(a2),
+                  std::forward<decltype(a3)>(a3));
+         },
+         weight_maps(), tree_properties())(weight_map, tree_map);
+}
@@ -17,6 +17,7 @@
 
 #include "graph_tool.hh"
 #include "numpy_bind.hh"
+#include "random.hh"
 
 #include "graph_percolation.hh"
 
@@ -107,6 +108,18 @@ void percolate_vertex(GraphInterface& gi, boost::any tree, boost::any size,
                                             ms, vs, second); })();
 }
 
+python::object percolate_random(GraphInterface& gi, size_t samples,
+                                bool edges, rng_t& rng)
+{
+    vector<size_t> s1, s2;
+    vector<double> avg;
+    run_action<graph_tool::detail::never_directed>()
+        (gi, [&](auto& g){ random_percolate(g, samples, edges, s1, s2, avg,
+                                            rng); })();
+    return python::make_tuple(wrap_vector_owned(s1), wrap_vector_owned(s2),
+                              wrap_vector_owned(avg));
+}
+
 #include <boost/python.hpp>
 
 void export_percolation()
@@ -115,4 +128,5 @@ void export_percolation()
 
     def("percolate_edge", percolate_edge);
     def("percolate_vertex", percolate_vertex);
+    def("percolate_random", percolate_random);
 };
@@ -18,6 +18,14 @@
 #ifndef GRAPH_PERCOLATION_HH
 #define GRAPH_PERCOLATION_HH
 
+#include <vector>
+#include <array>
+#include <algorithm>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
 namespace graph_tool
 {
 using namespace std;
@@ -154,6 +162,194 @@ void vertex_percolate(Graph& g, TreeMap tree, SizeMap size, VisitedMap visited,
     }
 }
 
+// Union-find structure for the percolation of many random orders, which
+// keeps track of the two largest component sizes, and of the sum of the
+// squared sizes.
+class percolation_state
+{
+public:
+    percolation_state(size_t N)
+        : _parent(N), _size(N), _shist(N + 1) {}
+
+    void reset()
+    {
+        std::fill(_shist.begin(), _shist.end(), 0);
+        _s1 = _s2 = _n = _sumsq = 0;
+    }
+
+    void add_vertex(size_t v)
+    {
+        _parent[v] = v;
+        _size[v] = 1;
+        _shist[1]++;
+        _n++;
+        _sumsq++;
+        update(1);
+    }
+
+    size_t find(size_t v)
+    {
+        while (_parent[v] != v)
+        {
+            _parent[v] = _parent[_parent[v]];
+            v = _parent[v];
+        }
+        return v;
+    }
+
+    void join(size_t u, size_t v)
+    {
+        auto ru = find(u);
+        auto rv = find(v);
+        if (ru == rv)
+            return;
+        auto a = _size[ru];
+        auto b = _size[rv];
+        if (a < b)
+            std::swap(ru, rv);
+        _parent[rv] = ru;
+        _size[ru] = a + b;
+        _shist[a]--;
+        _shist[b]--;
+        _shist[a + b]++;
+        _sumsq += 2 * a * b;
+        update(a + b);
+    }
+
+    size_t largest() const { return _s1; }
+    size_t second() const { return _s2; }
+
+    // average size of the component of a random vertex, excluding the largest
+    // one
+    double average() const
+    {
+        if (_n == _s1)
+            return 0;
+        return double(_sumsq - _s1 * _s1) / (_n - _s1);
+    }
+
+private:
+    // a component of size x was created
+    void update(size_t x)
+    {
+        auto s1 = std::max(_s1, x);
+        if (_shist[s1] > 1)
+        {
+            _s1 = _s2 = s1;
+            return;
+        }
+        // the second-largest component is either the previous largest one,
+        // the new one, or one no larger than the previous second-largest
+        size_t t = (_s1 < s1 && _shist[_s1] > 0) ? _s1 : _s2;
+        if (x < s1)
+            t = std::max(t, x);
+        while (t > 0 && _shist[t] == 0)
+            --t;
+        _s1 = s1;
+        _s2 = t;
+    }
+
+    std::vector<size_t> _parent, _size, _shist;
+    size_t _s1 = 0, _s2 = 0, _n = 0, _sumsq = 0;
+};
+
+// Percolation averaged over many uniformly random orders of vertex (or edge)
+// additions, which correspond to removals in the reversed order. The samples
+// are distributed among the threads, each with its own union-find buffers,
+// and use separate streams of random numbers, so that the result does not
+// depend on the number of threads (up to rounding, for avg). After the
+// addition of the i-th vertex (or edge), s1[i], s2[i] and avg[i] accumulate
+// the sizes of the largest and second-largest components, and the average
+// component size, excluding the largest one.
+template <class Graph, class RNG>
+void random_percolate(Graph& g, size_t samples, bool edges,
+                      std::vector<size_t>& s1, std::vector<size_t>& s2,
+                      std::vector<double>& avg, RNG& rng)
+{
+    size_t N = num_vertices(g);
+
+    std::vector<size_t> vs;
+    for (auto v : vertices_range(g))
+        vs.push_back(v);
+    std::vector<std::array<size_t, 2>> es;
+    if (edges)
+    {
+        for (auto e : edges_range(g))
+            es.push_back({size_t(source(e, g)), size_t(target(e, g))});
+    }
+
+    size_t n = edges ? es.size() : vs.size();
+    s1.clear();
+    s1.resize(n);
+    s2.clear();
+    s2.resize(n);
+    avg.clear();
+    avg.resize(n);
+
+    #pragma omp parallel if (samples > 1 && N > OPENMP_MIN_THRESH)
+    {
+        percolation_state state(N);
+        std::vector<size_t> ls1(n), ls2(n);
+        std::vector<double> lavg(n);
+        std::vector<size_t> order;
+        std::vector<std::array<size_t, 2>> eorder;
+        std::vector<uint8_t> present(N);
+
+        #pragma omp for schedule(runtime)
+        for (size_t r = 0; r < samples; ++r)
+        {
+            RNG rng_(rng);
+            rng_.set_stream(r + 1);
+            state.reset();
+            order = vs;
+            eorder = es;
+            auto record = [&](size_t i)
+                {
+                    ls1[i] += state.largest();
+                    ls2[i] += state.second();
+                    lavg[i] += state.average();
+                };
+            if (edges)
+            {
+                for (auto v : vs)
+                    state.add_vertex(v);
+                std::shuffle(eorder.begin(), eorder.end(), rng_);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    state.join(eorder[i][0], eorder[i][1]);
+                    record(i);
+                }
+            }
+            else
+            {
+                std::fill(present.begin(), present.end(), 0);
+                std::shuffle(order.begin(), order.end(), rng_);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    auto v = order[i];
+                    state.add_vertex(v);
+                    present[v] = true;
+                    for (auto u : out_neighbors_range(v, g))
+                    {
+                        if (present[u])
+                            state.join(v, u);
+                    }
+                    record(i);
+                }
+            }
+        }
+
+        #pragma omp critical (percolation)
+        for (size_t i = 0; i < n; ++i)
+        {
+            s1[i] += ls1[i];
+            s2[i] += ls2[i];
+            avg[i] += lavg[i];
+        }
+    }
+    rng.discard(1);
+}
+
 } // graph_tool namespace
 
 #endif // GRAPH_PERCOLATION_HH
@@ -0,0 +1,78 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "graph_tool.hh"
+#include "random.hh"
+#include "numpy_bind.hh"
+
+#include "graph_reachability.hh"
+
+#include <boost/python.hpp>
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+ReachabilityIndex* make_reachability_index(GraphInterface& gi, size_t k,
+                                           rng_t& rng)
+{
+    ReachabilityIndex* idx = nullptr;
+    run_action<>()
+        (gi,
+         [&](auto& g)
+         {
+             idx = new ReachabilityIndex(g, k, rng);
+         })();
+    return idx;
+}
+
+// answers the queries (us[i], vs[i]) in parallel
+boost::python::object reachable_array(ReachabilityIndex& idx,
+                                      boost::python::object ous,
+                                      boost::python::object ovs)
+{
+    auto us = get_array<int64_t, 1>(ous);
+    auto vs = get_array<int64_t, 1>(ovs);
+    size_t M = std::min(us.shape()[0], vs.shape()[0]);
+    vector<uint8_t> ret(M);
+
+    #pragma omp parallel if (M > OPENMP_MIN_THRESH)
+    {
+        vector<size_t> mark(idx.num_components());
+        size_t stamp = 0;
+        #pragma omp for schedule(runtime)
+        for (size_t i = 0; i < M; ++i)
+            ret[i] = idx.reachable(us[i], vs[i], mark, stamp);
+    }
+    return wrap_vector_owned(ret);
+}
+
+bool reachable(ReachabilityIndex& idx, size_t u, size_t v)
+{
+    return idx.reachable(u, v);
+}
+
+void export_reachability()
+{
+    using namespace boost::python;
+    class_<ReachabilityIndex, boost::noncopyable>("ReachabilityIndex", no_init)
+        .def("__init__", make_constructor(&make_reachability_index))
+        .def("reachable", &reachable)
+        .def("reachable_array", &reachable_array)
+        .def("component", &ReachabilityIndex::component)
+        .def("num_components", &ReachabilityIndex::num_components);
+}
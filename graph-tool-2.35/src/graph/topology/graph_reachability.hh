@@ -0,0 +1,351 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_REACHABILITY_HH
+#define GRAPH_REACHABILITY_HH
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+
+#include "graph_components.hh"
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// Reachability index of a graph, following GRAIL (Yildirim et al. 2010).
+//
+// The strongly connected components are contracted, so that vertices in the
+// same component are trivially reachable from one another, and the remaining
+// queries are answered on the condensed DAG. Each component c gets a level,
+// i.e. the length of the longest path from a source to c, and k interval
+// labels [L_i(c), R_i(c)], where R_i(c) is the post-order rank of c in the
+// i-th randomized depth-first traversal of the DAG, and L_i(c) is the
+// smallest rank among the components reachable from c. If c reaches c', then
+// level(c) < level(c') and every interval of c' is contained in the
+// corresponding interval of c, so that most negative queries are answered in
+// O(k) time. Conversely, if the rank of c' lies between the smallest rank
+// T_i(c) in the traversal subtree of c and R_i(c), then c' is a descendant of
+// c in that tree, and the query is positive. Otherwise, a depth-first search
+// from c is performed, which only enters components that pass the negative
+// tests with respect to c', and stops at those that pass the positive one.
+//
+// The components, levels and the k traversals are computed in parallel. The
+// index only holds O(V + k C + E_C) integers, where C and E_C are the number
+// of components and of edges between them.
+class ReachabilityIndex
+{
+public:
+    template <class Graph, class RNG>
+    ReachabilityIndex(Graph& g, size_t k, RNG& rng)
+        : _k(std::max(k, size_t(1)))
+    {
+        size_t N = num_vertices(g);
+
+        vector<size_t> scc;
+        if constexpr (is_directed_::apply<Graph>::type::value)
+        {
+            parallel_strong_components(g, scc);
+        }
+        else
+        {
+            concurrent_union_find uf(N);
+            afforest_components(g, uf);
+            scc.resize(N, _null);
+            parallel_vertex_loop
+                (g,
+                 [&](auto v)
+                 {
+                     scc[v] = uf.find(v);
+                 });
+        }
+
+        // the representative of each component is one of its members
+        vector<size_t> idx(N);
+        size_t C = 0;
+        for (auto v : vertices_range(g))
+        {
+            if (scc[v] == v)
+                idx[v] = C++;
+        }
+        _comp.resize(N, _null);
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 _comp[v] = idx[scc[v]];
+             });
+
+        // condensed DAG
+        _pos.resize(C + 1);
+        if constexpr (is_directed_::apply<Graph>::type::value)
+        {
+            for (auto e : edges_range(g))
+            {
+                auto c = _comp[source(e, g)];
+                if (c != _comp[target(e, g)])
+                    ++_pos[c + 1];
+            }
+            for (size_t c = 0; c < C; ++c)
+                _pos[c + 1] += _pos[c];
+            _adj.resize(_pos[C]);
+            vector<size_t> pos(_pos.begin(), _pos.end() - 1);
+            for (auto e : edges_range(g))
+            {
+                auto c = _comp[source(e, g)];
+                auto c_t = _comp[target(e, g)];
+                if (c != c_t)
+                    _adj[pos[c]++] = c_t;
+            }
+
+            vector<size_t> deg(C);
+            #pragma omp parallel for if (C > OPENMP_MIN_THRESH) \
+                schedule(runtime)
+            for (size_t c = 0; c < C; ++c)
+            {
+                auto begin = _adj.begin() + _pos[c];
+                auto end = _adj.begin() + _pos[c + 1];
+                std::sort(begin, end);
+                deg[c] = std::unique(begin, end) - begin;
+            }
+            size_t m = 0;
+            for (size_t c = 0; c < C; ++c)
+            {
+                auto begin = _pos[c];
+                _pos[c] = m;
+                for (size_t i = 0; i < deg[c]; ++i)
+                    _adj[m++] = _adj[begin + i];
+            }
+            _pos[C] = m;
+            _adj.resize(m);
+            _adj.shrink_to_fit();
+        }
+
+        // levels, by peeling the sources
+        _level.resize(C);
+        vector<std::atomic<size_t>> indeg(C);
+        for (auto c : _adj)
+            indeg[c].fetch_add(1, std::memory_order_relaxed);
+        vector<size_t> sources, frontier, next;
+        for (size_t c = 0; c < C; ++c)
+        {
+            if (indeg[c].load(std::memory_order_relaxed) == 0)
+                sources.push_back(c);
+        }
+        frontier = sources;
+        for (size_t l = 0; !frontier.empty(); ++l)
+        {
+            next.clear();
+            #pragma omp parallel if (frontier.size() > OPENMP_MIN_THRESH)
+            {
+                vector<size_t> lnext;
+                #pragma omp for schedule(runtime) nowait
+                for (size_t i = 0; i < frontier.size(); ++i)
+                {
+                    auto c = frontier[i];
+                    _level[c] = l;
+                    for (size_t j = _pos[c]; j < _pos[c + 1]; ++j)
+                    {
+                        auto w = _adj[j];
+                        if (indeg[w].fetch_sub(1, std::memory_order_relaxed)
+                            == 1)
+                            lnext.push_back(w);
+                    }
+                }
+                #pragma omp critical (next)
+                next.insert(next.end(), lnext.begin(), lnext.end());
+            }
+            frontier.swap(next);
+        }
+
+        // interval labels
+        _labels.resize(C * _k);
+        vector<RNG> rngs;
+        for (size_t i = 0; i < _k; ++i)
+        {
+            rngs.emplace_back(rng);
+            rngs.back().set_stream(i + 1);
+        }
+        rng.discard(1);
+
+        #pragma omp parallel for schedule(dynamic, 1) \
+            if (_k > 1 && C > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < _k; ++i)
+            label(i, sources, rngs[i]);
+
+        _mark.resize(C);
+    }
+
+    // returns true if v can be reached from u, or if u == v
+    bool reachable(size_t u, size_t v)
+    {
+        return reachable(u, v, _mark, _stamp);
+    }
+
+    bool reachable(size_t u, size_t v, vector<size_t>& mark, size_t& stamp)
+        const
+    {
+        if (u >= _comp.size() || v >= _comp.size())
+            return false;
+        auto cu = _comp[u];
+        auto cv = _comp[v];
+        if (cu == _null || cv == _null)
+            return false;
+        if (cu == cv)
+            return true;
+        if (!admissible(cu, cv))
+            return false;
+        if (descendant(cu, cv))
+            return true;
+
+        if (++stamp == 0)
+        {
+            std::fill(mark.begin(), mark.end(), 0);
+            stamp = 1;
+        }
+        vector<size_t> stack = {cu};
+        mark[cu] = stamp;
+        while (!stack.empty())
+        {
+            auto c = stack.back();
+            stack.pop_back();
+            for (size_t j = _pos[c]; j < _pos[c + 1]; ++j)
+            {
+                auto w = _adj[j];
+                if (w == cv)
+                    return true;
+                if (mark[w] == stamp || !admissible(w, cv))
+                    continue;
+                if (descendant(w, cv))
+                    return true;
+                mark[w] = stamp;
+                stack.push_back(w);
+            }
+        }
+        return false;
+    }
+
+    size_t num_components() const { return _level.size(); }
+
+    size_t component(size_t v) const
+    {
+        return (v < _comp.size()) ? _comp[v] : _null;
+    }
+
+private:
+    // returns false if c certainly does not reach c_t
+    bool admissible(size_t c, size_t c_t) const
+    {
+        if (_level[c] >= _level[c_t])
+            return false;
+        auto lc = _labels.begin() + c * _k;
+        auto lt = _labels.begin() + c_t * _k;
+        for (size_t i = 0; i < _k; ++i)
+        {
+            if (lt[i][0] < lc[i][0] || lt[i][1] > lc[i][1])
+                return false;
+        }
+        return true;
+    }
+
+    // returns true if c_t is a descendant of c in one of the traversals
+    bool descendant(size_t c, size_t c_t) const
+    {
+        auto lc = _labels.begin() + c * _k;
+        auto lt = _labels.begin() + c_t * _k;
+        for (size_t i = 0; i < _k; ++i)
+        {
+            if (lt[i][1] >= lc[i][2] && lt[i][1] <= lc[i][1])
+                return true;
+        }
+        return false;
+    }
+
+    // randomized post-order traversal of the DAG, starting from the sources
+    // in random order, and visiting the out-neighbors of each component in a
+    // random cyclic order
+    template <class RNG>
+    void label(size_t i, vector<size_t> sources, RNG& rng)
+    {
+        size_t C = _level.size();
+        std::shuffle(sources.begin(), sources.end(), rng);
+
+        vector<uint8_t> visited(C);
+        // (component, offset, count, first rank in the subtree)
+        vector<std::array<size_t, 4>> stack;
+        size_t rank = 0;
+        for (auto s : sources)
+        {
+            auto push = [&](size_t c)
+                {
+                    visited[c] = true;
+                    size_t deg = _pos[c + 1] - _pos[c];
+                    size_t offset = 0;
+                    if (deg > 1)
+                    {
+                        std::uniform_int_distribution<size_t>
+                            rand(0, deg - 1);
+                        offset = rand(rng);
+                    }
+                    stack.push_back({c, offset, 0, rank + 1});
+                };
+            push(s);
+            while (!stack.empty())
+            {
+                auto& [c, offset, j, t] = stack.back();
+                size_t deg = _pos[c + 1] - _pos[c];
+                if (j < deg)
+                {
+                    auto w = _adj[_pos[c] + (offset + j) % deg];
+                    ++j;
+                    if (!visited[w])
+                        push(w);
+                    continue;
+                }
+                auto r = ++rank;
+                auto l = r;
+                for (size_t m = _pos[c]; m < _pos[c + 1]; ++m)
+                    l = std::min(l, _labels[_adj[m] * _k + i][0]);
+                _labels[c * _k + i] = {l, r, t};
+                stack.pop_back();
+            }
+        }
+    }
+
+    static constexpr size_t _null = numeric_limits<size_t>::max();
+
+    size_t _k;
+    vector<size_t> _comp;                  // component of each vertex
+    vector<size_t> _pos, _adj;             // condensed DAG
+    vector<size_t> _level;
+    vector<std::array<size_t, 3>> _labels; // k labels (L, R, T) per component
+
+    vector<size_t> _mark;
+    size_t _stamp = 0;
+};
+
+} // graph_tool namespace
+
+#endif // GRAPH_REACHABILITY_HH
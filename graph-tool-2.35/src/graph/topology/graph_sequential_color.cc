@@ -55,3 +55,217 @@ size_t sequential_coloring(GraphInterface& gi, boost::any order,
          vertex_integer_properties(), int_properties())(order, color);
     return nc;
 }
+
+// Jones-Plassmann coloring: each vertex is colored with the smallest color not
+// used by its neighbors that precede it in the given order, as soon as all of
+// them are colored. This gives exactly the same coloring as the sequential
+// greedy algorithm, but the vertices without uncolored predecessors are
+// colored in parallel, in rounds. The number of rounds is the length of the
+// longest chain of neighbors with increasing positions in the order.
+
+struct get_parallel_coloring
+{
+    template <class Graph, class OrderMap, class ColorMap>
+    void operator()(Graph& g, OrderMap order, ColorMap color, size_t& nc) const
+    {
+        size_t N = num_vertices(g);
+        constexpr size_t null = numeric_limits<size_t>::max();
+
+        vector<size_t> rank(N, null);
+        for (size_t i = 0; i < N; ++i)
+        {
+            size_t v = order[i];
+            if (v < N && rank[v] == null)
+                rank[v] = i;
+        }
+        for (size_t v = 0; v < N; ++v)
+        {
+            if (rank[v] == null)
+                rank[v] = N + v;
+        }
+
+        // number of uncolored predecessors
+        vector<size_t> count(N);
+        parallel_vertex_loop
+            (g,
+             [&](auto v)
+             {
+                 for (auto u : out_neighbors_range(v, g))
+                 {
+                     if (rank[u] < rank[v])
+                         count[v]++;
+                 }
+             });
+
+        vector<size_t> frontier, next;
+        for (auto v : vertices_range(g))
+        {
+            if (count[v] == 0)
+                frontier.push_back(v);
+        }
+
+        size_t max_color = 0;
+        bool empty = frontier.empty();
+        while (!frontier.empty())
+        {
+            next.clear();
+            #pragma omp parallel if (frontier.size() > OPENMP_MIN_THRESH) \
+                reduction(max:max_color)
+            {
+                vector<uint8_t> used;
+                vector<size_t> lnext;
+
+                #pragma omp for schedule(runtime)
+                for (size_t i = 0; i < frontier.size(); ++i)
+                {
+                    auto v = frontier[i];
+                    used.clear();
+                    used.resize(out_degree(v, g) + 1, false);
+                    for (auto u : out_neighbors_range(v, g))
+                    {
+                        if (rank[u] >= rank[v])
+                            continue;
+                        size_t c = color[u];
+                        if (c < used.size())
+                            used[c] = true;
+                    }
+                    size_t c = 0;
+                    while (used[c])
+                        ++c;
+                    color[v] = c;
+                    max_color = std::max(max_color, c);
+                }
+
+                #pragma omp for schedule(runtime) nowait
+                for (size_t i = 0; i < frontier.size(); ++i)
+                {
+                    auto v = frontier[i];
+                    for (auto u : out_neighbors_range(v, g))
+                    {
+                        if (rank[u] <= rank[v])
+                            continue;
+                        size_t k;
+                        #pragma omp atomic capture
+                        k = --count[u];
+                        if (k == 0)
+                            lnext.push_back(u);
+                    }
+                }
+
+                #pragma omp critical (next)
+                next.insert(next.end(), lnext.begin(), lnext.end());
+            }
+            frontier.swap(next);
+        }
+        nc = empty ? 0 : max_color + 1;
+    }
+};
+
+size_t parallel_coloring(GraphInterface& gi, boost::any order,
+                         boost::any color)
+{
+    size_t nc = 0;
+    run_action<>()
+        (gi,
+         [&](auto&& graph, auto&& a2, auto&& a3)
+         {
+             return get_parallel_coloring()
+                 (std::forward<decltype(graph)>(graph),
+                  std::forward<decltype(a2)>(a2),
+                  std::forward<decltype(a3)>(a3), nc);
+         },
+         vertex_integer_properties(), int_properties())(order, color);
+    return nc;
+}
+
+// Coloring orders: largest degree first (kind == 0), and smallest last (kind
+// == 1), i.e. the reverse of the order in which the vertices are removed when
+// the graph is peeled by always removing a vertex of smallest remaining
+// degree. Both are computed in O(V + E) time with bucket queues.
+
+struct get_coloring_order
+{
+    template <class Graph, class OrderMap>
+    void operator()(Graph& g, OrderMap order, int kind) const
+    {
+        size_t N = num_vertices(g);
+        vector<size_t> deg(N), vs;
+        size_t max_deg = 0;
+        for (auto v : vertices_range(g))
+        {
+            for (auto u : out_neighbors_range(v, g))
+            {
+                if (u != v)
+                    deg[v]++;
+            }
+            max_deg = std::max(max_deg, deg[v]);
+            vs.push_back(v);
+        }
+
+        vector<vector<size_t>> bins(max_deg + 1);
+        vector<size_t> vert;
+        if (kind == 0)
+        {
+            // largest degree first, with ties broken by the index
+            for (auto v : vs)
+                bins[deg[v]].push_back(v);
+            for (size_t k = max_deg + 1; k > 0; --k)
+                vert.insert(vert.end(), bins[k - 1].begin(), bins[k - 1].end());
+        }
+        else
+        {
+            // smallest last; the bins may contain stale entries, which are
+            // skipped
+            for (auto v : vs)
+                bins[deg[v]].push_back(v);
+            vector<bool> removed(N, false);
+            size_t k = 0;
+            while (vert.size() < vs.size())
+            {
+                while (bins[k].empty())
+                    ++k;
+                auto v = bins[k].back();
+                bins[k].pop_back();
+                if (removed[v] || deg[v] != k)
+                    continue;
+                removed[v] = true;
+                vert.push_back(v);
+                for (auto u : out_neighbors_range(v, g))
+                {
+                    if (u == v || removed[u])
+                        continue;
+                    deg[u]--;
+                    bins[deg[u]].push_back(u);
+                    k = std::min(k, deg[u]);
+                }
+            }
+            std::reverse(vert.begin(), vert.end());
+        }
+
+        vector<bool> placed(N, false);
+        size_t i = 0;
+        for (auto v : vert)
+        {
+            order[i++] = v;
+            placed[v] = true;
+        }
+        for (size_t v = 0; v < N; ++v)
+        {
+            if (!placed[v])
+                order[i++] = v;
+        }
+    }
+};
+
+void coloring_order(GraphInterface& gi, boost::any order, int kind)
+{
+    run_action<>()
+        (gi,
+         [&](auto&& graph, auto&& a2)
+         {
+             return get_coloring_order()
+                 (std::forward<decltype(graph)>(graph),
+                  std::forward<decltype(a2)>(a2), kind);
+         },
+         writable_vertex_scalar_properties())(order);
+}
@@ -76,8 +76,14 @@ python::object similarity_fast(GraphInterface& gi1, GraphInterface& gi2,
                                boost::any label1, boost::any label2,
                                double norm, bool asym);
 
+python::object similarity_sorted(GraphInterface& gi1, GraphInterface& gi2,
+                                 boost::any weight1, boost::any weight2,
+                                 boost::any label1, boost::any label2,
+                                 double norm, bool asym);
+
 void export_similarity()
 {
     python::def("similarity", &similarity);
     python::def("similarity_fast", &similarity_fast);
+    python::def("similarity_sorted", &similarity_sorted);
 };
@@ -20,6 +20,11 @@
 
 #include "hash_map_wrap.hh"
 #include "idx_map.hh"
+#include "graph_intersect.hh"
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
 
 namespace graph_tool
 {
@@ -51,13 +56,97 @@ auto set_difference(Keys& ks, Set1& s1, Set2& s2, double norm, bool asym)
     return s;
 }
 
+// Same as above, but for label-weight pairs sorted by label
+template <bool normed, class SAdj>
+auto sorted_set_difference(SAdj& s1, SAdj& s2, double norm, bool asym)
+{
+    typename SAdj::value_type::second_type s = 0, x1, x2;
+    auto ndispatch = [&](auto x){ return normed ? std::pow(x, norm) : x; };
+    size_t i = 0, j = 0;
+    while (i < s1.size() || j < s2.size())
+    {
+        if (j == s2.size() || (i < s1.size() && s1[i].first < s2[j].first))
+        {
+            x1 = s1[i++].second;
+            x2 = 0;
+        }
+        else if (i == s1.size() || s2[j].first < s1[i].first)
+        {
+            x1 = 0;
+            x2 = s2[j++].second;
+        }
+        else
+        {
+            x1 = s1[i++].second;
+            x2 = s2[j++].second;
+        }
+        if (x1 > x2)
+            s += ndispatch(x1 - x2);
+        else if (!asym)
+            s += ndispatch(x2 - x1);
+    }
+    return s;
+}
+
+// Collects the labels of the out-neighbors of v, together with the summed
+// weights of the corresponding edges, in ascending order of label. This is done
+// by merging, and succeeds only if the labels are already sorted along the
+// edge lists, which is the case if the adjacency is sorted and the labels are
+// increasing with the vertex index (e.g. the default labels). Otherwise, false
+// is returned.
+template <class Vertex, class WeightMap, class LabelMap, class Graph,
+          class SAdj>
+bool get_sorted_labels(Vertex v, WeightMap& ew, LabelMap& l, const Graph& g,
+                       SAdj& sadj)
+{
+    sadj.clear();
+    if (v == graph_traits<Graph>::null_vertex())
+        return true;
+    for (auto e : out_edges_range(v, g))
+        sadj.emplace_back(get(l, target(e, g)), ew[e]);
+
+    // undirected views consist of two runs, which need to be merged
+    auto cmp = [](auto& a, auto& b) { return a.first < b.first; };
+    auto iter = std::is_sorted_until(sadj.begin(), sadj.end(), cmp);
+    if (iter != sadj.end())
+    {
+        if (!std::is_sorted(iter, sadj.end(), cmp))
+            return false;
+        std::inplace_merge(sadj.begin(), iter, sadj.end(), cmp);
+    }
+
+    auto last = sadj.begin();
+    for (auto pos = sadj.begin(); pos != sadj.end(); ++pos)
+    {
+        if (pos == last)
+            continue;
+        if (pos->first == last->first)
+            last->second += pos->second;
+        else
+            *(++last) = *pos;
+    }
+    if (!sadj.empty())
+        sadj.erase(last + 1, sadj.end());
+    return true;
+}
+
 template <class Vertex, class WeightMap, class LabelMap,
-          class Graph1, class Graph2, class Keys, class Adj>
+          class Graph1, class Graph2, class Keys, class Adj, class SAdj>
 auto vertex_difference(Vertex v1, Vertex v2, WeightMap& ew1, WeightMap& ew2,
                        LabelMap& l1, LabelMap& l2, const Graph1& g1,
                        const Graph2& g2, bool asym, Keys& keys, Adj& adj1,
-                       Adj& adj2, double norm)
+                       Adj& adj2, SAdj& sadj1, SAdj& sadj2, double norm)
 {
+    if (has_sorted_adjacency(g1) && has_sorted_adjacency(g2) &&
+        get_sorted_labels(v1, ew1, l1, g1, sadj1) &&
+        get_sorted_labels(v2, ew2, l2, g2, sadj2))
+    {
+        if (norm == 1)
+            return sorted_set_difference<false>(sadj1, sadj2, 1, asym);
+        else
+            return sorted_set_difference<true>(sadj1, sadj2, norm, asym);
+    }
+
     if (v1 != graph_traits<Graph1>::null_vertex())
     {
         for (auto e : out_edges_range(v1, g1))
@@ -103,6 +192,8 @@ auto get_similarity(const Graph1& g1, const Graph2& g2, WeightMap ew1,
     for (auto v : vertices_range(g2))
         lmap2[get(l2, v)] = v;
 
+    vector<pair<label_t, val_t>> sadj1, sadj2;
+
     val_t s = 0;
     for (auto& lv1 : lmap1)
     {
@@ -119,7 +210,7 @@ auto get_similarity(const Graph1& g1, const Graph2& g2, WeightMap ew1,
         std::unordered_map<label_t, val_t> adj1, adj2;
 
         s += vertex_difference(v1, v2, ew1, ew2, l1, l2, g1, g2, asym, keys,
-                               adj1, adj2, norm);
+                               adj1, adj2, sadj1, sadj2, norm);
     }
 
     if (!asym)
@@ -139,7 +230,7 @@ auto get_similarity(const Graph1& g1, const Graph2& g2, WeightMap ew1,
             std::unordered_map<label_t, val_t> adj1, adj2;
 
             s += vertex_difference(v1, v2, ew1, ew2, l1, l2, g1, g2, false,
-                                   keys, adj1, adj2, norm);
+                                   keys, adj1, adj2, sadj1, sadj2, norm);
         }
     }
     return s;
@@ -178,10 +269,11 @@ auto get_similarity_fast(const Graph1& g1, const Graph2& g2, WeightMap ew1,
 
     idx_set<label_t> keys;
     idx_map<label_t, val_t> adj1, adj2;
+    vector<pair<label_t, val_t>> sadj1, sadj2;
 
     val_t s = 0;
     #pragma omp parallel if (num_vertices(g1) > OPENMP_MIN_THRESH) \
-        reduction(+:s) firstprivate(keys, adj1, adj2)
+        reduction(+:s) firstprivate(keys, adj1, adj2, sadj1, sadj2)
     parallel_loop_no_spawn
         (lmap1,
          [&](size_t i, auto v1)
@@ -194,13 +286,13 @@ auto get_similarity_fast(const Graph1& g1, const Graph2& g2, WeightMap ew1,
              adj1.clear();
              adj2.clear();
              s += vertex_difference(v1, v2, ew1, ew2, l1, l2, g1, g2, asym,
-                                    keys, adj1, adj2, norm);
+                                    keys, adj1, adj2, sadj1, sadj2, norm);
          });
 
     if (!asym)
     {
         #pragma omp parallel if (num_vertices(g2) > OPENMP_MIN_THRESH)  \
-            reduction(+:s) firstprivate(keys, adj1, adj2)
+            reduction(+:s) firstprivate(keys, adj1, adj2, sadj1, sadj2)
         parallel_loop_no_spawn
             (lmap2,
              [&](size_t i, auto v2)
@@ -213,13 +305,205 @@ auto get_similarity_fast(const Graph1& g1, const Graph2& g2, WeightMap ew1,
                  adj1.clear();
                  adj2.clear();
                  s += vertex_difference(v1, v2, ew1, ew2, l1, l2, g1, g2, false,
-                                        keys, adj1, adj2, norm);
+                                        keys, adj1, adj2, sadj1, sadj2, norm);
              });
     }
 
     return s;
 }
 
+// Sorts the vector in parallel, by sorting contiguous chunks in each thread,
+// and merging them pairwise in rounds.
+template <class Vec, class Cmp>
+void parallel_sort(Vec& v, Cmp&& cmp)
+{
+    size_t nt = 1;
+#ifdef _OPENMP
+    if (v.size() > OPENMP_MIN_THRESH)
+        nt = omp_get_max_threads();
+#endif
+    if (nt == 1)
+    {
+        std::sort(v.begin(), v.end(), cmp);
+        return;
+    }
+
+    vector<size_t> bounds(nt + 1);
+    for (size_t i = 0; i <= nt; ++i)
+        bounds[i] = (i * v.size()) / nt;
+
+    #pragma omp parallel for schedule(static, 1)
+    for (size_t i = 0; i < nt; ++i)
+        std::sort(v.begin() + bounds[i], v.begin() + bounds[i + 1], cmp);
+
+    for (size_t w = 1; w < nt; w *= 2)
+    {
+        #pragma omp parallel for schedule(static, 1)
+        for (size_t i = 0; i < nt; i += 2 * w)
+        {
+            if (i + w >= nt)
+                continue;
+            std::inplace_merge(v.begin() + bounds[i],
+                               v.begin() + bounds[i + w],
+                               v.begin() + bounds[std::min(i + 2 * w, nt)],
+                               cmp);
+        }
+    }
+}
+
+// Fills `es` with the (source label, target label, weight) triples of all the
+// (out-)edges of the graph, sorted lexicographically. In undirected graphs
+// every edge appears in both directions.
+template <class Graph, class WeightMap, class LabelMap, class Val>
+void get_label_edges(const Graph& g, WeightMap& ew, LabelMap& l,
+                     vector<std::tuple<int64_t, int64_t, Val>>& es)
+{
+    size_t N = num_vertices(g);
+    vector<size_t> pos(N + 1, 0);
+    for (auto v : vertices_range(g))
+        pos[v + 1] = out_degree(v, g);
+    for (size_t i = 0; i < N; ++i)
+        pos[i + 1] += pos[i];
+
+    es.resize(pos[N]);
+    parallel_vertex_loop
+        (g,
+         [&](auto v)
+         {
+             auto i = pos[v];
+             int64_t lv = get(l, v);
+             for (auto e : out_edges_range(v, g))
+                 es[i++] = std::make_tuple(lv, int64_t(get(l, target(e, g))),
+                                           Val(ew[e]));
+         });
+
+    auto cmp = [](auto& a, auto& b)
+        {
+            return (get<0>(a) < get<0>(b) ||
+                    (get<0>(a) == get<0>(b) && get<1>(a) < get<1>(b)));
+        };
+
+    // with sorted adjacency and labels that increase with the vertex index,
+    // the array only needs to be sorted in undirected graphs
+    if (!std::is_sorted(es.begin(), es.end(), cmp))
+        parallel_sort(es, cmp);
+}
+
+// Sort-merge version of get_similarity(), which compares the lexicographically
+// sorted edge arrays of both graphs, keyed by the (integer) labels of the
+// endpoints. The arrays are split in ranges of source labels which are merged
+// in parallel, and the contribution of each row of the adjacency matrix (i.e.
+// each source label) with a non-zero difference is stored in `labels` and
+// `diffs`, in ascending order of label.
+template <class Graph1, class Graph2, class WeightMap, class LabelMap>
+auto get_similarity_sorted(const Graph1& g1, const Graph2& g2, WeightMap ew1,
+                           WeightMap ew2, LabelMap l1, LabelMap l2,
+                           double norm, bool asym, vector<int64_t>& labels,
+                           vector<double>& diffs)
+{
+    typedef typename property_traits<WeightMap>::value_type val_t;
+    typedef std::tuple<int64_t, int64_t, val_t> item_t;
+
+    vector<item_t> es1, es2;
+    get_label_edges(g1, ew1, l1, es1);
+    get_label_edges(g2, ew2, l2, es2);
+
+    size_t nt = 1;
+#ifdef _OPENMP
+    if (es1.size() + es2.size() > OPENMP_MIN_THRESH)
+        nt = omp_get_max_threads();
+#endif
+
+    // split points, at the boundaries between source labels
+    vector<size_t> b1(nt + 1, es1.size()), b2(nt + 1, es2.size());
+    b1[0] = b2[0] = 0;
+    auto lcmp = [](auto& a, int64_t x) { return get<0>(a) < x; };
+    for (size_t i = 1; i < nt; ++i)
+    {
+        size_t j = (i * es1.size()) / nt;
+        if (j >= es1.size())
+            break;
+        auto x = get<0>(es1[j]);
+        b1[i] = std::lower_bound(es1.begin(), es1.end(), x, lcmp) - es1.begin();
+        b2[i] = std::lower_bound(es2.begin(), es2.end(), x, lcmp) - es2.begin();
+    }
+
+    auto ndiff = [&](val_t x1, val_t x2) -> val_t
+        {
+            val_t d;
+            if (x1 > x2)
+                d = x1 - x2;
+            else if (!asym)
+                d = x2 - x1;
+            else
+                return 0;
+            return (norm == 1) ? d : std::pow(d, norm);
+        };
+
+    vector<vector<int64_t>> tlabels(nt);
+    vector<vector<double>> tdiffs(nt);
+    val_t s = 0;
+
+    #pragma omp parallel for schedule(static, 1) reduction(+:s)
+    for (size_t t = 0; t < nt; ++t)
+    {
+        size_t i = b1[t], i_end = b1[t + 1];
+        size_t j = b2[t], j_end = b2[t + 1];
+        auto& ls = tlabels[t];
+        auto& ds = tdiffs[t];
+        int64_t row = 0;
+        val_t rs = 0;
+        bool active = false;
+        while (i < i_end || j < j_end)
+        {
+            // next (source, target) pair in either array
+            std::pair<int64_t, int64_t> k;
+            if (j == j_end ||
+                (i < i_end &&
+                 std::make_pair(get<0>(es1[i]), get<1>(es1[i])) <
+                 std::make_pair(get<0>(es2[j]), get<1>(es2[j]))))
+                k = {get<0>(es1[i]), get<1>(es1[i])};
+            else
+                k = {get<0>(es2[j]), get<1>(es2[j])};
+
+            if (!active || k.first != row)
+            {
+                if (active && rs != 0)
+                {
+                    ls.push_back(row);
+                    ds.push_back(rs);
+                }
+                s += rs;
+                row = k.first;
+                rs = 0;
+                active = true;
+            }
+
+            val_t x1 = 0, x2 = 0;
+            for (; i < i_end && get<0>(es1[i]) == k.first &&
+                     get<1>(es1[i]) == k.second; ++i)
+                x1 += get<2>(es1[i]);
+            for (; j < j_end && get<0>(es2[j]) == k.first &&
+                     get<1>(es2[j]) == k.second; ++j)
+                x2 += get<2>(es2[j]);
+            rs += ndiff(x1, x2);
+        }
+        if (active && rs != 0)
+        {
+            ls.push_back(row);
+            ds.push_back(rs);
+        }
+        s += rs;
+    }
+
+    for (size_t t = 0; t < nt; ++t)
+    {
+        labels.insert(labels.end(), tlabels[t].begin(), tlabels[t].end());
+        diffs.insert(diffs.end(), tdiffs[t].begin(), tdiffs[t].end());
+    }
+    return s;
+}
+
 } // graph_tool namespace
 
 #endif // GRAPH_SIMILARITY_HH
@@ -0,0 +1,175 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include "graph_tool.hh"
+#include "numpy_bind.hh"
+#include "coroutine.hh"
+#include "graph_python_interface.hh"
+
+#include "graph_subgraph_match.hh"
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+typedef vprop_map_t<int64_t>::type vlabel_t;
+typedef mpl::vector2<typename vlabel_t::unchecked_t,
+                     UnityPropertyMap<bool,
+                                      GraphInterface::vertex_t> > vertex_props_t;
+
+typedef eprop_map_t<int64_t>::type elabel_t;
+typedef mpl::vector2<typename elabel_t::unchecked_t,
+                     UnityPropertyMap<bool,
+                                      GraphInterface::edge_t> > edge_props_t;
+
+// Returns the number of matches and, unless count_only is true, the matches
+// concatenated in a flat array, with one row per match, and one column per
+// vertex of the subgraph. The matches are grouped by the image of the first
+// vertex in the matching order, in increasing order of index, so that the
+// output does not depend on the number of threads, unless max_n > 0.
+boost::python::object
+get_subgraph_match(GraphInterface& gi1, GraphInterface& gi2,
+                   boost::any vertex_label1, boost::any vertex_label2,
+                   boost::any edge_label1, boost::any edge_label2,
+                   size_t max_n, bool induced, bool iso, bool count_only,
+                   bool generator)
+{
+    if (gi1.get_directed() != gi2.get_directed())
+        return boost::python::object();
+
+    if (vertex_label1.empty() || vertex_label2.empty())
+    {
+        vertex_label1 = vertex_label2 =
+            UnityPropertyMap<bool,GraphInterface::vertex_t>();
+    }
+    else
+    {
+        vertex_label1 = any_cast<vlabel_t>(vertex_label1).get_unchecked(num_vertices(gi1.get_graph()));
+        vertex_label2 = any_cast<vlabel_t>(vertex_label2).get_unchecked(num_vertices(gi2.get_graph()));
+    }
+
+    if (edge_label1.empty() || edge_label2.empty())
+    {
+        edge_label1 = edge_label2 =
+            UnityPropertyMap<bool,GraphInterface::edge_t>();
+    }
+    else
+    {
+        edge_label1 = any_cast<elabel_t>(edge_label1).get_unchecked(gi1.get_edge_index_range());
+        edge_label2 = any_cast<elabel_t>(edge_label2).get_unchecked(gi2.get_edge_index_range());
+    }
+
+    if (generator)
+    {
+#ifdef HAVE_BOOST_COROUTINE
+        auto dispatch = [&](auto& yield)
+        {
+            gt_dispatch<>()
+                ([&](auto& sub, auto& g, auto vlabel1, auto elabel1)
+                 {
+                     auto vlabel2 = any_cast<decltype(vlabel1)>(vertex_label2);
+                     auto elabel2 = any_cast<decltype(elabel1)>(edge_label2);
+                     subgraph_match(sub, g, vlabel1, vlabel2, elabel1, elabel2,
+                                    induced, iso, false,
+                                    [&](size_t, size_t, auto& match)
+                                    {
+                                        yield(wrap_vector_owned(match));
+                                        return true;
+                                    });
+                 },
+                 all_graph_views(), all_graph_views(), vertex_props_t(),
+                 edge_props_t())(gi1.get_graph_view(), gi2.get_graph_view(),
+                                 vertex_label1, edge_label1);
+        };
+        return boost::python::object(CoroGenerator(dispatch));
+#else
+        throw GraphException("This functionality is not available because boost::coroutine was not found at compile-time");
+#endif // HAVE_BOOST_COROUTINE
+    }
+
+    size_t count = 0;
+    std::vector<size_t> flat;
+    gt_dispatch<>()
+        ([&](auto& sub, auto& g, auto vlabel1, auto elabel1)
+         {
+             auto vlabel2 = any_cast<decltype(vlabel1)>(vertex_label2);
+             auto elabel2 = any_cast<decltype(elabel1)>(edge_label2);
+
+             size_t nthreads = 1;
+#ifdef _OPENMP
+             nthreads = omp_get_max_threads();
+#endif
+             std::vector<std::vector<size_t>> tflat(count_only ? 0 : nthreads);
+             // (root, thread, position) of each match
+             std::vector<std::vector<std::array<size_t, 3>>>
+                 trecs(count_only ? 0 : nthreads);
+
+             subgraph_match(sub, g, vlabel1, vlabel2, elabel1, elabel2,
+                            induced, iso, true,
+                            [&](size_t tid, size_t root, auto& match)
+                            {
+                                size_t c;
+                                #pragma omp atomic capture
+                                c = ++count;
+                                if (max_n > 0 && c > max_n)
+                                    return false;
+                                if (!count_only)
+                                {
+                                    auto& f = tflat[tid];
+                                    trecs[tid].push_back({root, tid, f.size()});
+                                    f.insert(f.end(), match.begin(),
+                                             match.end());
+                                }
+                                return max_n == 0 || c < max_n;
+                            });
+
+             if (max_n > 0)
+                 count = std::min(count, max_n);
+             if (count_only)
+                 return;
+
+             size_t n = 0;
+             for (auto v : vertices_range(sub))
+             {
+                 (void) v;
+                 ++n;
+             }
+             std::vector<std::array<size_t, 3>> recs;
+             for (auto& r : trecs)
+                 recs.insert(recs.end(), r.begin(), r.end());
+             std::sort(recs.begin(), recs.end());
+             flat.reserve(recs.size() * n);
+             for (auto& r : recs)
+             {
+                 auto& f = tflat[r[1]];
+                 flat.insert(flat.end(), f.begin() + r[2],
+                             f.begin() + r[2] + n);
+             }
+         },
+         all_graph_views(), all_graph_views(), vertex_props_t(),
+         edge_props_t())(gi1.get_graph_view(), gi2.get_graph_view(),
+                         vertex_label1, edge_label1);
+
+    if (count_only)
+        return boost::python::object(count);
+    return boost::python::make_tuple(count, wrap_vector_owned(flat));
+}
+
+void export_subgraph_match()
+{
+    boost::python::def("subgraph_match", &get_subgraph_match);
+};
@@ -0,0 +1,524 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_SUBGRAPH_MATCH_HH
+#define GRAPH_SUBGRAPH_MATCH_HH
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+namespace graph_tool
+{
+
+using namespace boost;
+
+// Subgraph matching with candidate filtering, in the spirit of VF3 and the
+// Glasgow subgraph solver.
+//
+// Each pattern vertex u gets a domain of host vertices, stored as a bitset,
+// containing the vertices with the same label and large enough in- and
+// out-degrees (or identical degrees, if iso == true). The domains are then
+// pruned by requiring that every candidate w of u has, for every pattern
+// neighbor u' of u, a host neighbor in the same direction belonging to the
+// domain of u'.
+//
+// The pattern vertices are matched in a fixed order, starting from the one
+// with the smallest domain, and then always picking the vertex with the most
+// connections to the ones already ordered. The candidates of a vertex are the
+// neighbors of the image of one of its already matched pattern neighbors (the
+// one of smallest degree), intersected with its domain, so that the search
+// never scans the whole host graph past the first level. Each candidate is
+// then checked against all matched vertices, by comparing the multisets of
+// edge labels between them: the pattern edges must be contained in the host
+// edges, or be identical if induced == true.
+//
+// The search tree is split at the first pattern vertex, whose candidates are
+// distributed dynamically among the threads, the most connected ones first.
+// The function f(tid, root, match) is called for every match found, where
+// root is the image of the first pattern vertex, and match[i] is the image of
+// the i-th pattern vertex, in the order of vertices(sub). If f returns false,
+// the whole search is stopped. Nothing is stored, so the memory requirement
+// is O(V) independently of the number of matches.
+
+template <class Graph1, class Graph2, class VLabel1, class VLabel2,
+          class ELabel1, class ELabel2, class F>
+void subgraph_match(const Graph1& sub, const Graph2& g, VLabel1 vlabel1,
+                    VLabel2 vlabel2, ELabel1 elabel1, ELabel2 elabel2,
+                    bool induced, bool iso, bool parallel, F&& f)
+{
+    constexpr bool directed = is_directed_::apply<Graph2>::type::value;
+    constexpr size_t null = std::numeric_limits<size_t>::max();
+
+    // compact pattern
+    std::vector<size_t> pv, pidx(num_vertices(sub), null);
+    for (auto v : vertices_range(sub))
+    {
+        pidx[v] = pv.size();
+        pv.push_back(v);
+    }
+    size_t n = pv.size();
+    if (n == 0)
+        return;
+
+    // sorted labels of the edges i -> j
+    std::vector<std::vector<int64_t>> padj(n * n);
+    std::vector<size_t> pout(n), pin(n);
+    std::vector<std::vector<size_t>> pnbrs(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        auto v = pv[i];
+        pout[i] = out_degree(v, sub);
+        pin[i] = in_degreeS()(v, sub);
+        for (auto e : out_edges_range(v, sub))
+        {
+            auto j = pidx[target(e, sub)];
+            padj[i * n + j].push_back(get(elabel1, e));
+        }
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            auto& ls = padj[i * n + j];
+            std::sort(ls.begin(), ls.end());
+            if (i != j && (!ls.empty() || !padj[j * n + i].empty()))
+                pnbrs[i].push_back(j);
+        }
+    }
+
+    size_t N = num_vertices(g);
+    if (iso)
+    {
+        size_t NG = 0;
+        for (auto v : vertices_range(g))
+        {
+            (void) v;
+            ++NG;
+        }
+        if (NG != n)
+            return;
+    }
+
+    // candidate domains
+    size_t W = (N + 63) / 64;
+    std::vector<std::vector<uint64_t>> dom(n, std::vector<uint64_t>(W)),
+        ndom = dom;
+    auto in_dom = [&](size_t u, size_t w)
+        {
+            return (dom[u][w / 64] >> (w % 64)) & 1;
+        };
+
+    #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+    for (size_t k = 0; k < W; ++k)
+    {
+        for (size_t w = k * 64; w < std::min((k + 1) * 64, N); ++w)
+        {
+            auto v = vertex(w, g);
+            if (!is_valid_vertex(v, g))
+                continue;
+            size_t kout = out_degree(v, g);
+            size_t kin = in_degreeS()(v, g);
+            for (size_t u = 0; u < n; ++u)
+            {
+                if (get(vlabel1, pv[u]) != get(vlabel2, v))
+                    continue;
+                if (iso ? (kout != pout[u] || kin != pin[u]) :
+                    (kout < pout[u] || kin < pin[u]))
+                    continue;
+                dom[u][k] |= uint64_t(1) << (w % 64);
+            }
+        }
+    }
+
+    // neighborhood support pruning
+    constexpr size_t max_rounds = 3;
+    for (size_t r = 0; r < max_rounds; ++r)
+    {
+        size_t changed = 0;
+        #pragma omp parallel for schedule(runtime) reduction(+:changed) \
+            if (N > OPENMP_MIN_THRESH)
+        for (size_t k = 0; k < W; ++k)
+        {
+            for (size_t u = 0; u < n; ++u)
+            {
+                uint64_t m = dom[u][k];
+                uint64_t nm = m;
+                while (m != 0)
+                {
+                    size_t w = k * 64 + __builtin_ctzll(m);
+                    uint64_t b = m & -m;
+                    m &= m - 1;
+                    for (auto u2 : pnbrs[u])
+                    {
+                        bool found = true;
+                        if (!padj[u * n + u2].empty())
+                        {
+                            found = false;
+                            for (auto y : out_neighbors_range(w, g))
+                            {
+                                if (y != w && in_dom(u2, y))
+                                {
+                                    found = true;
+                                    break;
+                                }
+                            }
+                        }
+                        if constexpr (directed)
+                        {
+                            if (found && !padj[u2 * n + u].empty())
+                            {
+                                found = false;
+                                for (auto y : in_neighbors_range(w, g))
+                                {
+                                    if (y != w && in_dom(u2, y))
+                                    {
+                                        found = true;
+                                        break;
+                                    }
+                                }
+                            }
+                        }
+                        if (!found)
+                        {
+                            nm &= ~b;
+                            break;
+                        }
+                    }
+                }
+                ndom[u][k] = nm;
+                changed += (nm != dom[u][k]);
+            }
+        }
+        dom.swap(ndom);
+        if (changed == 0)
+            break;
+    }
+
+    std::vector<size_t> dsize(n);
+    for (size_t u = 0; u < n; ++u)
+    {
+        for (auto m : dom[u])
+            dsize[u] += __builtin_popcountll(m);
+        if (dsize[u] == 0)
+            return;
+    }
+
+    // matching order, and the already ordered neighbors of each vertex, as
+    // (depth, whether the edge is directed towards it) pairs
+    std::vector<size_t> order, depth(n, null), conn(n);
+    std::vector<std::vector<std::pair<size_t, bool>>> parents(n);
+    auto pdeg = [&](size_t u) { return pout[u] + pin[u]; };
+    for (size_t d = 0; d < n; ++d)
+    {
+        size_t u = null;
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (depth[v] != null)
+                continue;
+            if (u == null || conn[v] > conn[u] ||
+                (conn[v] == conn[u] &&
+                 (dsize[v] < dsize[u] ||
+                  (dsize[v] == dsize[u] && pdeg(v) > pdeg(u)))))
+                u = v;
+        }
+        depth[u] = d;
+        order.push_back(u);
+        for (auto v : pnbrs[u])
+        {
+            if (depth[v] == null)
+            {
+                conn[v]++;
+                continue;
+            }
+            bool to = !padj[v * n + u].empty();
+            parents[d].emplace_back(depth[v], to);
+            if (directed && to && !padj[u * n + v].empty())
+                parents[d].emplace_back(depth[v], false);
+        }
+    }
+
+    // first level, in decreasing order of degree
+    std::vector<size_t> roots;
+    for (size_t k = 0; k < W; ++k)
+    {
+        uint64_t m = dom[order[0]][k];
+        while (m != 0)
+        {
+            roots.push_back(k * 64 + __builtin_ctzll(m));
+            m &= m - 1;
+        }
+    }
+    std::stable_sort(roots.begin(), roots.end(),
+                     [&](auto v, auto w)
+                     {
+                         return (out_degree(v, g) + in_degreeS()(v, g)) >
+                             (out_degree(w, g) + in_degreeS()(w, g));
+                     });
+
+    bool stop = false;
+
+    #pragma omp parallel if (parallel && roots.size() > 1)
+    {
+        size_t tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        std::vector<size_t> img(n, null);  // by depth
+        std::vector<size_t> match(n);      // by pattern vertex
+        std::vector<std::vector<size_t>> cands(n);
+        std::vector<std::vector<int64_t>> hout(n), hin(n);
+        std::vector<int64_t> hloop;
+        std::vector<uint32_t> mark;
+        uint32_t stamp = 0;
+        for (auto& ps : parents)
+        {
+            if (ps.size() > 1)
+                mark.resize(N);
+        }
+
+        auto mapped = [&](size_t d, size_t y)
+        {
+            for (size_t k = 0; k < d; ++k)
+            {
+                if (img[k] == y)
+                    return k;
+            }
+            return null;
+        };
+
+        auto compatible = [&](auto& pls, auto& hls)
+        {
+            if (induced)
+                return pls == hls;
+            return std::includes(hls.begin(), hls.end(),
+                                 pls.begin(), pls.end());
+        };
+
+        // checks the edges between w and the images of the first d vertices
+        auto feasible = [&](size_t d, size_t w)
+        {
+            auto u = order[d];
+            for (size_t k = 0; k < d; ++k)
+            {
+                hout[k].clear();
+                hin[k].clear();
+            }
+            hloop.clear();
+
+            for (auto e : out_edges_range(w, g))
+            {
+                auto y = target(e, g);
+                if (y == w)
+                {
+                    hloop.push_back(get(elabel2, e));
+                    continue;
+                }
+                auto k = mapped(d, y);
+                if (k != null)
+                    hout[k].push_back(get(elabel2, e));
+            }
+            if constexpr (directed)
+            {
+                for (auto e : in_edges_range(w, g))
+                {
+                    auto y = source(e, g);
+                    if (y == w)
+                        continue;
+                    auto k = mapped(d, y);
+                    if (k != null)
+                        hin[k].push_back(get(elabel2, e));
+                }
+            }
+
+            std::sort(hloop.begin(), hloop.end());
+            if (!compatible(padj[u * n + u], hloop))
+                return false;
+            for (size_t k = 0; k < d; ++k)
+            {
+                auto v = order[k];
+                std::sort(hout[k].begin(), hout[k].end());
+                if (!compatible(padj[u * n + v], hout[k]))
+                    return false;
+                if constexpr (directed)
+                {
+                    std::sort(hin[k].begin(), hin[k].end());
+                    if (!compatible(padj[v * n + u], hin[k]))
+                        return false;
+                }
+            }
+            return true;
+        };
+
+        auto get_stop = [&]()
+        {
+            bool s;
+            #pragma omp atomic read
+            s = stop;
+            return s;
+        };
+
+        std::function<bool(size_t)> search =
+            [&](size_t d)
+            {
+                if (d == n)
+                {
+                    for (size_t k = 0; k < n; ++k)
+                        match[order[k]] = img[k];
+                    if (!f(tid, img[0], match))
+                    {
+                        #pragma omp atomic write
+                        stop = true;
+                        return false;
+                    }
+                    return true;
+                }
+
+                auto u = order[d];
+                auto& cs = cands[d];
+                cs.clear();
+                if (parents[d].empty())
+                {
+                    // disconnected pattern: the whole domain is scanned
+                    for (size_t k = 0; k < W; ++k)
+                    {
+                        uint64_t m = dom[u][k];
+                        while (m != 0)
+                        {
+                            size_t w = k * 64 + __builtin_ctzll(m);
+                            m &= m - 1;
+                            if (mapped(d, w) == null)
+                                cs.push_back(w);
+                        }
+                    }
+                }
+                else
+                {
+                    // neighbors of the parent image with the smallest degree
+                    size_t x = null, kx = 0;
+                    bool to = false;
+                    for (auto& [k, dir] : parents[d])
+                    {
+                        size_t kk = dir ? out_degree(img[k], g) :
+                            in_degreeS()(img[k], g);
+                        if (x == null || kk < kx)
+                        {
+                            x = img[k];
+                            kx = kk;
+                            to = dir;
+                        }
+                    }
+
+                    auto push = [&](auto w)
+                    {
+                        if (w != x && in_dom(u, w) && mapped(d, w) == null)
+                            cs.push_back(w);
+                    };
+                    if (to)
+                    {
+                        for (auto w : out_neighbors_range(x, g))
+                            push(w);
+                    }
+                    else
+                    {
+                        if constexpr (directed)
+                        {
+                            for (auto w : in_neighbors_range(x, g))
+                                push(w);
+                        }
+                    }
+                    std::sort(cs.begin(), cs.end());
+                    cs.erase(std::unique(cs.begin(), cs.end()), cs.end());
+
+                    // intersect with the neighbors of the other parents, if
+                    // this is cheaper than checking the candidates one by one
+                    size_t kcs = 0;
+                    for (auto w : cs)
+                        kcs += out_degree(w, g) + in_degreeS()(w, g);
+                    for (auto& [k, dir] : parents[d])
+                    {
+                        auto y = img[k];
+                        if ((y == x && dir == to) || cs.empty())
+                            continue;
+                        size_t ky = dir ? out_degree(y, g) :
+                            in_degreeS()(y, g);
+                        if (ky > kcs)
+                            continue;
+                        if (++stamp == 0)
+                        {
+                            std::fill(mark.begin(), mark.end(), 0);
+                            stamp = 1;
+                        }
+                        if (dir)
+                        {
+                            for (auto w : out_neighbors_range(y, g))
+                                mark[w] = stamp;
+                        }
+                        else
+                        {
+                            if constexpr (directed)
+                            {
+                                for (auto w : in_neighbors_range(y, g))
+                                    mark[w] = stamp;
+                            }
+                        }
+                        auto iter = std::remove_if(cs.begin(), cs.end(),
+                                                   [&](auto w)
+                                                   {
+                                                       return mark[w] != stamp;
+                                                   });
+                        cs.erase(iter, cs.end());
+                    }
+                }
+
+                for (size_t i = 0; i < cands[d].size(); ++i)
+                {
+                    auto w = cands[d][i];
+                    if (!feasible(d, w))
+                        continue;
+                    img[d] = w;
+                    bool ret = search(d + 1);
+                    img[d] = null;
+                    if (!ret || get_stop())
+                        return false;
+                }
+                return true;
+            };
+
+        #pragma omp for schedule(dynamic, 1)
+        for (size_t i = 0; i < roots.size(); ++i)
+        {
+            if (get_stop())
+                continue;
+            auto w = roots[i];
+            if (!feasible(0, w))
+                continue;
+            img[0] = w;
+            search(1);
+            img[0] = null;
+        }
+    }
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_SUBGRAPH_MATCH_HH
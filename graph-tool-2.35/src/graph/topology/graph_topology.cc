@@ -32,6 +32,8 @@ void get_kruskal_spanning_tree(GraphInterface& gi, boost::any weight_map,
                                boost::any tree_map);
 void get_prim_spanning_tree(GraphInterface& gi, size_t root,
                             boost::any weight_map, boost::any tree_map);
+void get_parallel_spanning_tree(GraphInterface& gi, boost::any weight_map,
+                                boost::any tree_map);
 bool topological_sort(GraphInterface& gi, vector<int32_t>& sort);
 void dominator_tree(GraphInterface& gi, size_t entry, boost::any pred_map);
 void transitive_closure(GraphInterface& gi, GraphInterface& tcgi);
@@ -46,12 +48,17 @@ python::object subgraph_isomorphism(GraphInterface& gi1, GraphInterface& gi2,
 double reciprocity(GraphInterface& gi);
 size_t sequential_coloring(GraphInterface& gi, boost::any order,
                            boost::any color);
+size_t parallel_coloring(GraphInterface& gi, boost::any order,
+                         boost::any color);
+void coloring_order(GraphInterface& gi, boost::any order, int kind);
 bool is_bipartite(GraphInterface& gi, boost::any part_map, bool find_cycle,
                   boost::python::list cycle);
 void get_random_spanning_tree(GraphInterface& gi, size_t root,
                               boost::any weight_map, boost::any tree_map,
                               rng_t& rng);
-vector<int32_t> get_tsp(GraphInterface& gi, size_t src, boost::any weight_map);
+vector<int32_t> get_tsp(GraphInterface& gi, size_t src, boost::any weight_map,
+                        size_t nn, size_t niter, size_t restarts,
+                        double max_time, rng_t& rng);
 
 void export_components();
 void export_kcore();
@@ -61,11 +68,14 @@ void export_dists();
 void export_all_dists();
 void export_all_circuits();
 void export_diam();
+void export_dynamic_connectivity();
+void export_reachability();
 void export_random_matching();
 void export_maximal_vertex_set();
 void export_vertex_similarity();
 void export_max_cliques();
 void export_matching();
+void export_subgraph_match();
 
 
 BOOST_PYTHON_MODULE(libgraph_tool_topology)
@@ -75,6 +85,7 @@ BOOST_PYTHON_MODULE(libgraph_tool_topology)
     def("subgraph_isomorphism", &subgraph_isomorphism);
     def("get_kruskal_spanning_tree", &get_kruskal_spanning_tree);
     def("get_prim_spanning_tree", &get_prim_spanning_tree);
+    def("get_parallel_spanning_tree", &get_parallel_spanning_tree);
     def("topological_sort", &topological_sort);
     def("dominator_tree", &dominator_tree);
     def("transitive_closure", &transitive_closure);
@@ -82,6 +93,8 @@ BOOST_PYTHON_MODULE(libgraph_tool_topology)
     def("maximal_planar", &maximal_planar);
     def("reciprocity", &reciprocity);
     def("sequential_coloring", &sequential_coloring);
+    def("parallel_coloring", &parallel_coloring);
+    def("coloring_order", &coloring_order);
     def("is_bipartite", &is_bipartite);
     def("random_spanning_tree", &get_random_spanning_tree);
     def("get_tsp", &get_tsp);
@@ -93,9 +106,12 @@ BOOST_PYTHON_MODULE(libgraph_tool_topology)
     export_all_dists();
     export_all_circuits();
     export_diam();
+    export_dynamic_connectivity();
+    export_reachability();
     export_random_matching();
     export_maximal_vertex_set();
     export_vertex_similarity();
     export_max_cliques();
     export_matching();
+    export_subgraph_match();
 }
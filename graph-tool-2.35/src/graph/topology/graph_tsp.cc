@@ -18,9 +18,12 @@
 #include "graph_filtering.hh"
 #include "graph.hh"
 #include "graph_properties.hh"
+#include "random.hh"
 
 #include <boost/graph/metric_tsp_approx.hpp>
 
+#include "graph_tsp.hh"
+
 using namespace std;
 using namespace boost;
 using namespace graph_tool;
@@ -29,15 +32,28 @@ struct get_tsp_approx
 {
     template <class Graph, class WeightMap, class IntType>
     void operator()(Graph& g, size_t src, WeightMap weights,
-                    vector<IntType>& tour) const
+                    vector<IntType>& tour, size_t nn, size_t niter,
+                    size_t restarts, double max_time, rng_t& rng) const
     {
         back_insert_iterator<vector<IntType> > back_it(tour);
         metric_tsp_approx_tour_from_vertex(g, vertex(src, g), weights,
                                            back_it);
+
+        // the approximate tour is used as the starting point of the local
+        // search, unless nn == 0
+        if (nn == 0 || tour.empty())
+            return;
+        vector<size_t> vs(tour.begin(), tour.end() - 1);
+        tsp_improve(g, weights, vs, nn, niter, restarts, max_time, rng);
+        for (size_t i = 0; i < vs.size(); ++i)
+            tour[i] = vs[i];
+        tour.back() = vs.front();
     }
 };
 
-vector<int32_t> get_tsp(GraphInterface& gi, size_t src, boost::any weight_map)
+vector<int32_t> get_tsp(GraphInterface& gi, size_t src, boost::any weight_map,
+                        size_t nn, size_t niter, size_t restarts,
+                        double max_time, rng_t& rng)
 {
     vector<int32_t> tour;
 
@@ -55,7 +71,8 @@ vector<int32_t> get_tsp(GraphInterface& gi, size_t src, boost::any weight_map)
          {
              return get_tsp_approx()
                  (std::forward<decltype(graph)>(graph), src,
-                  std::forward<decltype(a2)>(a2), tour);
+                  std::forward<decltype(a2)>(a2), tour, nn, niter,
+                  restarts, max_time, rng);
          },
          weight_maps())(weight_map);
 
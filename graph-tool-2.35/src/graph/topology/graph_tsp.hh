@@ -0,0 +1,458 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2020 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 3 of the License, or (at your option) any
+// later version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for more
+// details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_TSP_HH
+#define GRAPH_TSP_HH
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <chrono>
+#include <deque>
+#include <random>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+namespace graph_tool
+{
+
+using namespace boost;
+
+// Compact weighted adjacency of the vertices in a tour, with the nn lightest
+// edges of each vertex as candidate neighbors for the local search. Pairs of
+// vertices that are not adjacent in the graph are given a prohibitive cost,
+// so that they are removed from the tour whenever possible.
+class tsp_distances
+{
+public:
+    template <class Graph, class WeightMap>
+    tsp_distances(Graph& g, WeightMap weights, const std::vector<size_t>& vs,
+                  size_t nn)
+        : _n(vs.size()), _vpos(_n + 1), _npos(_n + 1)
+    {
+        constexpr size_t null = std::numeric_limits<size_t>::max();
+        std::vector<size_t> idx(num_vertices(g), null);
+        for (size_t i = 0; i < _n; ++i)
+            idx[vs[i]] = i;
+
+        double wmax = 0;
+        std::vector<std::pair<size_t, double>> ns;
+        for (size_t i = 0; i < _n; ++i)
+        {
+            ns.clear();
+            for (auto e : out_edges_range(vertex(vs[i], g), g))
+            {
+                auto j = idx[target(e, g)];
+                if (j == null || j == i)
+                    continue;
+                ns.emplace_back(j, get(weights, e));
+                wmax = std::max(wmax, ns.back().second);
+            }
+            std::sort(ns.begin(), ns.end());
+            auto end = std::unique(ns.begin(), ns.end(),
+                                   [](auto& a, auto& b)
+                                   { return a.first == b.first; });
+            ns.erase(end, ns.end());
+            for (auto& [j, w] : ns)
+            {
+                _vs.push_back(j);
+                _ws.push_back(w);
+            }
+            _vpos[i + 1] = _vs.size();
+
+            auto k = std::min(nn, ns.size());
+            std::partial_sort(ns.begin(), ns.begin() + k, ns.end(),
+                              [](auto& a, auto& b)
+                              { return std::make_pair(a.second, a.first) <
+                                       std::make_pair(b.second, b.first); });
+            for (size_t l = 0; l < k; ++l)
+                _nbrs.push_back(ns[l].first);
+            _npos[i + 1] = _nbrs.size();
+        }
+        _missing = 2 * (wmax + 1) * _n;
+    }
+
+    // weight of the lightest edge between i and j
+    double operator()(size_t i, size_t j) const
+    {
+        if (_vpos[i + 1] - _vpos[i] > _vpos[j + 1] - _vpos[j])
+            std::swap(i, j);
+        auto begin = _vs.begin() + _vpos[i];
+        auto end = _vs.begin() + _vpos[i + 1];
+        auto iter = std::lower_bound(begin, end, j);
+        if (iter == end || *iter != j)
+            return _missing;
+        return _ws[iter - _vs.begin()];
+    }
+
+    size_t size() const { return _n; }
+    auto nbrs_begin(size_t i) const { return _nbrs.begin() + _npos[i]; }
+    auto nbrs_end(size_t i) const { return _nbrs.begin() + _npos[i + 1]; }
+
+private:
+    size_t _n;
+    std::vector<size_t> _vpos, _vs, _npos, _nbrs;
+    std::vector<double> _ws;
+    double _missing;
+};
+
+// Local search over a closed tour of the vertices 0..n-1, with 2-opt and
+// Or-opt moves restricted to the candidate neighbors, and driven by a queue
+// of active vertices, i.e. "don't look bits" [Bentley 1992].
+//
+// The tour is kept as an array with the position of every vertex, and every
+// move is performed as a sequence of 2-opt moves, i.e. reversals of the
+// shorter side of the tour, which are logged so that they can be undone.
+class tsp_local_search
+{
+public:
+    tsp_local_search(const tsp_distances& dist)
+        : _dist(dist), _n(dist.size()), _tour(_n), _pos(_n), _active(_n)
+    {
+        for (size_t i = 0; i < _n; ++i)
+            _tour[i] = _pos[i] = i;
+        _length = 0;
+        for (size_t i = 0; i < _n; ++i)
+        {
+            _length += _dist(i, succ(i));
+            activate(i);
+        }
+        _committed = _length;
+    }
+
+    size_t succ(size_t v) const
+    {
+        auto i = _pos[v] + 1;
+        return _tour[i == _n ? 0 : i];
+    }
+
+    size_t pred(size_t v) const
+    {
+        auto i = _pos[v];
+        return _tour[i == 0 ? _n - 1 : i - 1];
+    }
+
+    // replaces the tour edges (a, b) and (c, d) by (a, c) and (b, d), where b
+    // follows a and d follows c in the same direction
+    void move(size_t a, size_t b, size_t c, size_t d)
+    {
+        if (succ(a) == b)
+            reverse(_pos[b], _pos[c]);
+        else
+            reverse(_pos[a], _pos[d]);
+        _log.push_back({a, b, c, d});
+        activate(a);
+        activate(b);
+        activate(c);
+        activate(d);
+    }
+
+    // 2-opt move that replaces the edge between a and its successor (or
+    // predecessor) by an edge to one of its neighbors
+    bool two_opt(size_t a)
+    {
+        for (bool fwd : {true, false})
+        {
+            auto b = fwd ? succ(a) : pred(a);
+            auto dab = _dist(a, b);
+            for (auto iter = _dist.nbrs_begin(a); iter != _dist.nbrs_end(a);
+                 ++iter)
+            {
+                auto c = *iter;
+                auto dac = _dist(a, c);
+                if (dac >= dab)
+                    break;
+                auto d = fwd ? succ(c) : pred(c);
+                if (c == b || d == a)
+                    continue;
+                auto delta = dab + _dist(c, d) - dac - _dist(b, d);
+                if (delta > _eps)
+                {
+                    move(a, b, c, d);
+                    _length -= delta;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Or-opt move that takes a segment of up to three vertices starting at a
+    // (in either direction) and inserts it, in either orientation, next to a
+    // neighbor of one of its extremities
+    bool or_opt(size_t a)
+    {
+        if (_n < 8)
+            return false;
+        for (bool fwd : {true, false})
+        {
+            auto next = [&](size_t v) { return fwd ? succ(v) : pred(v); };
+            auto prev = [&](size_t v) { return fwd ? pred(v) : succ(v); };
+            auto p = prev(a);
+            auto s1 = a;
+            auto s2 = a;
+            for (size_t l = 0; l < 3; ++l)
+            {
+                if (l > 0)
+                    s2 = next(s2);
+                auto n = next(s2);
+                if (n == p)
+                    break;
+                auto rgain = _dist(p, s1) + _dist(s2, n) - _dist(p, n);
+                if (rgain <= _eps)
+                    continue;
+                for (auto s : {s1, s2})
+                {
+                    auto t = (s == s1) ? s2 : s1;
+                    for (auto iter = _dist.nbrs_begin(s);
+                         iter != _dist.nbrs_end(s); ++iter)
+                    {
+                        auto c = *iter;
+                        auto dsc = _dist(s, c);
+                        if (dsc >= rgain)
+                            break;
+                        if (c == p || c == n)
+                            continue;
+                        bool inside = false;
+                        for (auto x = s1; ; x = next(x))
+                        {
+                            inside |= (x == c);
+                            if (x == s2)
+                                break;
+                        }
+                        if (inside)
+                            continue;
+                        for (bool after : {true, false})
+                        {
+                            auto d = after ? next(c) : prev(c);
+                            if (d == p || d == n)
+                                continue;
+                            auto delta = rgain - dsc - _dist(t, d)
+                                + _dist(c, d);
+                            if (delta <= _eps)
+                                continue;
+                            // insert between u and v, where v follows u
+                            auto u = after ? c : d;
+                            auto v = after ? d : c;
+                            bool keep = ((s == s1) == after);
+                            move(p, s1, u, v);       // p u ... n s2..s1 v
+                            move(p, u, n, s2);       // p n ... u s2..s1 v
+                            if (keep)
+                                move(u, s2, s1, v);  // p n ... u s1..s2 v
+                            _length -= delta;
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // runs the local search until no vertex is active
+    void optimize()
+    {
+        while (!_queue.empty())
+        {
+            auto a = _queue.front();
+            _queue.pop_front();
+            _active[a] = false;
+            while (two_opt(a) || or_opt(a));
+        }
+    }
+
+    // swaps two consecutive random segments of up to max_len vertices each,
+    // i.e. a double bridge move confined to a small part of the tour
+    template <class RNG>
+    void perturb(RNG& rng, size_t max_len = 50)
+    {
+        if (_n < 8)
+            return;
+        max_len = std::min(max_len, _n / 4);
+        std::uniform_int_distribution<size_t> rpos(0, _n - 1);
+        std::uniform_int_distribution<size_t> rlen(1, max_len);
+        auto x = _tour[rpos(rng)];
+        auto b1 = succ(x);
+        auto b2 = b1;
+        for (size_t l = rlen(rng); l > 1; --l)
+            b2 = succ(b2);
+        auto c1 = succ(b2);
+        auto c2 = c1;
+        for (size_t l = rlen(rng); l > 1; --l)
+            c2 = succ(c2);
+        auto y = succ(c2);
+        _length += _dist(x, c1) + _dist(c2, b1) + _dist(b2, y)
+            - _dist(x, b1) - _dist(b2, c1) - _dist(c2, y);
+        move(x, b1, b2, c1);  // x b2..b1 c1..c2 y
+        move(b1, c1, c2, y);  // x b2..b1 c2..c1 y
+        move(x, b2, c1, y);   // x c1..c2 b1..b2 y
+    }
+
+    // reverts all the moves since the last commit
+    void undo()
+    {
+        while (!_log.empty())
+        {
+            auto [a, b, c, d] = _log.back();
+            _log.pop_back();
+            if (succ(a) == c)
+                reverse(_pos[c], _pos[b]);
+            else
+                reverse(_pos[a], _pos[d]);
+        }
+        while (!_queue.empty())
+        {
+            _active[_queue.front()] = false;
+            _queue.pop_front();
+        }
+        _length = _committed;
+    }
+
+    void commit()
+    {
+        _log.clear();
+        _committed = _length;
+    }
+
+    double length() const { return _length; }
+    const std::vector<size_t>& tour() const { return _tour; }
+
+private:
+    void activate(size_t v)
+    {
+        if (_active[v])
+            return;
+        _active[v] = true;
+        _queue.push_back(v);
+    }
+
+    // reverses the tour between positions i and j, inclusive, or its
+    // complement, whichever is shorter
+    void reverse(size_t i, size_t j)
+    {
+        size_t len = (j + _n - i) % _n + 1;
+        if (2 * len > _n)
+        {
+            std::swap(i, j);
+            i = (i + 1 == _n) ? 0 : i + 1;
+            j = (j == 0) ? _n - 1 : j - 1;
+            len = _n - len;
+        }
+        for (size_t k = 0; k < len / 2; ++k)
+        {
+            std::swap(_tour[i], _tour[j]);
+            _pos[_tour[i]] = i;
+            _pos[_tour[j]] = j;
+            i = (i + 1 == _n) ? 0 : i + 1;
+            j = (j == 0) ? _n - 1 : j - 1;
+        }
+    }
+
+    const tsp_distances& _dist;
+    size_t _n;
+    std::vector<size_t> _tour, _pos;
+    double _length, _committed;
+    std::vector<std::array<size_t, 4>> _log;
+    std::vector<uint8_t> _active;
+    std::deque<size_t> _queue;
+    static constexpr double _eps = 1e-10;
+};
+
+// Iterated local search seeded by the given tour, which is replaced by the
+// best one found. Each of the independent restarts alternates the local
+// search with random perturbations, which are kept if they do not increase
+// the length of the tour, up to niter times, or until max_time seconds have
+// passed, if max_time > 0. The restarts are distributed among the threads,
+// and use separate streams of random numbers, so that the result does not
+// depend on the number of threads, unless the time limit is reached.
+template <class Graph, class WeightMap, class RNG>
+void tsp_improve(Graph& g, WeightMap weights, std::vector<size_t>& tour,
+                 size_t nn, size_t niter, size_t restarts, double max_time,
+                 RNG& rng)
+{
+    if (tour.size() < 4)
+        return;
+    restarts = std::max(restarts, size_t(1));
+
+    tsp_distances dist(g, weights, tour, nn);
+
+    auto start = std::chrono::steady_clock::now();
+    auto timeout = [&]()
+        {
+            if (max_time <= 0)
+                return false;
+            std::chrono::duration<double> dt =
+                std::chrono::steady_clock::now() - start;
+            return dt.count() > max_time;
+        };
+
+    std::vector<RNG> rngs;
+    for (size_t r = 0; r < restarts; ++r)
+    {
+        rngs.emplace_back(rng);
+        rngs.back().set_stream(r + 1);
+    }
+    rng.discard(1);
+
+    std::vector<std::vector<size_t>> tours(restarts);
+    std::vector<double> lengths(restarts);
+
+    tsp_local_search ls0(dist);
+    ls0.optimize();
+    ls0.commit();
+
+    #pragma omp parallel for schedule(dynamic, 1) if (restarts > 1)
+    for (size_t r = 0; r < restarts; ++r)
+    {
+        auto& rng_ = rngs[r];
+        tsp_local_search ls(ls0);
+        for (size_t i = 0; (niter == 0 || i < niter) && !timeout(); ++i)
+        {
+            if (niter == 0 && max_time <= 0)
+                break;
+            auto l = ls.length();
+            ls.perturb(rng_);
+            ls.optimize();
+            if (ls.length() <= l)
+                ls.commit();
+            else
+                ls.undo();
+        }
+        auto& t = ls.tour();
+        tours[r].assign(t.begin(), t.end());
+        lengths[r] = 0;
+        for (size_t i = 0; i < t.size(); ++i)
+            lengths[r] += dist(t[i], t[(i + 1) % t.size()]);
+    }
+
+    auto r = std::min_element(lengths.begin(), lengths.end()) -
+        lengths.begin();
+    auto& t = tours[r];
+
+    // the tour starts at the same vertex as before
+    auto first = std::find(t.begin(), t.end(), 0) - t.begin();
+    std::vector<size_t> vs(tour);
+    for (size_t i = 0; i < t.size(); ++i)
+        tour[i] = vs[t[(first + i) % t.size()]];
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_TSP_HH
@@ -20,6 +20,7 @@
 #include "graph_tool.hh"
 #include "graph_vertex_similarity.hh"
 #include "numpy_bind.hh"
+#include "random.hh"
 
 using namespace std;
 using namespace boost;
@@ -367,8 +368,95 @@ void get_leicht_holme_newman_similarity_pairs(GraphInterface& gi,
         (gi.get_graph_view(), weight);
 }
 
+python::object get_similarity_top_k(GraphInterface& gi, std::string sim_type,
+                                    size_t k, boost::any weight)
+{
+    if (weight.empty())
+        weight = ecmap_t();
+
+    vector<std::array<int64_t, 2>> pairs;
+    vector<double> sims;
+
+    gt_dispatch<>()
+        ([&](auto& g, auto w)
+         {
+             auto count = [](auto, auto dw) { return double(dw); };
+             auto join = [&](auto&& contrib, auto&& score)
+                 {
+                     top_k_similarity(g, w, k, contrib, score, pairs, sims);
+                 };
+
+             // weighted degree of the common neighbors, as in
+             // inv_log_weighted() and r_allocation()
+             vector<double> kw;
+             if (sim_type == "inv-log-weight" ||
+                 sim_type == "resource-allocation")
+             {
+                 kw.resize(num_vertices(g));
+                 parallel_vertex_loop
+                     (g,
+                      [&](auto v)
+                      {
+                          if (graph_tool::is_directed(g))
+                              kw[v] = in_degreeS()(v, g, w);
+                          else
+                              kw[v] = out_degreeS()(v, g, w);
+                      });
+             }
+
+             if (sim_type == "dice")
+                 join(count, [](double c, double ku, double kv)
+                             { return 2 * c / (ku + kv); });
+             else if (sim_type == "salton")
+                 join(count, [](double c, double ku, double kv)
+                             { return c / sqrt(ku * kv); });
+             else if (sim_type == "hub-promoted")
+                 join(count, [](double c, double ku, double kv)
+                             { return c / std::max(ku, kv); });
+             else if (sim_type == "hub-suppressed")
+                 join(count, [](double c, double ku, double kv)
+                             { return c / std::min(ku, kv); });
+             else if (sim_type == "jaccard")
+                 join(count, [](double c, double ku, double kv)
+                             { return c / (ku + kv - c); });
+             else if (sim_type == "inv-log-weight")
+                 join([&](auto v, auto dw) { return dw / log(kw[v]); },
+                      [](double c, double, double) { return c; });
+             else if (sim_type == "resource-allocation")
+                 join([&](auto v, auto dw) { return dw / kw[v]; },
+                      [](double c, double, double) { return c; });
+             else if (sim_type == "leicht-holme-newman")
+                 join(count, [](double c, double ku, double kv)
+                             { return c / (ku * kv); });
+             else
+                 throw ValueException("invalid similarity type: " + sim_type);
+         },
+         all_graph_views(), weight_props_t())
+        (gi.get_graph_view(), weight);
+
+    return python::make_tuple(wrap_vector_owned(pairs),
+                              wrap_vector_owned(sims));
+}
+
+python::object get_minhash_top_k(GraphInterface& gi, size_t k, size_t m,
+                                 rng_t& rng)
+{
+    vector<std::array<int64_t, 2>> pairs;
+    vector<double> sims;
+    run_action<>()
+        (gi,
+         [&](auto& g)
+         {
+             minhash_top_k_similarity(g, k, m, rng, pairs, sims);
+         })();
+    return python::make_tuple(wrap_vector_owned(pairs),
+                              wrap_vector_owned(sims));
+}
+
 void export_vertex_similarity()
 {
+    python::def("similarity_top_k", &get_similarity_top_k);
+    python::def("minhash_top_k", &get_minhash_top_k);
     python::def("dice_similarity", &get_dice_similarity);
     python::def("dice_similarity_pairs", &get_dice_similarity_pairs);
     python::def("salton_similarity", &get_salton_similarity);
@@ -18,17 +18,71 @@
 #ifndef GRAPH_VERTEX_SIMILARITY_HH
 #define GRAPH_VERTEX_SIMILARITY_HH
 
+#include <array>
+#include <numeric>
+
 #include "graph_util.hh"
+#include "graph_intersect.hh"
+#include "hash_map_wrap.hh"
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
 
 namespace graph_tool
 {
 using namespace std;
 using namespace boost;
 
+// common neighbors of u and v in an unweighted graph, obtained by intersecting
+// their sorted neighborhoods
+template <class Graph, class Vertex, class Buffer>
+auto common_neighbors_sorted(Vertex u, Vertex v, Buffer& buf, Graph& g)
+{
+    auto& ns = buf.ns;
+    auto& cs = buf.count;
+    bool urep = get_sorted_neighbors(u, g, graph_traits<Graph>::null_vertex(),
+                                     ns[0], cs[0]);
+    bool vrep = get_sorted_neighbors(v, g, graph_traits<Graph>::null_vertex(),
+                                     ns[1], cs[1]);
+    size_t count = 0, ku = ns[0].size(), kv = ns[1].size();
+    if (urep || vrep)
+    {
+        intersect_apply(ns[0].data(), ns[0].size(), ns[1].data(), ns[1].size(),
+                        [&](auto i, auto j)
+                        {
+                            count += std::min(urep ? cs[0][i] : 1,
+                                              vrep ? cs[1][j] : 1);
+                        });
+        if (urep)
+            ku = std::accumulate(cs[0].begin(), cs[0].end(), size_t(0));
+        if (vrep)
+            kv = std::accumulate(cs[1].begin(), cs[1].end(), size_t(0));
+    }
+    else
+    {
+        count = intersect_count(ns[0].data(), ns[0].size(), ns[1].data(),
+                                ns[1].size());
+    }
+    return std::make_tuple(count, ku, kv);
+}
+
 template <class Graph, class Vertex, class Mark, class Weight>
 auto common_neighbors(Vertex u, Vertex v, Mark& mark, Weight& weight, Graph& g)
 {
-    typename property_traits<Weight>::value_type count = 0, ku = 0, kv = 0;
+    typedef typename property_traits<Weight>::value_type val_t;
+    val_t count = 0, ku = 0, kv = 0;
+
+    if constexpr (is_unity_property<Weight>::value)
+    {
+        if (has_sorted_adjacency(g))
+        {
+            auto ret = common_neighbors_sorted(u, v, mark.sorted, g);
+            return std::make_tuple(val_t(get<0>(ret)), val_t(get<1>(ret)),
+                                   val_t(get<2>(ret)));
+        }
+    }
+
     for (auto e : out_edges_range(u, g))
     {
         auto w = weight[e];
@@ -92,6 +146,18 @@ template <class Graph, class Vertex, class Mark, class Weight>
 double jaccard(Vertex u, Vertex v, Mark& mark, Weight& weight, Graph& g)
 {
     typename property_traits<Weight>::value_type count = 0, total = 0;
+
+    if constexpr (is_unity_property<Weight>::value)
+    {
+        if (has_sorted_adjacency(g))
+        {
+            size_t ku, kv;
+            std::tie(count, ku, kv) = common_neighbors_sorted(u, v,
+                                                              mark.sorted, g);
+            return count / double(ku + kv - count);
+        }
+    }
+
     for (auto e : out_edges_range(u, g))
     {
         auto w = weight[e];
@@ -164,7 +230,7 @@ double r_allocation(Vertex u, Vertex v, Mark& mark, Weight& weight, Graph& g)
 template <class Graph, class VMap, class Sim, class Weight>
 void all_pairs_similarity(Graph& g, VMap s, Sim&& f, Weight& weight)
 {
-    vector<typename property_traits<Weight>::value_type>
+    neighbor_mark<typename property_traits<Weight>::value_type>
         mask(num_vertices(g));
     #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
         firstprivate(mask)
@@ -182,7 +248,7 @@ template <class Graph, class Vlist, class Slist, class Sim, class Weight>
 void some_pairs_similarity(Graph& g, Vlist& vlist, Slist& slist, Sim&& f,
                            Weight& weight)
 {
-    vector<typename property_traits<Weight>::value_type>
+    neighbor_mark<typename property_traits<Weight>::value_type>
         mark(num_vertices(g));
     #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
         firstprivate(mark)
@@ -196,6 +262,307 @@ void some_pairs_similarity(Graph& g, Vlist& vlist, Slist& slist, Sim&& f,
          });
 }
 
+// Concatenates the per-thread outputs of the top-k joins below, ordered by the
+// source vertex. Each record (u, thread, position, size) points to the block
+// of results of vertex u in the buffers of the given thread.
+inline void
+merge_top_k(vector<vector<std::array<size_t, 4>>>& trecs,
+            vector<vector<std::pair<double, size_t>>>& tbuf,
+            vector<std::array<int64_t, 2>>& pairs, vector<double>& sims)
+{
+    vector<std::array<size_t, 4>> recs;
+    for (auto& r : trecs)
+        recs.insert(recs.end(), r.begin(), r.end());
+    std::sort(recs.begin(), recs.end());
+    for (auto& r : recs)
+    {
+        auto& buf = tbuf[r[1]];
+        for (size_t i = r[2]; i < r[2] + r[3]; ++i)
+        {
+            pairs.push_back({int64_t(r[0]), int64_t(buf[i].second)});
+            sims.push_back(buf[i].first);
+        }
+    }
+}
+
+// Orders candidates by decreasing similarity, breaking ties by index.
+struct top_k_cmp
+{
+    bool operator()(const std::pair<double, size_t>& a,
+                    const std::pair<double, size_t>& b) const
+    {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    }
+};
+
+// Top-k similarity join: for every vertex u, the k vertices v != u with the
+// largest similarity are found, considering only the vertices at distance two,
+// i.e. sharing at least one neighbor with u, since all others have zero
+// similarity.
+//
+// For each u, the common-neighbor sums with all candidates are accumulated in
+// a single pass over its two-hop neighborhood, using thread-local mark arrays
+// for the weights A_{uw}, the aggregated weights A_{vw} of parallel edges, and
+// the sums. For each common neighbor w, contrib(w, min(A_{uw}, A_{vw})) is
+// added to the sum of v, and the similarity is obtained as score(sum, k_u,
+// k_v), where k_u is the weighted out-degree of u. The cost is proportional to
+// the number of paths of length two, and the memory is O(V) per thread.
+template <class Graph, class Weight, class Contrib, class Score>
+void top_k_similarity(Graph& g, Weight& weight, size_t k, Contrib&& contrib,
+                      Score&& score, vector<std::array<int64_t, 2>>& pairs,
+                      vector<double>& sims)
+{
+    typedef typename property_traits<Weight>::value_type val_t;
+    if (k == 0)
+        return;
+    size_t N = num_vertices(g);
+
+    vector<val_t> ku(N);
+    parallel_vertex_loop
+        (g,
+         [&](auto v)
+         {
+             ku[v] = out_degreeS()(v, g, weight);
+         });
+
+    size_t nthreads = 1;
+#ifdef _OPENMP
+    if (N > OPENMP_MIN_THRESH)
+        nthreads = omp_get_max_threads();
+#endif
+    vector<vector<std::array<size_t, 4>>> trecs(nthreads);
+    vector<vector<std::pair<double, size_t>>> tbuf(nthreads);
+
+    #pragma omp parallel if (N > OPENMP_MIN_THRESH)
+    {
+        size_t tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        vector<val_t> mark(N), agg(N);
+        vector<double> acc(N);
+        vector<uint8_t> is_cand(N);
+        vector<size_t> ws, vs, cands;
+        vector<std::pair<double, size_t>> top;
+
+        parallel_vertex_loop_no_spawn
+            (g,
+             [&](auto u)
+             {
+                 ws.clear();
+                 for (auto e : out_edges_range(u, g))
+                 {
+                     auto w = target(e, g);
+                     auto x = weight[e];
+                     if (x == 0)
+                         continue;
+                     if (mark[w] == 0)
+                         ws.push_back(w);
+                     mark[w] += x;
+                 }
+
+                 cands.clear();
+                 for (auto w : ws)
+                 {
+                     vs.clear();
+                     auto visit = [&](auto v, auto x)
+                         {
+                             if (x == 0)
+                                 return;
+                             if (agg[v] == 0)
+                                 vs.push_back(v);
+                             agg[v] += x;
+                         };
+                     if constexpr (is_directed_::apply<Graph>::type::value)
+                     {
+                         for (auto e : in_edges_range(w, g))
+                             visit(source(e, g), weight[e]);
+                     }
+                     else
+                     {
+                         for (auto e : out_edges_range(w, g))
+                             visit(target(e, g), weight[e]);
+                     }
+
+                     for (auto v : vs)
+                     {
+                         auto dw = std::min(mark[w], agg[v]);
+                         agg[v] = 0;
+                         if (v == u)
+                             continue;
+                         if (!is_cand[v])
+                         {
+                             is_cand[v] = true;
+                             cands.push_back(v);
+                         }
+                         acc[v] += contrib(w, dw);
+                     }
+                 }
+
+                 for (auto w : ws)
+                     mark[w] = 0;
+
+                 top.clear();
+                 for (auto v : cands)
+                 {
+                     top.emplace_back(score(acc[v], ku[u], ku[v]), v);
+                     acc[v] = 0;
+                     is_cand[v] = false;
+                 }
+
+                 if (top.size() > k)
+                 {
+                     std::nth_element(top.begin(), top.begin() + k, top.end(),
+                                      top_k_cmp());
+                     top.resize(k);
+                 }
+                 std::sort(top.begin(), top.end(), top_k_cmp());
+
+                 auto& buf = tbuf[tid];
+                 trecs[tid].push_back({size_t(u), tid, buf.size(), top.size()});
+                 buf.insert(buf.end(), top.begin(), top.end());
+             });
+    }
+
+    merge_top_k(trecs, tbuf, pairs, sims);
+}
+
+// Approximate top-k join for the (unweighted) Jaccard similarity, based on
+// MinHash sketches and locality-sensitive hashing. Each vertex is summarized by
+// the minima of m random hash functions over its out-neighbors, such that the
+// fraction of coinciding entries of two sketches is an unbiased estimate of
+// their Jaccard similarity. The sketches are split into bands of two entries,
+// and for each band the vertices are sorted by the band values and then by the
+// whole sketch, so that vertices with identical bands become contiguous, and
+// the most similar ones become adjacent. Each vertex is then compared only with
+// the k vertices on either side of it which share the same band, keeping the
+// best k estimates across all bands.
+//
+// This avoids the enumeration of two-hop neighborhoods, and runs in time
+// O(V m (log V + m k)), with O(V (m + k)) memory.
+template <class Graph, class RNG>
+void minhash_top_k_similarity(Graph& g, size_t k, size_t m, RNG& rng,
+                              vector<std::array<int64_t, 2>>& pairs,
+                              vector<double>& sims)
+{
+    if (k == 0)
+        return;
+    size_t N = num_vertices(g);
+    m = std::max(m + (m % 2), size_t(2));
+
+    auto mix = [](uint64_t x)
+        {
+            // splitmix64 finalizer
+            x += 0x9e3779b97f4a7c15;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+            return x ^ (x >> 31);
+        };
+
+    vector<uint64_t> seeds(m);
+    std::uniform_int_distribution<uint64_t> sample;
+    for (auto& s : seeds)
+        s = sample(rng);
+
+    constexpr uint64_t empty = numeric_limits<uint64_t>::max();
+    vector<uint64_t> sketch(N * m, empty);
+    vector<uint64_t> shash(N);
+    parallel_vertex_loop
+        (g,
+         [&](auto v)
+         {
+             auto sk = sketch.data() + v * m;
+             for (auto w : out_neighbors_range(v, g))
+             {
+                 for (size_t i = 0; i < m; ++i)
+                     sk[i] = std::min(sk[i], mix(uint64_t(w) ^ seeds[i]));
+             }
+             uint64_t h = 0;
+             for (size_t i = 0; i < m; ++i)
+                 h = mix(h ^ sk[i]);
+             shash[v] = h;
+         });
+
+    // best k candidates of each vertex, in unsorted flat blocks of size k
+    vector<std::pair<double, size_t>> best(N * k);
+    vector<size_t> nbest(N);
+
+    vector<std::array<uint64_t, 3>> items;
+    for (size_t b = 0; b < m / 2; ++b)
+    {
+        items.clear();
+        for (auto v : vertices_range(g))
+        {
+            auto sk = sketch.data() + v * m;
+            if (sk[0] == empty)
+                continue;
+            items.push_back({mix(sk[2 * b] ^ mix(sk[2 * b + 1])), shash[v],
+                             uint64_t(v)});
+        }
+        std::sort(items.begin(), items.end());
+
+        // every position belongs to a different vertex, so the updates are
+        // free of races
+        #pragma omp parallel for if (items.size() > OPENMP_MIN_THRESH) \
+            schedule(runtime)
+        for (size_t p = 0; p < items.size(); ++p)
+        {
+            size_t u = items[p][2];
+            auto sku = sketch.data() + u * m;
+            auto ubest = best.data() + u * k;
+            auto& n = nbest[u];
+            size_t start = (p > k) ? p - k : 0;
+            size_t end = std::min(p + k + 1, items.size());
+            for (size_t q = start; q < end; ++q)
+            {
+                if (q == p || items[q][0] != items[p][0])
+                    continue;
+                size_t v = items[q][2];
+                bool found = false;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    if (ubest[i].second == v)
+                    {
+                        found = true;
+                        break;
+                    }
+                }
+                if (found)
+                    continue;
+                auto skv = sketch.data() + v * m;
+                size_t c = 0;
+                for (size_t i = 0; i < m; ++i)
+                    c += (sku[i] == skv[i]);
+                std::pair<double, size_t> x(c / double(m), v);
+                if (n < k)
+                {
+                    ubest[n++] = x;
+                    continue;
+                }
+                auto worst = ubest;
+                for (size_t i = 1; i < k; ++i)
+                {
+                    if (top_k_cmp()(*worst, ubest[i]))
+                        worst = ubest + i;
+                }
+                if (top_k_cmp()(x, *worst))
+                    *worst = x;
+            }
+        }
+    }
+
+    for (auto u : vertices_range(g))
+    {
+        auto ubest = best.data() + u * k;
+        std::sort(ubest, ubest + nbest[u], top_k_cmp());
+        for (size_t i = 0; i < nbest[u]; ++i)
+        {
+            pairs.push_back({int64_t(u), int64_t(ubest[i].second)});
+            sims.push_back(ubest[i].first);
+        }
+    }
+}
+
 } // graph_tool namespace
 
 #endif // GRAPH_VERTEX_SIMILARITY_HH
@@ -2486,6 +2486,28 @@ class Graph(object):
         enabled."""
         return self.__graph.get_keep_epos()
 
+    def sort_edges(self):
+        r"""Sort the out- and in-edge lists of every vertex according to the
+        neighbor index. Algorithms that intersect vertex neighborhoods (e.g.
+        :func:`~graph_tool.clustering.local_clustering`,
+        :func:`~graph_tool.topology.vertex_similarity` and
+        :func:`~graph_tool.topology.similarity`) will use faster
+        merge-based intersections if the edge lists are sorted.
+
+        The edge lists are not sorted by default, and the ordering is not
+        maintained by subsequent edge insertions, which in general break it,
+        nor by edge removals if :meth:`~Graph.set_fast_edge_removal` is
+        enabled. In these cases, this method needs to be called again. The
+        edge indexes are not modified, but the iteration order of the edges
+        may change.
+        """
+        self.__graph.sort_edges()
+
+    def get_sorted_edges(self):
+        r"""Return whether the edge lists of every vertex are currently sorted
+        according to the neighbor index (see :meth:`~Graph.sort_edges`)."""
+        return self.__graph.get_sorted_edges()
+
     def clear(self):
         """Remove all vertices and edges from the graph."""
         self.__graph.clear()
@@ -33,6 +33,12 @@ Summary
 
    local_clustering
    global_clustering
+   sampled_clustering
+   StreamingTriangles
+   edge_triangles
+   all_triangles
+   graphlet_orbits
+   ktruss_decomposition
    extended_clustering
    motifs
    motif_significance
@@ -51,8 +57,11 @@ from .. stats import vertex_hist
 
 from collections import defaultdict
 from numpy import *
+import scipy.stats
 
-__all__ = ["local_clustering", "global_clustering", "extended_clustering",
+__all__ = ["local_clustering", "global_clustering", "sampled_clustering",
+           "StreamingTriangles", "edge_triangles", "all_triangles",
+           "graphlet_orbits", "ktruss_decomposition", "extended_clustering",
            "motifs", "motif_significance"]
 
 
@@ -105,6 +114,13 @@ def local_clustering(g, weight=None, prop=None, undirected=True):
 
     The implemented algorithm runs in :math:`O(|V|\left<k^2\right>)` time,
     where :math:`\left<k^2\right>` is second moment of the degree distribution.
+    If no weights are given, and the graph is undirected, each triangle is
+    visited only once, after the edges are oriented from lower to higher degree
+    [schank-finding-2005]_ [latapy-main-memory-2008]_, which takes
+    :math:`O(|E|^{3/2})` time in the worst case, and is much faster for graphs
+    with broad degree distributions. Otherwise, if no weights are given, and
+    the edge lists are sorted (see :meth:`~graph_tool.Graph.sort_edges`), the
+    neighborhoods are intersected by merging, which is faster for large graphs.
 
     If enabled during compilation, this algorithm runs in parallel.
 
@@ -120,6 +136,13 @@ def local_clustering(g, weight=None, prop=None, undirected=True):
     .. [watts-collective-1998] D. J. Watts and Steven Strogatz, "Collective
        dynamics of 'small-world' networks", Nature, vol. 393, pp 440-442, 1998.
        :doi:`10.1038/30918`
+    .. [schank-finding-2005] T. Schank, D. Wagner, "Finding, counting and
+       listing all triangles in large graphs, an experimental study",
+       Experimental and Efficient Algorithms, WEA 2005, pp. 606-609,
+       :doi:`10.1007/11427186_54`
+    .. [latapy-main-memory-2008] M. Latapy, "Main-memory triangle computations
+       for very large (sparse (power-law)) graphs", Theoretical Computer
+       Science, vol. 407, pp. 458-473, 2008, :doi:`10.1016/j.tcs.2008.07.017`
     """
 
     if prop is None:
@@ -178,7 +201,10 @@ def global_clustering(g, weight=None, ret_counts=False):
 
     The implemented algorithm runs in time :math:`O(|V|\left<k^2\right>)`,
     where :math:`\left< k^2\right>` is the second moment of the degree
-    distribution.
+    distribution. If no weights are given, each triangle is visited only once,
+    after the edges are oriented from lower to higher degree
+    [schank-finding-2005]_ [latapy-main-memory-2008]_, which takes
+    :math:`O(|E|^{3/2})` time in the worst case.
 
     If enabled during compilation, this algorithm runs in parallel.
 
@@ -205,6 +231,490 @@ def global_clustering(g, weight=None, ret_counts=False):
         return c[:2]
 
 
+def sampled_clustering(g, samples=None, error=1e-3, confidence=.95,
+                       by_degree=False):
+    r"""Estimate the global clustering coefficient, or the average local
+    clustering of the vertices of each degree, by sampling wedges.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    samples : ``int`` (optional, default: ``None``)
+        Maximum number of wedges sampled (for each degree, if ``by_degree ==
+        True``). If ``None``, the sampling only stops when the error target is
+        met.
+    error : ``float`` (optional, default: ``1e-3``)
+        Half-width of the confidence interval to be attained. If ``None``,
+        exactly ``samples`` wedges are sampled.
+    confidence : ``float`` (optional, default: ``.95``)
+        Confidence level of the intervals.
+    by_degree : ``bool`` (optional, default: ``False``)
+        If ``True``, the average local clustering coefficient of the vertices
+        of each degree is estimated, instead of the global clustering
+        coefficient.
+
+    Returns
+    -------
+    k : :class:`numpy.ndarray` (if ``by_degree == True``)
+        Degrees of the vertices, with at least two neighbors.
+    c : ``float`` or :class:`numpy.ndarray`
+        Estimated global clustering coefficient, or average local clustering
+        of each degree.
+    delta : ``float`` or :class:`numpy.ndarray`
+        Half-width of the confidence intervals of the estimates.
+
+    See Also
+    --------
+    global_clustering: global clustering coefficient
+    local_clustering: local clustering coefficient
+
+    Notes
+    -----
+    A wedge is a path of length two, and the global clustering coefficient is
+    the fraction of wedges that are closed, i.e. that belong to a triangle
+    (see :func:`~graph_tool.clustering.global_clustering`). Likewise, the
+    average local clustering of the vertices with degree :math:`k` is the
+    probability that a wedge chosen uniformly among those of a vertex with
+    degree :math:`k`, itself chosen uniformly, is closed. Both quantities are
+    estimated by sampling wedges independently [seshadhri-wedge-2014]_, and
+    the confidence intervals are the Wilson score intervals of the fraction of
+    closed wedges. The error depends only on the number of samples, which is
+    of the order of :math:`1/\text{error}^2`, and not on the size of the
+    graph. Each sample takes :math:`O(\log V + k)` time, where :math:`k` is
+    the smallest degree of the endpoints of the wedge.
+
+    If the graph is directed, the edge directions are ignored. If the graph
+    has parallel edges, every pair of edges incident on a vertex is considered
+    a wedge, which is closed if their other endpoints are distinct and
+    adjacent. Self-loops are ignored.
+
+    If enabled during compilation, this algorithm runs in parallel, and the
+    result does not depend on the number of threads.
+
+    Examples
+    --------
+    >>> g = gt.collection.data["karate"]
+    >>> c, delta = gt.sampled_clustering(g, error=1e-3)
+    >>> print(abs(c - gt.global_clustering(g)[0]) < 3 * delta)
+    True
+
+    References
+    ----------
+    .. [seshadhri-wedge-2014] C. Seshadhri, A. Pinar, T. G. Kolda, "Wedge
+       sampling for computing clustering coefficients and triangle counts on
+       large graphs", Statistical Analysis and Data Mining, vol. 7,
+       pp. 294-307, 2014, :doi:`10.1002/sam.11224`, :arxiv:`1309.3321`
+    """
+
+    if samples is None and error is None:
+        raise ValueError("either 'samples' or 'error' must be given")
+    if samples is None:
+        samples = 2 ** 62
+    if error is None:
+        error = 0
+    z = scipy.stats.norm.ppf(1 - (1 - confidence) / 2)
+
+    def wilson(x, n):
+        n = maximum(n, 1)
+        p = x / n
+        return z * sqrt(p * (1 - p) / n + z ** 2 / (4 * n ** 2)) / \
+            (1 + z ** 2 / n)
+
+    if g.is_directed():
+        g = GraphView(g, directed=False, skip_properties=True)
+    if by_degree:
+        k, x, n = _gt.sampled_degree_clustering(g._Graph__graph, samples,
+                                                error, z, _get_rng())
+        x = array(x, dtype="float")
+        return k, x / maximum(n, 1), wilson(x, n)
+    x, n = _gt.sampled_global_clustering(g._Graph__graph, samples, error, z,
+                                         _get_rng())
+    return float(x / maximum(n, 1)), float(wilson(x, n))
+
+
+class StreamingTriangles(object):
+    def __init__(self, M):
+        r"""Estimates of the triangle counts and clustering coefficients of an
+        undirected graph, whose edges are observed as a stream.
+
+        Parameters
+        ----------
+        M : int
+            Maximum number of edges kept in memory.
+
+        See Also
+        --------
+        sampled_clustering: estimate the clustering coefficient of a graph
+        global_clustering: global clustering coefficient
+        local_clustering: local clustering coefficient
+
+        Notes
+        -----
+        The edges are fed in batches via
+        :meth:`~StreamingTriangles.add_edges`, without requiring a
+        :class:`~graph_tool.Graph` to be built. A uniform sample of at most
+        ``M`` edges is kept by reservoir sampling, and every incoming edge
+        contributes the triangles it closes with the sampled edges, weighted
+        by the inverse of the probability that they are both in the sample,
+        following the TRIEST-IMPR algorithm of [stefani-triest-2017]_. The
+        resulting estimates of the global and local triangle counts are
+        unbiased, and are exact as long as no more than ``M`` edges were
+        observed. The degrees are kept exactly, which allows the clustering
+        coefficients to be estimated as well.
+
+        Every edge is processed in :math:`O(\min(k_u, k_v))` time on
+        average, where :math:`k_u` and :math:`k_v` are the degrees of the
+        endpoints in the sample, and all queries take constant time. The
+        memory use is :math:`O(M + N)`, where :math:`N` is the largest
+        vertex index seen.
+
+        The edges are assumed to be distinct, their directions are ignored,
+        and self-loops are discarded.
+
+        Examples
+        --------
+        >>> g = gt.collection.data["karate"]
+        >>> state = gt.StreamingTriangles(1000)
+        >>> state.add_edges(g.get_edges())
+        >>> print(state.triangles(), state.global_clustering())
+        45.0 0.2556818181818182
+        >>> print(state.triangles(0), state.local_clustering(0))
+        18.0 0.15
+
+        References
+        ----------
+        .. [stefani-triest-2017] Lorenzo De Stefani, Alessandro Epasto, Matteo
+           Riondato, and Eli Upfal, "TRIEST: Counting Local and Global
+           Triangles in Fully Dynamic Streams with Fixed Memory Size", ACM
+           Transactions on Knowledge Discovery from Data 11 (4): 43 (2017),
+           :doi:`10.1145/3059194`, :arxiv:`1602.07424`
+        """
+
+        self._state = _gt.TriestEstimator(int(M), _get_rng())
+
+    def add_edges(self, edges):
+        """Ingest the edges in ``edges``, which is a sequence of pairs of
+        vertex indices (or an array of shape ``(E, k)`` with ``k >= 2``, of
+        which only the first two columns are used), in the given order."""
+        edges = asarray(edges, dtype="uint64")
+        if edges.size == 0:
+            return
+        if edges.ndim == 2:
+            edges = edges[:, :2]
+        else:
+            edges = edges.reshape((-1, 2))
+        self._state.add_edges(ascontiguousarray(edges))
+
+    def add_edge(self, u, v):
+        """Ingest a single edge ``(u, v)``."""
+        self._state.insert(int(u), int(v))
+
+    def num_edges(self):
+        """Return the number of edges observed so far, excluding
+        self-loops."""
+        return self._state.num_edges()
+
+    def triangles(self, v=None):
+        """Return the estimated number of triangles, or the number of
+        triangles containing vertex ``v``, if it is given."""
+        if v is None:
+            return self._state.triangles()
+        return self._state.vertex_triangles(int(v))
+
+    def vertex_triangles(self):
+        """Return an array with the estimated number of triangles containing
+        each vertex."""
+        return self._state.get_local()
+
+    def global_clustering(self):
+        """Return the estimated global clustering coefficient."""
+        return self._state.global_clustering()
+
+    def local_clustering(self, v):
+        """Return the estimated local clustering coefficient of vertex
+        ``v``."""
+        return self._state.local_clustering(int(v))
+
+
+def edge_triangles(g, prop=None):
+    r"""Return the number of triangles to which each edge belongs.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    prop : :class:`~graph_tool.EdgePropertyMap` (optional, default: ``None``)
+        Edge property map where results will be stored. If specified, this
+        parameter will also be the return value.
+
+    Returns
+    -------
+    prop : :class:`~graph_tool.EdgePropertyMap`
+        Edge property containing the number of triangles.
+
+    See Also
+    --------
+    all_triangles: list of all triangles
+    local_clustering: local clustering coefficient
+    global_clustering: global clustering coefficient
+
+    Notes
+    -----
+    The number of triangles to which an edge :math:`(i,j)` belongs, also
+    known as its *support*, is the number of common neighbors of :math:`i` and
+    :math:`j`. If the graph is directed, the edge directions are ignored.
+    Self-loops belong to no triangle, and parallel edges are considered only
+    once, i.e. each of them has the same support as if it were unique.
+
+    The triangles are found after the edges are oriented from lower to higher
+    degree [schank-finding-2005]_ [latapy-main-memory-2008]_, which takes
+    :math:`O(|E|^{3/2})` time in the worst case.
+
+    If enabled during compilation, this algorithm runs in parallel.
+
+    Examples
+    --------
+    >>> g = gt.collection.data["karate"]
+    >>> t = gt.edge_triangles(g)
+    >>> print(t.a.max(), t.a.sum())
+    10 135
+
+    """
+
+    if prop is None:
+        prop = g.new_edge_property("int64_t")
+    if g.is_directed():
+        g = GraphView(g, directed=False, skip_properties=True)
+    _gt.edge_triangles(g._Graph__graph, _prop("e", g, prop))
+    return prop
+
+
+def all_triangles(g):
+    r"""Return all the triangles in the graph.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+
+    Returns
+    -------
+    triangles : :class:`numpy.ndarray`
+        Array of shape ``(T, 3)``, where ``T`` is the number of triangles, with
+        the vertices of each triangle in increasing order of index. The rows
+        are sorted lexicographically.
+
+    See Also
+    --------
+    edge_triangles: number of triangles of each edge
+    global_clustering: global clustering coefficient
+    motifs: motif counting
+
+    Notes
+    -----
+    If the graph is directed, the edge directions are ignored. Each triangle is
+    listed only once, regardless of the existence of parallel edges.
+
+    The triangles are found after the edges are oriented from lower to higher
+    degree [schank-finding-2005]_ [latapy-main-memory-2008]_, which takes
+    :math:`O(|E|^{3/2})` time in the worst case.
+
+    If enabled during compilation, this algorithm runs in parallel.
+
+    Examples
+    --------
+    >>> g = gt.collection.data["karate"]
+    >>> tris = gt.all_triangles(g)
+    >>> print(len(tris))
+    45
+    >>> print(tris[:3])
+    [[0 1 2]
+     [0 1 3]
+     [0 1 7]]
+
+    """
+
+    if g.is_directed():
+        g = GraphView(g, directed=False, skip_properties=True)
+    return _gt.list_triangles(g._Graph__graph).reshape((-1, 3))
+
+
+def graphlet_orbits(g, ret_counts=False):
+    r"""Return the graphlet orbit counts of every vertex.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    ret_counts : bool (optional, default: ``False``)
+        If ``True``, the total number of each graphlet is also returned.
+
+    Returns
+    -------
+    orbits : :class:`numpy.ndarray`
+        Array of shape ``(N, 15)``, where ``orbits[v, i]`` is the number of
+        times vertex ``v`` appears in orbit ``i`` (see below).
+    counts : :class:`numpy.ndarray`
+        Total number of times each of the nine graphlets appears as an induced
+        subgraph, in the order: edge, path of length two, triangle, path of
+        length three, star with three leaves, cycle of length four, triangle
+        with a tail, cycle of length four with a chord, and complete graph of
+        four vertices. Only returned if ``ret_counts == True``.
+
+    See Also
+    --------
+    motifs: motif counting
+    all_triangles: list of all triangles
+    local_clustering: local clustering coefficient
+
+    Notes
+    -----
+    The graphlets are the connected graphs with two to four vertices, which
+    are counted when they appear as induced subgraphs. The vertices of each
+    graphlet are grouped into orbits, i.e. the classes of vertices that are
+    mapped into each other by its automorphisms, which are numbered as in
+    [przulj-biological-2007]_:
+
+    ====== ================================================================
+    Orbit  Position of the vertex
+    ====== ================================================================
+    0      any vertex of an edge (i.e. the degree)
+    1, 2   end and center of a path of length two
+    3      any vertex of a triangle
+    4, 5   end and inner vertex of a path of length three
+    6, 7   leaf and center of a star with three leaves
+    8      any vertex of a cycle of length four
+    9      end of the tail of a triangle with a tail
+    10     vertex of the triangle with degree two, in a triangle with a tail
+    11     vertex with degree three, in a triangle with a tail
+    12     vertex with degree two, in a cycle of length four with a chord
+    13     endpoint of the chord, in a cycle of length four with a chord
+    14     any vertex of a complete graph of four vertices
+    ====== ================================================================
+
+    The subgraphs are not enumerated. Instead, as in
+    [hocevar-combinatorial-2014]_ and [pinar-escape-2017]_, the counts are
+    obtained from the degrees, the number of triangles of each edge, and the
+    number of cycles of length four and complete subgraphs of four vertices
+    to which each vertex belongs, via linear relations between the orbits.
+    The triangles and four-cliques are found as in
+    :func:`~graph_tool.clustering.all_triangles`, and the cycles of length
+    four in :math:`O(a(G)|E|)` time, where :math:`a(G)` is the arboricity of
+    the graph [chiba-arboricity-1985]_.
+
+    If the graph is directed, the edge directions are ignored. Self-loops are
+    ignored, and parallel edges are considered only once.
+
+    If enabled during compilation, this algorithm runs in parallel.
+
+    Examples
+    --------
+    >>> g = gt.collection.data["karate"]
+    >>> orbits, counts = gt.graphlet_orbits(g, ret_counts=True)
+    >>> print(orbits[0])
+    [ 16  17 102  18  81 197  13 352  10   6  34 171   2  30   7]
+    >>> print(counts)
+    [  78  393   45  681 1098   36  452   85   11]
+
+    References
+    ----------
+    .. [przulj-biological-2007] Natasa Przulj, "Biological network comparison
+       using graphlet degree distribution", Bioinformatics 23, e177-e183
+       (2007), :doi:`10.1093/bioinformatics/btl301`
+    .. [hocevar-combinatorial-2014] Tomaz Hocevar and Janez Demsar, "A
+       combinatorial approach to graphlet counting", Bioinformatics 30,
+       559-565 (2014), :doi:`10.1093/bioinformatics/btt717`
+    .. [pinar-escape-2017] Ali Pinar, C. Seshadhri and Vaidyanathan Vishal,
+       "ESCAPE: Efficiently counting all 5-vertex subgraphs", Proceedings of
+       the 26th International Conference on World Wide Web, 1431-1440 (2017),
+       :doi:`10.1145/3038912.3052597`
+    .. [chiba-arboricity-1985] Norishige Chiba and Takao Nishizeki,
+       "Arboricity and subgraph listing algorithms", SIAM Journal on
+       Computing 14, 210-223 (1985), :doi:`10.1137/0214017`
+
+    """
+
+    if g.is_directed():
+        g = GraphView(g, directed=False, skip_properties=True)
+    orbits = _gt.graphlet_orbits(g._Graph__graph).reshape((-1, 15))
+    if ret_counts:
+        o = orbits.sum(axis=0)
+        counts = array([o[0] // 2, o[2], o[3] // 3, o[5] // 2, o[7], o[8] // 4,
+                        o[11], o[13] // 2, o[14] // 4])
+        return orbits, counts
+    return orbits
+
+
+def ktruss_decomposition(g, eprop=None):
+    r"""Perform a k-truss decomposition of the given graph.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    eprop : :class:`~graph_tool.EdgePropertyMap` (optional, default: ``None``)
+        Edge property to store the decomposition. If ``None`` is supplied,
+        one is created.
+
+    Returns
+    -------
+    kval : :class:`~graph_tool.EdgePropertyMap`
+        Edge property map with the k-truss decomposition, i.e. a given edge e
+        belongs to the ``kval[e]``-truss.
+
+    See Also
+    --------
+    edge_triangles: number of triangles of each edge
+    graph_tool.topology.kcore_decomposition: k-core decomposition
+
+    Notes
+    -----
+
+    The k-truss is a maximal set of edges such that every edge in it belongs
+    to at least :math:`k-2` triangles formed by edges of the set
+    [cohen-trusses-2008]_. Every edge belongs to the 2-truss, and the k-truss
+    is contained in the (k-1)-core.
+
+    If the graph is directed, the edge directions are ignored. Parallel edges
+    are considered only once, and hence receive the same value, and self-loops
+    belong only to the 2-truss.
+
+    The PKT algorithm of [kabir-parallel-truss-2017]_ is used, where the
+    number of triangles of each edge is obtained as in
+    :func:`~graph_tool.clustering.edge_triangles`, and all edges with the same
+    truss number are then peeled concurrently. It runs in
+    :math:`O(|E|^{3/2})` time in the worst case.
+
+    If enabled during compilation, this algorithm runs in parallel.
+
+    Examples
+    --------
+
+    >>> g = gt.collection.data["karate"]
+    >>> ktruss = gt.ktruss_decomposition(g)
+    >>> print(ktruss.a.max(), (ktruss.a == 5).sum())
+    5 14
+
+    References
+    ----------
+    .. [cohen-trusses-2008] J. Cohen, "Trusses: Cohesive subgraphs for social
+       network analysis", National Security Agency Technical Report, 2008.
+    .. [kabir-parallel-truss-2017] Humayun Kabir and Kamesh Madduri,
+       "Shared-memory graph truss decomposition", IEEE 24th International
+       Conference on High Performance Computing (HiPC), 13-22 (2017),
+       :doi:`10.1109/HiPC.2017.00012`
+
+    """
+
+    if eprop is None:
+        eprop = g.new_edge_property("int32_t")
+    if g.is_directed():
+        g = GraphView(g, directed=False, skip_properties=True)
+    _gt.ktruss_decomposition(g._Graph__graph, _prop("e", g, eprop))
+    return eprop
+
+
 def extended_clustering(g, props=None, max_depth=3, undirected=False):
     r"""
     Return the extended clustering coefficients for all vertices.
@@ -252,9 +762,13 @@ def extended_clustering(g, props=None, max_depth=3, undirected=False):
     definition, we have that the traditional local clustering coefficient is
     recovered for :math:`d=1`, i.e., :math:`c^1_i = c_i`.
 
-    The implemented algorithm runs in
-    :math:`O(|V|\left<k\right>^{2+\text{max-depth}})` worst time, where
-    :math:`\left< k\right>` is the average out-degree.
+    For each vertex, a single breadth-first search bounded by ``max_depth``
+    is run from each of its neighbors, which finds the distances to all the
+    other neighbors at once. Each search stops early once all the neighbors
+    are found, and the last level is only explored when that is cheaper than
+    inspecting the neighborhoods of the remaining targets. The implemented
+    algorithm runs in :math:`O(|V|\left<k\right>^{1+\text{max-depth}})`
+    worst time, where :math:`\left< k\right>` is the average out-degree.
 
     If enabled during compilation, this algorithm runs in parallel.
 
@@ -332,11 +846,16 @@ def motifs(g, k, p=1.0, motif_list=None, return_maps=False):
     local_clustering: local clustering coefficient
     global_clustering: global clustering coefficient
     extended_clustering: extended (generalized) clustering coefficient
+    graphlet_orbits: graphlet orbit counts of every vertex
 
     Notes
     -----
     This functions implements the ESU and RAND-ESU algorithms described in
-    [wernicke-efficient-2006]_.
+    [wernicke-efficient-2006]_. Subgraphs with up to seven vertices and no
+    parallel edges are classified by a canonical labeling of their adjacency
+    matrices, instead of isomorphism tests against every known motif. For
+    :math:`k \le 4`, :func:`~graph_tool.clustering.graphlet_orbits` is much
+    faster.
 
     If enabled during compilation, this algorithm runs in parallel.
 
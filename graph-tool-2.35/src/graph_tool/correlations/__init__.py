@@ -44,11 +44,61 @@ dl_import("from . import libgraph_tool_correlations")
 
 from .. import _degree, _prop, _check_prop_scalar, VertexPropertyMap
 from numpy import *
+import numbers
 
 __all__ = ["assortativity", "scalar_assortativity", "corr_hist",
            "combined_corr_hist", "avg_neighbor_corr", "avg_neighbour_corr",
            "avg_combined_corr"]
 
+def _get_values(g, deg):
+    """Returns the values of the degree type or vertex property map ``deg`` for
+    the vertices of ``g``."""
+    vs = g.get_vertices()
+    if isinstance(deg, str):
+        if deg in ["in", "in-degree"]:
+            return g.get_in_degrees(vs)
+        if deg in ["out", "out-degree"]:
+            return g.get_out_degrees(vs)
+        if deg in ["total", "total-degree"]:
+            return g.get_total_degrees(vs)
+        deg = g.vp[deg]
+    return deg.a[vs]
+
+def _get_bins(g, deg, bins, count=None):
+    """Returns the bin edges given by ``bins`` as a list of floats. If ``bins``
+    is an integer, at most that many bins are chosen from the quantiles of the
+    values of ``deg``, with each vertex counted once per out-edge or in-edge if
+    ``count`` is ``"out"`` or ``"in"``, respectively, or once otherwise."""
+    if not isinstance(bins, numbers.Integral):
+        return [float(x) for x in bins]
+    if bins < 1:
+        raise ValueError("the number of bins must be positive")
+    x = asarray(_get_values(g, deg), dtype="float")
+    if len(x) == 0:
+        return [0., 1.]
+    vs = g.get_vertices()
+    if count == "out" or (count == "in" and not g.is_directed()):
+        w = g.get_out_degrees(vs)
+    elif count == "in":
+        w = g.get_in_degrees(vs)
+    else:
+        w = ones(len(x))
+    idx = argsort(x, kind="stable")
+    x = x[idx]
+    c = cumsum(asarray(w, dtype="float")[idx])
+    pos = searchsorted(c, c[-1] * arange(1, bins) / bins, side="right")
+    if all(x == floor(x)):
+        last = x[-1] + 1
+    else:
+        last = nextafter(x[-1], inf)
+    edges = unique(concatenate(([x[0]], x[pos.clip(max=len(x) - 1)],
+                                [last])))
+    if len(edges) == 2:
+        # two values would be interpreted as the first edge and the bin width,
+        # so a second bin of the same width is appended
+        edges = append(edges, 2 * edges[1] - edges[0])
+    return [float(x) for x in edges]
+
 
 def assortativity(g, deg, eweight=None):
     r"""Obtain the assortativity coefficient for the given graph.
@@ -206,7 +256,10 @@ def corr_hist(g, deg_source, deg_target, bins=[[0, 1], [0, 1]], weight=None,
         A list of bin edges to be used for the source and target degrees. If any
         list has size 2, it is used to create an automatically generated bin
         range starting from the first value, and with constant bin width given
-        by the second value.
+        by the second value. If an integer :math:`n` is given instead of a list,
+        at most :math:`n` bins are chosen from the quantiles of the values at
+        the corresponding endpoints of the edges, so that they contain roughly
+        the same number of edges, which is useful for broad distributions.
     weight : edge property map (optional, default: None)
         Weight (multiplicative factor) to be used on each edge.
     float_count : bool (optional, default: True)
@@ -239,6 +292,10 @@ def corr_hist(g, deg_source, deg_target, bins=[[0, 1], [0, 1]], weight=None,
     property) 'source_deg', the number of out-neighbors with degree (or scalar
     property) 'target_deg'.
 
+    The counts are accumulated in sparse histograms, so that the memory used
+    before the result is returned is proportional to the number of occupied
+    bins, rather than to the total number of bins.
+
     If enabled during compilation, this algorithm runs in parallel.
 
     Examples
@@ -279,14 +336,32 @@ def corr_hist(g, deg_source, deg_target, bins=[[0, 1], [0, 1]], weight=None,
         :align: center
 
         Out/out-degree correlation histogram.
+
+    If the number of bins is given, the bin edges are obtained from the
+    values, even if these are all identical, such as the degrees of a regular
+    graph, or a constant property:
+
+    .. doctest:: corr_hist
+
+       >>> g = gt.lattice([10, 10], periodic=True)
+       >>> h = gt.corr_hist(g, "out", "out", bins=[10, 10])
+       >>> print(h[0])
+       [[400.   0.]
+        [  0.   0.]]
+       >>> print(h[1])
+       [array([4, 5, 6], dtype=uint64), array([4, 5, 6], dtype=uint64)]
+       >>> x = g.new_vertex_property("int", val=3)
+       >>> h = gt.corr_hist(g, x, x, bins=[10, 10])
+       >>> print(h[1])
+       [array([3, 4, 5], dtype=int32), array([3, 4, 5], dtype=int32)]
     """
 
     ret = libgraph_tool_correlations.\
           vertex_correlation_histogram(g._Graph__graph, _degree(g, deg_source),
                                        _degree(g, deg_target),
                                        _prop("e", g, weight),
-                                       [float(x) for x in bins[0]],
-                                       [float(x) for x in bins[1]])
+                                       _get_bins(g, deg_source, bins[0], "out"),
+                                       _get_bins(g, deg_target, bins[1], "in"))
     return [array(ret[0], dtype="float64") if float_count else ret[0],
             [ret[1][0], ret[1][1]]]
 
@@ -307,7 +382,10 @@ def combined_corr_hist(g, deg1, deg2, bins=[[0, 1], [0, 1]], float_count=True):
         A list of bin edges to be used for the first and second degrees. If any
         list has size 2, it is used to create an automatically generated bin
         range starting from the first value, and with constant bin width given
-        by the second value.
+        by the second value. If an integer :math:`n` is given instead of a list,
+        at most :math:`n` bins are chosen from the quantiles of the
+        corresponding values, so that they contain roughly the same number of
+        vertices.
     float_count : bool (optional, default: True)
         If True, the bin counts are converted float variables, which is useful
         for normalization, and other processing. It False, the bin counts will
@@ -377,8 +455,8 @@ def combined_corr_hist(g, deg1, deg2, bins=[[0, 1], [0, 1]], float_count=True):
           vertex_combined_correlation_histogram(g._Graph__graph,
                                                 _degree(g, deg1),
                                                 _degree(g, deg2),
-                                                [float(x) for x in bins[0]],
-                                                [float(x) for x in bins[1]])
+                                                _get_bins(g, deg1, bins[0]),
+                                                _get_bins(g, deg2, bins[1]))
     return [array(ret[0], dtype="float64") if float_count else ret[0],
             [ret[1][0], ret[1][1]]]
 
@@ -400,7 +478,10 @@ def avg_neighbor_corr(g, deg_source, deg_target, bins=[0, 1], weight=None):
     bins : list (optional, default: [0, 1])
         Bins to be used for the source degrees. If the list has size 2, it is
         used as the constant width of an automatically generated bin range,
-        starting from the first value.
+        starting from the first value. If an integer :math:`n` is given
+        instead, at most :math:`n` bins are chosen from the quantiles of the
+        values at the sources of the edges, so that they contain roughly the
+        same number of edges.
     weight : edge property map (optional, default: None)
         Weight (multiplicative factor) to be used on each edge.
 
@@ -474,7 +555,7 @@ def avg_neighbor_corr(g, deg_source, deg_target, bins=[0, 1], weight=None):
     ret = libgraph_tool_correlations.\
           vertex_avg_correlation(g._Graph__graph, _degree(g, deg_source),
                                  _degree(g, deg_target), _prop("e", g, weight),
-                                 [float(x) for x in bins])
+                                 _get_bins(g, deg_source, bins, "out"))
     return [ret[0], ret[1], ret[2][0]]
 
 avg_neighbour_corr = avg_neighbor_corr
@@ -494,7 +575,9 @@ def avg_combined_corr(g, deg1, deg2, bins=[0, 1]):
     bins : list (optional, default: [0, 1])
         Bins to be used for the first degrees. If the list has size 2, it is
         used as the constant width of an automatically generated bin range,
-        starting from the first value.
+        starting from the first value. If an integer :math:`n` is given
+        instead, at most :math:`n` bins are chosen from the quantiles of the
+        values, so that they contain roughly the same number of vertices.
 
     Returns
     -------
@@ -559,5 +642,5 @@ def avg_combined_corr(g, deg1, deg2, bins=[0, 1]):
     ret = libgraph_tool_correlations.\
           vertex_avg_combined_correlation(g._Graph__graph, _degree(g, deg1),
                                           _degree(g, deg2),
-                                          [float(x) for x in bins])
+                                          _get_bins(g, deg1, bins))
     return [ret[0], ret[1], ret[2][0]]
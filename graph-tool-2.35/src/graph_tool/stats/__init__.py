@@ -32,6 +32,7 @@ Summary
    edge_hist
    vertex_average
    edge_average
+   graph_profile
    label_parallel_edges
    remove_parallel_edges
    label_self_loops
@@ -51,7 +52,7 @@ from .. import _degree, _prop, _get_rng, GraphView, PropertyMap
 from numpy import *
 
 __all__ = ["vertex_hist", "edge_hist", "vertex_average", "edge_average",
-           "label_parallel_edges", "remove_parallel_edges",
+           "graph_profile", "label_parallel_edges", "remove_parallel_edges",
            "label_self_loops", "remove_self_loops", "remove_labeled_edges",
            "distance_histogram"]
 
@@ -308,6 +309,141 @@ def edge_average(g, eprop):
     return a, aa
 
 
+_profile_stats = ["vertex_hist", "vertex_average", "edge_hist", "edge_average",
+                  "assortativity", "scalar_assortativity", "corr_hist"]
+
+
+def graph_profile(g, stats=None, deg="total", eprop=None, vbins=[0, 1],
+                  ebins=[0, 1], cbins=[[0, 1], [0, 1]], float_count=True):
+    r"""
+    Return several statistics of the graph, computed together in a single pass.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    stats : list of strings (optional, default: ``None``)
+        Statistics to be computed, which can be any of ``"vertex_hist"``,
+        ``"vertex_average"``, ``"edge_hist"``, ``"edge_average"``,
+        ``"assortativity"``, ``"scalar_assortativity"``, ``"corr_hist"`` and
+        ``"global_clustering"``. If not given, all of them will be computed,
+        except the edge statistics if ``eprop`` is ``None``.
+    deg : string or :class:`~graph_tool.VertexPropertyMap` (optional, default: ``"total"``)
+        Degree type ("in", "out" or "total") or scalar vertex property map used
+        for the vertex and correlation statistics.
+    eprop : :class:`~graph_tool.EdgePropertyMap` (optional, default: ``None``)
+        Scalar edge property used for the edge statistics.
+    vbins : list of bins (optional, default: ``[0, 1]``)
+        Bins of the vertex histogram, as in :func:`vertex_hist`.
+    ebins : list of bins (optional, default: ``[0, 1]``)
+        Bins of the edge histogram, as in :func:`edge_hist`.
+    cbins : list of bins (optional, default: ``[[0, 1], [0, 1]]``)
+        Bins of the correlation histogram, as in
+        :func:`~graph_tool.correlations.corr_hist`.
+    float_count : bool (optional, default: ``True``)
+        If ``True``, the histogram counts will be returned as floats. If
+        ``False``, they will be returned as integers.
+
+    Returns
+    -------
+    profile : ``dict``
+        Dictionary with the requested statistics as keys, and with values as
+        returned by the function of the same name, i.e. :func:`vertex_hist`,
+        :func:`vertex_average`, :func:`edge_hist`, :func:`edge_average`,
+        :func:`~graph_tool.correlations.assortativity`,
+        :func:`~graph_tool.correlations.scalar_assortativity`,
+        :func:`~graph_tool.correlations.corr_hist` and
+        :func:`~graph_tool.clustering.global_clustering`, called with ``deg``
+        (for both endpoints of the edges), ``eprop`` and the corresponding
+        bins.
+
+    See Also
+    --------
+    vertex_hist : Vertex histograms.
+    edge_hist : Edge histograms.
+    vertex_average : Average of vertex properties, degrees.
+    edge_average : Average of edge properties.
+
+    Notes
+    -----
+    All the statistics except the global clustering coefficient are obtained
+    from a single traversal of the vertices and edges, using thread-local
+    accumulators which are merged at the end. For integer values of ``deg``,
+    the assortativity coefficients and the correlation histogram are all
+    computed from the joint counts of the values at the endpoints of the
+    edges. Otherwise, they are accumulated during the traversal, and the
+    jackknife variances of the assortativity coefficients require an
+    additional pass over the edges. The global clustering coefficient
+    requires the enumeration of triangles, which is done separately.
+
+    No edge weights are used for the correlation and clustering statistics,
+    and the bin edges of the edge histogram are always floating-point values.
+
+    The algorithm runs in :math:`O(|V| + |E|)` time, plus the time taken by
+    :func:`~graph_tool.clustering.global_clustering`, if requested.
+
+    If enabled during compilation, this algorithm runs in parallel.
+
+    Examples
+    --------
+    >>> g = gt.collection.data["karate"]
+    >>> p = gt.graph_profile(g, ["vertex_average", "assortativity",
+    ...                          "global_clustering"])
+    >>> print(p["vertex_average"])
+    (4.588235294117..., 0.6551864509...)
+    >>> print(p["assortativity"])
+    (-0.0777450257..., 0.0242585081...)
+    >>> print(p["global_clustering"])
+    (0.2556818181..., 0.06314746595...)
+    """
+
+    all_stats = _profile_stats + ["global_clustering"]
+    if stats is None:
+        stats = [s for s in all_stats
+                 if eprop is not None or s not in ["edge_hist", "edge_average"]]
+    for s in stats:
+        if s not in all_stats:
+            raise ValueError("Unknown statistic: " + str(s))
+    if eprop is None and ("edge_hist" in stats or "edge_average" in stats):
+        raise ValueError("An edge property is required for the edge statistics.")
+    if isinstance(deg, PropertyMap) and "string" in deg.value_type():
+        raise ValueError("Cannot calculate statistics of property type: " +
+                         deg.value_type())
+
+    flags = 0
+    for i, s in enumerate(_profile_stats):
+        if s in stats:
+            flags |= 1 << i
+
+    ret = {}
+    if flags != 0:
+        ret = libgraph_tool_stats.\
+              get_graph_profile(g._Graph__graph, _degree(g, deg),
+                                _prop("e", g, eprop), flags,
+                                [float(x) for x in vbins],
+                                [float(x) for x in ebins],
+                                [float(x) for x in cbins[0]],
+                                [float(x) for x in cbins[1]])
+    for s in ["vertex_hist", "edge_hist"]:
+        if s in ret:
+            h, b = ret[s]
+            ret[s] = [array(h, dtype="float64") if float_count else h, b]
+    for s in ["vertex_average", "edge_average"]:
+        if s in ret:
+            a, aa, count = ret[s]
+            a /= count
+            aa = sqrt((aa / count - a ** 2) / count)
+            ret[s] = (a, aa)
+    if "corr_hist" in ret:
+        h, b = ret["corr_hist"]
+        ret["corr_hist"] = [array(h, dtype="float64") if float_count else h,
+                            [b[0], b[1]]]
+    if "global_clustering" in stats:
+        from .. clustering import global_clustering
+        ret["global_clustering"] = global_clustering(g)
+    return ret
+
+
 def remove_labeled_edges(g, label):
     """Remove every edge `e` such that `label[e] != 0`."""
     u = GraphView(g, directed=True, reversed=g.is_reversed(),
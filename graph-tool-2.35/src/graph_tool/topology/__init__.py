@@ -37,6 +37,7 @@ Summary
    all_paths
    all_circuits
    pseudo_diameter
+   diameter
    similarity
    vertex_similarity
    isomorphism
@@ -50,6 +51,7 @@ Summary
    dominator_tree
    topological_sort
    transitive_closure
+   ReachabilityOracle
    tsp_tour
    sequential_vertex_coloring
    label_components
@@ -57,9 +59,12 @@ Summary
    label_largest_component
    extract_largest_component
    label_out_component
+   ConnectivityOracle
    vertex_percolation
    edge_percolation
+   random_percolation
    kcore_decomposition
+   DynamicKCore
    is_bipartite
    is_DAG
    is_planar
@@ -84,18 +89,23 @@ __all__ = ["isomorphism", "subgraph_isomorphism", "mark_subgraph",
            "max_cliques", "max_cardinality_matching",
            "max_independent_vertex_set", "min_spanning_tree",
            "random_spanning_tree", "dominator_tree", "topological_sort",
-           "transitive_closure", "tsp_tour", "sequential_vertex_coloring",
+           "transitive_closure", "ReachabilityOracle", "tsp_tour",
+           "sequential_vertex_coloring",
            "label_components", "label_largest_component",
            "extract_largest_component", "label_biconnected_components",
-           "label_out_component", "vertex_percolation", "edge_percolation",
-           "kcore_decomposition", "shortest_distance", "shortest_path",
+           "label_out_component", "ConnectivityOracle", "vertex_percolation",
+           "edge_percolation", "random_percolation", "kcore_decomposition",
+           "DynamicKCore",
+           "shortest_distance", "shortest_path",
            "random_shortest_path", "count_shortest_paths", "all_shortest_paths",
            "all_predecessors", "all_paths", "all_circuits", "pseudo_diameter",
-           "is_bipartite", "is_DAG", "is_planar", "make_maximal_planar",
-           "similarity", "vertex_similarity", "edge_reciprocity"]
+           "diameter", "is_bipartite", "is_DAG", "is_planar",
+           "make_maximal_planar", "similarity", "vertex_similarity",
+           "edge_reciprocity"]
 
 def similarity(g1, g2, eweight1=None, eweight2=None, label1=None, label2=None,
-               norm=True, p=1., distance=False, asymmetric=False):
+               norm=True, p=1., distance=False, asymmetric=False,
+               vertex_diff=False):
     r"""Return the adjacency similarity between the two graphs.
 
     Parameters
@@ -125,11 +135,21 @@ def similarity(g1, g2, eweight1=None, eweight2=None, label1=None, label2=None,
     asymmetric : bool (optional, default: ``False``)
         If ``True``, the asymmetric similarity of ``g1`` to ``g2`` will be
         computed.
+    vertex_diff : bool (optional, default: ``False``)
+        If ``True``, the differences between the graphs will also be reported
+        for every vertex label. The labels need to be integers.
 
     Returns
     -------
     similarity : float
         Adjacency similarity value.
+    labels : :class:`numpy.ndarray`
+        Vertex labels with a non-zero difference, in ascending order. This is
+        only returned if ``vertex_diff == True``.
+    diffs : :class:`numpy.ndarray`
+        Difference :math:`\sum_j\left|A_{ij}^{(1)} - A_{ij}^{(2)}\right|^p`
+        for every label :math:`i` in ``labels``. This is only returned if
+        ``vertex_diff == True``.
 
     Notes
     -----
@@ -171,10 +191,23 @@ def similarity(g1, g2, eweight1=None, eweight2=None, label1=None, label2=None,
     where :math:`H(x)` is the unit step function, and the total sum is changed
     accordingly to :math:`E=\left(\sum_{i\le j}|A_{ij}^{(1)}|^p\right)^{1/p}`.
 
-    The algorithm runs with complexity :math:`O(E_1 + V_1 + E_2 + V_2)`.
+    The algorithm runs with complexity :math:`O(E_1 + V_1 + E_2 + V_2)`. If
+    the edge lists of both graphs are sorted (see
+    :meth:`~graph_tool.Graph.sort_edges`), and the labels are increasing with
+    the vertex indexes (as is the case by default), the neighborhoods are
+    compared by merging, instead of using hash tables.
 
-    If enabled during compilation, and the vertex labels are integers bounded by
-    the sizes of the graphs, this algorithm runs in parallel.
+    If the vertex labels are integers not bounded by the sizes of the graphs,
+    or if ``vertex_diff == True``, the edges of both graphs are collected into
+    arrays keyed by the labels of their endpoints, which are sorted and
+    compared by merging. This takes time :math:`O(E_1\log E_1 + E_2\log
+    E_2)`, or only :math:`O(E_1 + E_2)` for directed graphs with sorted edge
+    lists and labels that increase with the vertex indexes, and the
+    differences of every row of the adjacency matrix are obtained in the same
+    pass. The vertex labels are assumed to be unique.
+
+    If enabled during compilation, and the vertex labels are integers, this
+    algorithm runs in parallel.
 
     Examples
     --------
@@ -193,6 +226,9 @@ def similarity(g1, g2, eweight1=None, eweight2=None, label1=None, label2=None,
     17
     >>> gt.similarity(u, g)
     0.05
+    >>> s, labels, diffs = gt.similarity(u, g, vertex_diff=True)
+    >>> print(diffs.sum() / (g.num_edges() + u.num_edges()))
+    0.95
 
     """
 
@@ -230,8 +266,23 @@ def similarity(g1, g2, eweight1=None, eweight2=None, label1=None, label2=None,
         ew1 = _prop("e", g1, eweight1)
         ew2 = _prop("e", g2, eweight2)
 
-    if ((label1.is_writable() and label1.fa.max() > g1.num_vertices()) or
-        (label2.is_writable() and label2.fa.max() > g2.num_vertices())):
+    integer = label1.value_type() in ["bool", "int16_t", "int32_t", "int64_t"]
+    if not label1.is_writable():
+        integer = True   # vertex index
+    bounded = not ((label1.is_writable() and
+                    label1.fa.max() > g1.num_vertices()) or
+                   (label2.is_writable() and
+                    label2.fa.max() > g2.num_vertices()))
+
+    if vertex_diff and not integer:
+        raise ValueError("vertex labels must be integers if vertex_diff == True")
+
+    if vertex_diff or (integer and not bounded):
+        s, labels, diffs = libgraph_tool_topology.\
+               similarity_sorted(g1._Graph__graph, g2._Graph__graph,
+                                 ew1, ew2, _prop("v", g1, label1),
+                                 _prop("v", g2, label2), p, asymmetric)
+    elif not bounded:
         s = libgraph_tool_topology.\
                similarity(g1._Graph__graph, g2._Graph__graph,
                           ew1, ew2, _prop("v", g1, label1),
@@ -261,14 +312,16 @@ def similarity(g1, g2, eweight1=None, eweight2=None, label1=None, label2=None,
     if not distance:
         s = E - s
     if norm:
-        return s / E
+        s /= E
+    if vertex_diff:
+        return s, labels, diffs
     return s
 
 @_limit_args({"sim_type": ["dice", "salton", "hub-promoted", "hub-suppressed",
                            "jaccard", "inv-log-weight", "resource-allocation",
                            "leicht-holme-newman"]})
 def vertex_similarity(g, sim_type="jaccard", vertex_pairs=None, eweight=None,
-                      sim_map=None):
+                      sim_map=None, top_k=None, minhash=None):
     r"""Return the similarity between pairs of vertices.
 
     Parameters
@@ -288,6 +341,13 @@ def vertex_similarity(g, sim_type="jaccard", vertex_pairs=None, eweight=None,
         If provided, and ``vertex_pairs is None``, the vertex similarities will
         be stored in this vector-valued property. Otherwise, a new one will be
         created.
+    top_k : ``int`` (optional, default: ``None``)
+        If provided, only the ``top_k`` most similar vertices to each vertex
+        will be returned, as a sparse list of pairs (see below).
+    minhash : ``int`` (optional, default: ``None``)
+        If provided together with ``top_k``, and ``sim_type == "jaccard"``,
+        the similarities will be approximated using MinHash sketches with this
+        number of hash functions (see below).
 
     Returns
     -------
@@ -296,6 +356,12 @@ def vertex_similarity(g, sim_type="jaccard", vertex_pairs=None, eweight=None,
         with the corresponding similarities, otherwise it will be a
         vector-valued vertex :class:`~graph_tool.VertexPropertyMap`, with the
         similarities to all other vertices.
+    pairs : :class:`numpy.ndarray`
+        If ``top_k`` was supplied, an array of shape ``(M, 2)`` with the pairs
+        of vertices is returned, followed by the array ``similarities`` with
+        their similarities. The pairs are grouped by their first vertex, in
+        increasing order of index, and sorted in decreasing order of
+        similarity.
 
     Notes
     -----
@@ -411,7 +477,30 @@ def vertex_similarity(g, sim_type="jaccard", vertex_pairs=None, eweight=None,
 
     The algorithm runs with complexity :math:`O(\left<k\right>N^2)` if
     ``vertex_pairs is None``, otherwise with :math:`O(\left<k\right>P)` where
-    :math:`P` is the length of ``vertex_pairs``.
+    :math:`P` is the length of ``vertex_pairs``. If no weights are given, and
+    the edge lists of the graph are sorted (see
+    :meth:`~graph_tool.Graph.sort_edges`), the neighborhoods are intersected by
+    merging, which is faster for large graphs.
+
+    If ``top_k`` is given, the similarities are computed only between vertices
+    with at least one common neighbor, since all other pairs have zero
+    similarity, and for every vertex the ``top_k`` most similar ones are kept,
+    with ties broken by the vertex index. The common neighbors of each vertex
+    with all others are accumulated in a single traversal of its two-hop
+    neighborhood, and hence this runs in time :math:`O(\sum_w k_w^2)`, where
+    :math:`k_w` is the degree of vertex :math:`w`, using :math:`O(N)` memory
+    per thread.
+
+    If furthermore ``minhash`` is given, the (unweighted) Jaccard similarity
+    is approximated via MinHash sketches [broder-resemblance-1997]_ of the
+    neighborhoods, and candidate pairs are found via locality-sensitive
+    hashing, by grouping vertices that share bands of two sketch entries
+    [leskovec-mining-2014]_. This avoids the enumeration of the two-hop
+    neighborhoods altogether, and runs in time :math:`O(mN(\log N + mk))`,
+    where :math:`m` is the number of hash functions and :math:`k` is
+    ``top_k``, but some of the most similar pairs may be missed. The
+    estimated similarities have a standard deviation of at most
+    :math:`1/(2\sqrt{m})`.
 
     If enabled during compilation, this algorithm runs in parallel.
 
@@ -437,6 +526,15 @@ def vertex_similarity(g, sim_type="jaccard", vertex_pairs=None, eweight=None,
 
        Jaccard similarities to vertex ``0`` in a political books network.
 
+    The most similar pairs can be obtained directly, without computing all
+    similarities:
+
+    >>> pairs, sim = gt.vertex_similarity(g, "jaccard", top_k=1)
+    >>> print(pairs[:3], sim[:3])
+    [[0 5]
+     [1 0]
+     [2 5]] [0.625      0.42857143 0.375     ]
+
     References
     ----------
     .. [sorensen-dice] https://en.wikipedia.org/wiki/S%C3%B8rensen%E2%80%93Dice_coefficient
@@ -461,9 +559,36 @@ def vertex_similarity(g, sim_type="jaccard", vertex_pairs=None, eweight=None,
        "Predicting missing links via local information", The European Physical
        Journal B 71, no. 4: 623-630 (2009), :doi:`10.1140/epjb/e2009-00335-8`,
        :arxiv:`0901.0553`
+    .. [broder-resemblance-1997] Andrei Z. Broder, "On the resemblance and
+       containment of documents", Proceedings of Compression and Complexity of
+       Sequences, 21-29 (1997), :doi:`10.1109/SEQUEN.1997.666900`
+    .. [leskovec-mining-2014] Jure Leskovec, Anand Rajaraman, and Jeffrey
+       D. Ullman, "Mining of Massive Datasets", Chapter 3, Cambridge University
+       Press (2014), :doi:`10.1017/CBO9781139924801`
 
     """
 
+    if top_k is not None:
+        if vertex_pairs is not None:
+            raise ValueError("`top_k` cannot be used with `vertex_pairs`")
+        if top_k < 1:
+            raise ValueError("`top_k` must be positive")
+        if minhash is not None:
+            if sim_type != "jaccard" or eweight is not None:
+                raise ValueError("`minhash` can only be used with unweighted " +
+                                 "Jaccard similarity")
+            return libgraph_tool_topology.minhash_top_k(g._Graph__graph,
+                                                        int(top_k),
+                                                        int(minhash),
+                                                        _get_rng())
+        if eweight is None:
+            eweight = libcore.any()
+        else:
+            eweight = _prop("e", g, eweight)
+        return libgraph_tool_topology.similarity_top_k(g._Graph__graph,
+                                                       sim_type, int(top_k),
+                                                       eweight)
+
     if eweight is None:
         eweight = libcore.any()
     else:
@@ -624,7 +749,8 @@ def isomorphism(g1, g2, vertex_inv1=None, vertex_inv2=None, isomap=False):
 
 
 def subgraph_isomorphism(sub, g, max_n=0, vertex_label=None, edge_label=None,
-                         induced=False, subgraph=True, generator=False):
+                         induced=False, subgraph=True, generator=False,
+                         parallel=False, flat=False, count=False):
     r"""Obtain all subgraph isomorphisms of `sub` in `g` (or at most `max_n` subgraphs, if `max_n > 0`).
 
 
@@ -656,13 +782,28 @@ def subgraph_isomorphism(sub, g, max_n=0, vertex_label=None, edge_label=None,
         If ``True``, a generator will be returned, instead of a list. This is
         useful if the number of isomorphisms is too large to store in memory. If
         ``generator == True``, the option ``max_n`` is ignored.
+    parallel : bool (optional, default: ``False``)
+        If ``True``, the matches are found with the candidate filtering
+        algorithm described below, instead of VF2, which runs in parallel,
+        unless ``generator == True``.
+    flat : bool (optional, default: ``False``)
+        If ``True``, all matches are returned at once in a two-dimensional
+        array (see below). This implies ``parallel == True``.
+    count : bool (optional, default: ``False``)
+        If ``True``, only the number of matches is returned, without storing
+        them. This implies ``parallel == True``.
 
     Returns
     -------
     vertex_maps : list (or generator) of :class:`~graph_tool.VertexPropertyMap` objects
         List (or generator) containing vertex property map objects which
         indicate different isomorphism mappings. The property maps vertices in
-        `sub` to the corresponding vertex index in `g`.
+        `sub` to the corresponding vertex index in `g`. If ``flat == True``, a
+        :class:`numpy.ndarray` of shape ``(M, sub.num_vertices())`` is
+        returned instead, where ``M`` is the number of matches, such that
+        ``vertex_maps[i, j]`` is the vertex of `g` corresponding to the
+        ``j``-th vertex of `sub` in match ``i``. If ``count == True``, an
+        integer is returned.
 
     Notes
     -----
@@ -672,6 +813,24 @@ def subgraph_isomorphism(sub, g, max_n=0, vertex_label=None, edge_label=None,
     of vertices of the two graphs. Time complexity is :math:`O(V^2)` in the best
     case and :math:`O(V!\times V)` in the worst case [boost-subgraph-iso]_.
 
+    If ``parallel == True``, an approach similar to VF3
+    [carletti-challenging-2018]_ and the Glasgow subgraph solver
+    [mccreesh-glasgow-2020]_ is used instead. Each vertex of `sub` is given a
+    domain of candidate vertices in `g`, stored as a bitset, with matching
+    labels and sufficient in- and out-degrees, which is further pruned by
+    requiring that every candidate has neighbors in the domains of the
+    corresponding neighbors in `sub`. The vertices of `sub` are then matched in
+    a fixed order, where each one is connected to as many of the previous ones
+    as possible, and its candidates are obtained from the neighborhoods of the
+    vertices already matched, so that only a small part of `g` is visited for
+    each partial match. The search is split according to the match of the
+    first vertex, and the parts are distributed dynamically among the
+    threads. The matches are grouped by the vertex of `g` matched to this first
+    vertex, in increasing order of index, so that the result does not depend
+    on the number of threads, unless ``max_n > 0``. The memory requirement
+    does not depend on the number of matches if ``count == True`` or
+    ``generator == True``.
+
     Examples
     --------
     >>> from numpy.random import poisson
@@ -713,6 +872,15 @@ def subgraph_isomorphism(sub, g, max_n=0, vertex_label=None, edge_label=None,
 
     **Left:** Subgraph searched, **Right:** One isomorphic subgraph found in main graph.
 
+    The number of matches can be obtained without storing them:
+
+    >>> sub = gt.complete_graph(3)
+    >>> gt.subgraph_isomorphism(sub, g, count=True)
+    24360
+    >>> vm = gt.subgraph_isomorphism(sub, g, flat=True)
+    >>> vm.shape
+    (24360, 3)
+
     References
     ----------
     .. [cordella-improved-2001] L. P. Cordella, P. Foggia, C. Sansone, and M. Vento,
@@ -724,6 +892,14 @@ def subgraph_isomorphism(sub, g, max_n=0, vertex_label=None, edge_label=None,
        IEEE Trans. Pattern Anal. Mach. Intell., vol. 26, no. 10, pp. 1367-1372, 2004.
        :doi:`10.1109/TPAMI.2004.75`
     .. [boost-subgraph-iso] http://www.boost.org/libs/graph/doc/vf2_sub_graph_iso.html
+    .. [carletti-challenging-2018] V. Carletti, P. Foggia, A. Saggese, and
+       M. Vento, "Challenging the Time Complexity of Exact Subgraph Isomorphism
+       for Huge and Dense Graphs with VF3", IEEE Trans. Pattern Anal. Mach.
+       Intell., vol. 40, no. 4, pp. 804-818, 2018. :doi:`10.1109/TPAMI.2017.2696940`
+    .. [mccreesh-glasgow-2020] C. McCreesh, P. Prosser, and J. Trimble, "The
+       Glasgow Subgraph Solver: Using Constraint Programming to Tackle Hard
+       Subgraph Isomorphism Problem Variants", Graph Transformation (ICGT),
+       pp. 316-324, 2020. :doi:`10.1007/978-3-030-51372-6_19`
     .. [subgraph-isormophism-wikipedia] http://en.wikipedia.org/wiki/Subgraph_isomorphism_problem
 
     """
@@ -743,6 +919,36 @@ def subgraph_isomorphism(sub, g, max_n=0, vertex_label=None, edge_label=None,
     elif edge_label[0].value_type() != "int64_t":
         edge_label = perfect_prop_hash(edge_label, htype="int64_t")
 
+    if count or flat or parallel:
+        ret = libgraph_tool_topology.\
+              subgraph_match(sub._Graph__graph, g._Graph__graph,
+                             _prop("v", sub, vertex_label[0]),
+                             _prop("v", g, vertex_label[1]),
+                             _prop("e", sub, edge_label[0]),
+                             _prop("e", g, edge_label[1]),
+                             max_n, induced, not subgraph, count,
+                             generator and not (count or flat))
+        if ret is None:  # directedness mismatch
+            if count:
+                return 0
+            ret = (0, numpy.zeros(0, dtype="uint64"))
+            generator = False
+        if count:
+            return ret
+
+        def get_vmap(m):
+            vmap = sub.new_vp("int64_t")
+            vmap.fa = m
+            return vmap
+
+        if generator and not flat:
+            return (get_vmap(m) for m in ret)
+        N, ms = ret
+        ms = ms.reshape((N, sub.num_vertices()))
+        if flat:
+            return ms
+        return [get_vmap(m) for m in ms]
+
     vmaps = libgraph_tool_topology.\
             subgraph_isomorphism(sub._Graph__graph, g._Graph__graph,
                                  _prop("v", sub, vertex_label[0]),
@@ -788,18 +994,31 @@ def mark_subgraph(g, sub, vmap, vmask=None, emask=None):
 
     return vmask, emask
 
-def max_cliques(g):
+def max_cliques(g, parallel=False, flat=False, count=False):
     """Return an iterator over the maximal cliques of the graph.
 
     Parameters
     ----------
     g : :class:`~graph_tool.Graph`
         Graph to be used.
+    parallel : ``bool`` (optional, default: ``False``)
+        If ``True``, the cliques are enumerated in parallel, with the algorithm
+        described below.
+    flat : ``bool`` (optional, default: ``False``)
+        If ``True``, all cliques are returned at once in flat arrays (see
+        below), instead of an iterator. This implies ``parallel == True``.
+    count : ``bool`` (optional, default: ``False``)
+        If ``True``, only the number of maximal cliques is returned, without
+        storing them. This implies ``parallel == True``.
 
     Returns
     -------
     max_cliques : iterator over :class:`numpy.ndarray` instances
         Iterator over lists of vertices corresponding to the maximal cliques.
+        If ``flat == True``, a pair ``(vertices, offsets)`` of
+        :class:`numpy.ndarray` instances is returned instead, such that the
+        vertices of clique ``i`` are ``vertices[offsets[i]:offsets[i+1]]``. If
+        ``count == True``, an integer is returned.
 
     Notes
     -----
@@ -812,12 +1031,30 @@ def max_cliques(g):
     graph of :math:`V` vertices, but for sparse graphs it is typically much
     faster.
 
+    If ``parallel == True``, the vertices are put in degeneracy order, and the
+    cliques are partitioned according to their earliest vertex, following
+    [eppstein_listing_2010]_. This gives one independent subproblem per
+    vertex, with at most :math:`d` candidates, where :math:`d` is the
+    degeneracy of the graph, and a worst case complexity of :math:`O(dV
+    3^{d/3})`. The subproblems are distributed dynamically among the threads,
+    and solved with bitset operations if they are small enough. In this case
+    the cliques are grouped by the index of their earliest vertex, and the
+    vertices of each clique are sorted, so that the order does not depend on
+    the number of threads.
+
+    If enabled during compilation, the ``parallel`` algorithm runs in parallel.
+
     Examples
     --------
 
     >>> g = gt.collection.data["polblogs"]
     >>> sum(1 for c in gt.max_cliques(g))
     49618
+    >>> gt.max_cliques(g, count=True)
+    49618
+    >>> vs, offsets = gt.max_cliques(g, flat=True)
+    >>> len(offsets) - 1
+    49618
 
     References
     ----------
@@ -832,16 +1069,30 @@ def max_cliques(g):
        problem of reporting maximal cliques." Theoretical Computer Science 407.1-3
        564-568 (2008), :doi:`10.1016/j.tcs.2008.05.010`
     .. [bron-kerbosh-wiki] https://en.wikipedia.org/wiki/Bron%E2%80%93Kerbosch_algorithm
+    .. [eppstein_listing_2010] David Eppstein, Maarten Löffler, and Darren
+       Strash, "Listing All Maximal Cliques in Sparse Graphs in Near-Optimal
+       Time", Algorithms and Computation (ISAAC), 403-414 (2010),
+       :doi:`10.1007/978-3-642-17517-6_36`, :arxiv:`1006.5440`
 
     """
 
     if g.is_directed():
         g = GraphView(g, directed=False)
 
-    for c in libgraph_tool_topology.max_cliques(g._Graph__graph):
-        yield c
+    if count:
+        return libgraph_tool_topology.max_cliques_flat(g._Graph__graph, True)
+
+    if flat or parallel:
+        N, vs, offsets = \
+            libgraph_tool_topology.max_cliques_flat(g._Graph__graph, False)
+        if flat:
+            return vs, offsets
+        return (vs[offsets[i]:offsets[i+1]] for i in range(N))
 
-def min_spanning_tree(g, weights=None, root=None, tree_map=None):
+    return (c for c in libgraph_tool_topology.max_cliques(g._Graph__graph))
+
+def min_spanning_tree(g, weights=None, root=None, tree_map=None,
+                      parallel=False):
     r"""
     Return the minimum spanning tree of a given graph.
 
@@ -857,6 +1108,9 @@ def min_spanning_tree(g, weights=None, root=None, tree_map=None):
         is used. Otherwise, Kruskal's algorithm is used.
     tree_map : :class:`~graph_tool.EdgePropertyMap` (optional, default: `None`)
         If provided, the edge tree map will be written in this property map.
+    parallel : bool (optional, default: ``False``)
+        If ``True``, Borůvka's algorithm is used, which runs in parallel. In
+        this case the parameter ``root`` is ignored.
 
     Returns
     -------
@@ -869,6 +1123,18 @@ def min_spanning_tree(g, weights=None, root=None, tree_map=None):
     The algorithm runs with :math:`O(E\log E)` complexity, or :math:`O(E\log V)`
     if `root` is specified.
 
+    If ``parallel == True``, Borůvka's algorithm [boruvka-minimal-1926]_
+    [nesetril-boruvka-2001]_ is used instead: at each round, every component
+    selects its lightest outgoing edge, and all the selected edges are
+    contracted at once with a concurrent union-find structure. Since the number
+    of components is at least halved at each round, the algorithm runs with
+    :math:`O(E\log V)` complexity, and the edges are processed in parallel
+    within each round. Ties between equal weights are broken by the edge
+    index, so that the resulting forest does not depend on the number of
+    threads.
+
+    If enabled during compilation, the ``parallel`` algorithm runs in parallel.
+
     Examples
     --------
     .. testcode::
@@ -910,6 +1176,12 @@ def min_spanning_tree(g, weights=None, root=None, tree_map=None):
        :doi:`10.1090/S0002-9939-1956-0078686-7`
     .. [prim-shortest-1957] R. Prim.  "Shortest connection networks and some
        generalizations",  Bell System Technical Journal, 36:1389-1401, 1957.
+    .. [boruvka-minimal-1926] O. Borůvka. "O jistém problému minimálním",
+       Práce Moravské Přírodovědecké Společnosti, 3:37-58, 1926.
+    .. [nesetril-boruvka-2001] J. Nešetřil, E. Milková, H. Nešetřilová,
+       "Otakar Borůvka on minimum spanning tree problem: Translation of both the
+       1926 papers, comments, history", Discrete Mathematics 233(1-3):3-36, 2001.
+       :doi:`10.1016/S0012-365X(00)00224-7`
     .. [boost-mst] http://www.boost.org/libs/graph/doc/graph_theory_review.html#sec:minimum-spanning-tree
     .. [mst-wiki] http://en.wikipedia.org/wiki/Minimum_spanning_tree
     """
@@ -919,7 +1191,12 @@ def min_spanning_tree(g, weights=None, root=None, tree_map=None):
         raise ValueError("edge property 'tree_map' must be of value type bool.")
 
     u = GraphView(g, directed=False)
-    if root is None:
+    if parallel:
+        libgraph_tool_topology.\
+               get_parallel_spanning_tree(u._Graph__graph,
+                                          _prop("e", g, weights),
+                                          _prop("e", g, tree_map))
+    elif root is None:
         libgraph_tool_topology.\
                get_kruskal_spanning_tree(u._Graph__graph,
                                          _prop("e", g, weights),
@@ -1156,6 +1433,10 @@ def transitive_closure(g):
 
     The time complexity (worst-case) is :math:`O(VE)`.
 
+    If only reachability queries are needed, :class:`ReachabilityOracle`
+    answers them without materializing the :math:`O(V^2)` edges of the
+    transitive closure.
+
     Examples
     --------
     .. testcode::
@@ -1183,7 +1464,109 @@ def transitive_closure(g):
     return tg
 
 
-def label_components(g, vprop=None, directed=None, attractors=False):
+class ReachabilityOracle(object):
+    def __init__(self, g, k=3):
+        r"""Index which answers whether a vertex can be reached from another,
+        without materializing the transitive closure of the graph.
+
+        Parameters
+        ----------
+        g : :class:`~graph_tool.Graph`
+            Graph to be used.
+        k : ``int`` (optional, default: ``3``)
+            Number of interval labels stored for each strongly connected
+            component.
+
+        Notes
+        -----
+
+        The index corresponds to the state of the graph at the time of its
+        construction, and needs to be rebuilt if the graph is modified. If
+        the graph is undirected, the queries reduce to whether the vertices
+        belong to the same component.
+
+        The strongly connected components of the graph are contracted, and the
+        queries are answered on the resulting directed acyclic graph, following
+        GRAIL [yildirim-grail-2010]_. Each component is labeled with its
+        topological level, and with ``k`` intervals obtained from randomized
+        depth-first traversals, which contain the intervals of all components
+        reachable from it. Most negative queries are thus answered in
+        :math:`O(k)` time, and a pruned depth-first search is performed for the
+        remaining ones, which also stops as soon as a component is found that
+        contains the target in its depth-first subtree.
+
+        The index takes :math:`O(k(V + E))` time to build, and uses
+        :math:`O(V + kC + E_C)` memory, where :math:`C` and :math:`E_C` are the
+        number of components and of edges between them, as opposed to
+        :math:`O(V^2)` for :func:`~graph_tool.topology.transitive_closure`.
+
+        If enabled during compilation, the components, the levels and the
+        ``k`` traversals are computed in parallel, as are the queries given as
+        arrays.
+
+        Examples
+        --------
+        .. testcode::
+           :hide:
+
+           gt.seed_rng(42)
+
+        >>> g = gt.Graph()
+        >>> g.add_edge_list([(0, 1), (1, 2), (2, 0), (2, 3), (4, 3)])
+        >>> oracle = gt.ReachabilityOracle(g)
+        >>> print(oracle.is_reachable(0, 3), oracle.is_reachable(3, 0),
+        ...       oracle.is_reachable(4, 0))
+        True False False
+        >>> print(oracle.is_reachable([0, 1, 4], [2, 3, 3]))
+        [ True  True  True]
+        >>> print(oracle.num_components())
+        3
+
+        References
+        ----------
+        .. [yildirim-grail-2010] Hilmi Yildirim, Vineet Chaoji, and Mohammed
+           J. Zaki, "GRAIL: Scalable Reachability Index for Large Graphs",
+           Proceedings of the VLDB Endowment 3 (1-2): 276-284 (2010),
+           :doi:`10.14778/1920841.1920879`
+        """
+
+        self.g = g
+        self._N = g.num_vertices(ignore_filter=True)
+        self._state = libgraph_tool_topology.ReachabilityIndex(g._Graph__graph,
+                                                               k, _get_rng())
+
+    def is_reachable(self, u, v):
+        """Return ``True`` if ``v`` can be reached from ``u``. A vertex is always
+        reachable from itself. If ``u`` and ``v`` are arrays, a Boolean array
+        is returned with the answers for every pair ``(u[i], v[i])``, after
+        both are flattened. A :class:`ValueError` is raised if any of the
+        vertex indices is invalid."""
+        scalar = numpy.ndim(u) == 0 and numpy.ndim(v) == 0
+        u = numpy.asarray(u, dtype="int64").ravel()
+        v = numpy.asarray(v, dtype="int64").ravel()
+        for x in [u, v]:
+            invalid = (x < 0) | (x >= self._N)
+            if invalid.any():
+                raise ValueError("Invalid vertex index: %d" %
+                                 x[invalid.argmax()])
+        if scalar:
+            return self._state.reachable(int(u[0]), int(v[0]))
+        u, v = numpy.broadcast_arrays(u, v)
+        u = numpy.ascontiguousarray(u)
+        v = numpy.ascontiguousarray(v)
+        return self._state.reachable_array(u, v).astype("bool")
+
+    def component(self, v):
+        """Return the label of the strongly connected component of ``v``."""
+        return self._state.component(int(v))
+
+    def num_components(self):
+        """Return the number of strongly connected components in the graph."""
+        return self._state.num_components()
+
+
+def label_components(g, vprop=None, directed=None, attractors=False,
+                     parallel=False):
     """
     Label the components to which each vertex in the graph belongs. If the
     graph is directed, it finds the strongly connected components.
@@ -1205,6 +1588,8 @@ def label_components(g, vprop=None, directed=None, attractors=False):
         If ``True``, and the graph is directed, an additional array with Boolean
         values is returned, specifying if the strongly connected components are
         attractors or not.
+    parallel : bool (optional, default: ``False``)
+        If ``True``, a parallel algorithm is used (see notes below).
 
     Returns
     -------
@@ -1224,6 +1609,16 @@ def label_components(g, vprop=None, directed=None, attractors=False):
 
     The algorithm runs in :math:`O(V + E)` time.
 
+    If ``parallel == True``, the connected components of undirected graphs are
+    obtained with the Afforest algorithm [sutton-afforest]_, which is based on
+    a concurrent union-find structure, and the resulting labels are identical
+    to the sequential ones. For directed graphs, the strongly connected
+    components are obtained with a combination of trimming, a forward-backward
+    search [hong-scc]_ and the coloring algorithm [orzan-scc]_. The components
+    are the same as in the sequential case, but they are labeled in the order
+    of their smallest vertex index. Both algorithms perform :math:`O(V + E)`
+    work for typical graphs, and run in parallel if enabled during compilation.
+
     Examples
     --------
     .. testcode::
@@ -1247,6 +1642,17 @@ def label_components(g, vprop=None, directed=None, attractors=False):
     [ True False  True  True False  True  True False  True False  True  True
       True  True False False  True False False False False False False False
       True False False False False False  True False False False]
+
+    References
+    ----------
+    .. [sutton-afforest] M. Sutton, T. Ben-Nun, A. Barak, "Optimizing Parallel
+       Graph Connectivity Computation via Subgraph Sampling", IEEE IPDPS,
+       12-21 (2018), :doi:`10.1109/IPDPS.2018.00012`
+    .. [hong-scc] S. Hong, N. C. Rodia, K. Olukotun, "On fast parallel
+       detection of strongly connected components (SCC) in small-world graphs",
+       SC '13, 1-11 (2013), :doi:`10.1145/2503210.2503246`
+    .. [orzan-scc] S. M. Orzan, "On distributed verification and verified
+       distribution", PhD thesis, Vrije Universiteit Amsterdam (2004).
     """
 
     if vprop is None:
@@ -1259,7 +1665,8 @@ def label_components(g, vprop=None, directed=None, attractors=False):
         g = GraphView(g, directed=directed)
 
     hist = libgraph_tool_topology.\
-               label_components(g._Graph__graph, _prop("v", g, vprop))
+               label_components(g._Graph__graph, _prop("v", g, vprop),
+                                parallel)
 
     if attractors and g.is_directed() and directed != False:
         is_attractor = numpy.ones(len(hist), dtype="bool")
@@ -1271,7 +1678,7 @@ def label_components(g, vprop=None, directed=None, attractors=False):
         return vprop, hist
 
 
-def label_largest_component(g, directed=None):
+def label_largest_component(g, directed=None, parallel=False):
     """
     Label the largest component in the graph. If the graph is directed, then the
     largest strongly connected component is labelled.
@@ -1285,6 +1692,9 @@ def label_largest_component(g, directed=None):
     directed : bool (optional, default: ``None``)
         Treat graph as directed or not, independently of its actual
         directionality.
+    parallel : bool (optional, default: ``False``)
+        If ``True``, the components are obtained with a parallel algorithm (see
+        :func:`~graph_tool.topology.label_components`).
 
     Returns
     -------
@@ -1316,11 +1726,11 @@ def label_largest_component(g, directed=None):
     """
 
     label = g.new_vertex_property("bool")
-    c, h = label_components(g, directed=directed)
+    c, h = label_components(g, directed=directed, parallel=parallel)
     label.fa = c.fa == h.argmax()
     return label
 
-def extract_largest_component(g, directed=None, prune=False):
+def extract_largest_component(g, directed=None, prune=False, parallel=False):
     """Extract the largest (strong) component in the graph as a
     :class:`~graph_tool.GraphView` (or :class:`~graph_tool.Graph` if
     ``prune==True``).
@@ -1338,6 +1748,9 @@ def extract_largest_component(g, directed=None, prune=False):
     prune : bool (optional, default: ``False``)
         If ``True``, a pruned copy of the component is returned. Otherwise a
         :class:`~graph_tool.GraphView` is returned.
+    parallel : bool (optional, default: ``False``)
+        If ``True``, the components are obtained with a parallel algorithm (see
+        :func:`~graph_tool.topology.label_components`).
 
     Returns
     -------
@@ -1364,7 +1777,7 @@ def extract_largest_component(g, directed=None, prune=False):
 
     """
 
-    c = label_largest_component(g, directed=directed)
+    c = label_largest_component(g, directed=directed, parallel=parallel)
     u = GraphView(g, vfilt=c)
     if prune:
         u = Graph(u, prune=True)
@@ -1432,7 +1845,7 @@ def label_out_component(g, root, label=None):
     return label
 
 
-def label_biconnected_components(g, eprop=None, vprop=None):
+def label_biconnected_components(g, eprop=None, vprop=None, parallel=False):
     """
     Label the edges of biconnected components, and the vertices which are
     articulation points.
@@ -1453,6 +1866,8 @@ def label_biconnected_components(g, eprop=None, vprop=None):
         Vertex property to mark the articulation points. If none is supplied,
         one is created.
 
+    parallel : bool (optional, default: ``False``)
+        If ``True``, a parallel algorithm is used (see notes below).
 
     Returns
     -------
@@ -1482,6 +1897,13 @@ def label_biconnected_components(g, eprop=None, vprop=None):
 
     The algorithm runs in :math:`O(V + E)` time.
 
+    If ``parallel == True``, the algorithm of Tarjan and Vishkin
+    [tarjan-vishkin]_ is used, which reduces the problem to finding the
+    connected components of an auxiliary graph defined on a spanning tree. The
+    components are the same as in the sequential case, but they are labeled in
+    the order of their smallest edge index. This algorithm runs in parallel if
+    enabled during compilation.
+
     Examples
     --------
     .. testcode::
@@ -1507,6 +1929,12 @@ def label_biconnected_components(g, eprop=None, vprop=None):
     [ 1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1
       1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1  1 51  1  1
       1  1  1]
+
+    References
+    ----------
+    .. [tarjan-vishkin] R. E. Tarjan, U. Vishkin, "An Efficient Parallel
+       Biconnectivity Algorithm", SIAM J. Comput. 14, 862-874 (1985),
+       :doi:`10.1137/0214061`
     """
 
     if vprop is None:
@@ -1522,9 +1950,140 @@ def label_biconnected_components(g, eprop=None, vprop=None):
     g = GraphView(g, directed=False)
     hist = libgraph_tool_topology.\
              label_biconnected_components(g._Graph__graph, _prop("e", g, eprop),
-                                          _prop("v", g, vprop))
+                                          _prop("v", g, vprop), parallel)
     return eprop, vprop, hist
 
+
+class ConnectivityOracle(object):
+    def __init__(self, g, deletions=True):
+        r"""Connectivity oracle which is kept up to date as edges are added to and
+        removed from a graph.
+
+        Parameters
+        ----------
+        g : :class:`~graph_tool.Graph`
+            Graph to be used. Filtered graphs are not supported.
+        deletions : ``bool`` (optional, default: ``True``)
+            If ``False``, only edge insertions will be supported, and the
+            oracle is reduced to a union-find structure.
+
+        Notes
+        -----
+
+        The graph should only be modified via the methods
+        :meth:`~ConnectivityOracle.add_edge` and
+        :meth:`~ConnectivityOracle.remove_edge` of this class, which update the
+        graph and the oracle together. If the graph is modified otherwise,
+        :meth:`~ConnectivityOracle.rebuild` needs to be called before the next
+        query. Vertices added to the graph are regarded as isolated until they
+        receive edges via the oracle, but vertex removals always require a
+        rebuild.
+
+        Components are weakly connected, i.e. the edge directions are always
+        ignored.
+
+        Every vertex points to a node in a union-find structure
+        [tarjan-union-find]_, whose roots store the component sizes, such that
+        the queries :meth:`~ConnectivityOracle.is_connected` and
+        :meth:`~ConnectivityOracle.component_size` run in amortized
+        :math:`O(\alpha(V))` time, where :math:`\alpha` is the inverse
+        Ackermann function. Edge insertions take the same time.
+
+        If ``deletions == True``, a spanning forest is also maintained. The
+        removal of a non-tree edge takes :math:`O(1)` time. If a tree edge is
+        removed, both halves of the split tree are traversed in an interleaved
+        fashion until the smallest one is exhausted, and then its edges are
+        scanned for a replacement. Hence the removal runs in time proportional
+        to the number of edges incident on the smallest half, which is typically
+        small, although it can be :math:`O(E)` in the worst case. This is a
+        simplification of the algorithm of Holm, de Lichtenberg and Thorup
+        [holm-poly-logarithmic-2001]_, without its poly-logarithmic amortized
+        guarantee, but with much smaller overhead.
+
+        Constructing the oracle, or rebuilding it, takes :math:`O(V\log V + E)`
+        time.
+
+        Examples
+        --------
+        >>> g = gt.lattice([10, 10])
+        >>> oracle = gt.ConnectivityOracle(g)
+        >>> for v in range(10):
+        ...     oracle.remove_edge(g.edge(v + 40, v + 50))
+        >>> print(oracle.is_connected(0, 99), oracle.component_size(0),
+        ...       oracle.num_components())
+        False 50 2
+        >>> e = oracle.add_edge(45, 55)
+        >>> print(oracle.is_connected(0, 99), oracle.component_size(0),
+        ...       oracle.num_components())
+        True 100 1
+
+        References
+        ----------
+        .. [tarjan-union-find] Robert E. Tarjan, "Efficiency of a Good But Not
+           Linear Set Union Algorithm", Journal of the ACM 22 (2): 215-225
+           (1975), :doi:`10.1145/321879.321884`
+        .. [holm-poly-logarithmic-2001] Jacob Holm, Kristian de Lichtenberg,
+           and Mikkel Thorup, "Poly-logarithmic deterministic fully-dynamic
+           algorithms for connectivity, minimum spanning tree, 2-edge, and
+           biconnectivity", Journal of the ACM 48 (4): 723-760 (2001),
+           :doi:`10.1145/502090.502095`
+        """
+
+        if (g.get_vertex_filter()[0] is not None or
+            g.get_edge_filter()[0] is not None):
+            raise ValueError("filtered graphs are not supported")
+        self.g = g
+        self.deletions = deletions
+        self._state = libgraph_tool_topology.DynamicConnectivity(g._Graph__graph,
+                                                                 deletions)
+
+    def rebuild(self):
+        """Rebuild the oracle from scratch. This needs to be called if the graph
+        has been modified without going through the oracle."""
+        self._state.rebuild()
+
+    def add_edge(self, u, v):
+        """Add a new edge from ``u`` to ``v`` to the graph, and return it."""
+        e = self.g.add_edge(u, v)
+        self._state.insert(int(u), int(v), int(self.g.edge_index[e]))
+        return e
+
+    def add_edge_list(self, edge_list):
+        """Add the edges in ``edge_list``, given as pairs of vertices, to the
+        graph. For a large number of edges it can be faster to add them directly
+        to the graph with :meth:`~graph_tool.Graph.add_edge_list`, and call
+        :meth:`~ConnectivityOracle.rebuild` afterwards."""
+        for u, v in edge_list:
+            self.add_edge(u, v)
+
+    def remove_edge(self, e):
+        """Remove the edge ``e`` from the graph. This is only supported if the
+        oracle was created with ``deletions == True``."""
+        if not self.deletions:
+            raise ValueError("edge deletions are not enabled")
+        u, v = int(e.source()), int(e.target())
+        idx = int(self.g.edge_index[e])
+        self.g.remove_edge(e)
+        self._state.remove(u, v, idx)
+
+    def is_connected(self, u, v):
+        """Return ``True`` if vertices ``u`` and ``v`` belong to the same
+        component."""
+        return self._state.connected(int(u), int(v))
+
+    def component_size(self, v):
+        """Return the number of vertices in the component of ``v``."""
+        return self._state.component_size(int(v))
+
+    def component(self, v):
+        """Return an integer label for the component of ``v``. The labels are only
+        valid until the next modification of the graph."""
+        return self._state.component(int(v))
+
+    def num_components(self):
+        """Return the number of components in the graph."""
+        return self._state.num_components()
+
 def vertex_percolation(g, vertices, second=False):
     """Compute the size of the largest or second-largest component as vertices
     are (virtually) removed from the graph.
@@ -1696,8 +2255,76 @@ def edge_percolation(g, edges, second=False):
                        edges, max_size, second)
     return max_size, tree
 
-def kcore_decomposition(g, vprop=None):
-    """Perform a k-core decomposition of the given graph.
+def random_percolation(g, samples=100, edges=False):
+    """Compute the average size of the largest and second-largest components, and
+    the average component size, as vertices (or edges) are removed from the
+    graph in uniformly random order.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    samples : ``int`` (optional, default: ``100``)
+        Number of independent random orders.
+    edges : ``bool`` (optional, default: ``False``)
+        If ``True``, edges will be removed instead of vertices.
+
+    Returns
+    -------
+    size : :class:`numpy.ndarray`
+        Average size of the largest component prior to removal of the vertex
+        (or edge) at each position of the reversed order of removal, i.e. with
+        ``i + 1`` vertices (or edges) remaining.
+    second : :class:`numpy.ndarray`
+        Average size of the second-largest component, in the same order.
+    avg : :class:`numpy.ndarray`
+        Average size of the component to which a randomly chosen remaining
+        vertex belongs, excluding the largest component, in the same order.
+
+    Notes
+    -----
+
+    Each sample is computed as in :func:`vertex_percolation` and
+    :func:`edge_percolation`, by adding the vertices (or edges) in the
+    reversed order of removal with a union-find structure [newman-ziff]_,
+    which also keeps a histogram of the component sizes, and the sum of their
+    squares, so that all three quantities are updated in :math:`O(1)`
+    amortized time per merge. Hence each sample runs in :math:`O(V + E)`
+    time.
+
+    If enabled during compilation, the samples are distributed among threads,
+    each with its own union-find buffers. Every sample uses its own stream of
+    random numbers, so that the result does not depend on the number of
+    threads, up to rounding in the average component sizes.
+
+    Examples
+    --------
+    .. testcode::
+       :hide:
+
+       gt.seed_rng(42)
+
+    >>> g = gt.lattice([10, 10])
+    >>> size, second, avg = gt.random_percolation(g, samples=1000)
+    >>> print(size[-1], second[-1], avg[-1])
+    100.0 0.0 0.0
+    >>> print(size[0], second[0], avg[0])
+    1.0 0.0 0.0
+
+    References
+    ----------
+    .. [newman-ziff] M. E. J. Newman, R. M. Ziff, "A fast Monte Carlo algorithm
+       for site or bond percolation", Phys. Rev. E 64, 016706 (2001)
+       :doi:`10.1103/PhysRevE.64.016706`, :arxiv:`cond-mat/0101295`
+
+    """
+    u = GraphView(g, directed=False)
+    s1, s2, avg = libgraph_tool_topology.\
+        percolate_random(u._Graph__graph, samples, edges, _get_rng())
+    return s1 / samples, s2 / samples, avg / samples
+
+def kcore_decomposition(g, vprop=None, parallel=False):
+    r"""Perform a k-core decomposition of the given graph.
 
     Parameters
     ----------
@@ -1706,6 +2333,8 @@ def kcore_decomposition(g, vprop=None):
     vprop : :class:`~graph_tool.VertexPropertyMap` (optional, default: ``None``)
         Vertex property to store the decomposition. If ``None`` is supplied,
         one is created.
+    parallel : ``bool`` (optional, default: ``False``)
+        If ``True``, a parallel peeling algorithm is used (see below).
 
     Returns
     -------
@@ -1728,6 +2357,18 @@ def kcore_decomposition(g, vprop=None):
     This algorithm is described in [batagelj-algorithm]_ and runs in :math:`O(V + E)`
     time.
 
+    If ``parallel == True``, the PKC algorithm of [kabir-parallel-2017]_ is used
+    instead, where all vertices with the same core number are peeled
+    concurrently, using thread-local buffers. It runs in :math:`O(V k_{\max} +
+    E)` time, where :math:`k_{\max}` is the largest core number, but in
+    practice only the vertices not yet peeled are visited at each level. The
+    result is identical to the sequential algorithm.
+
+    If enabled during compilation, this algorithm runs in parallel.
+
+    To maintain the decomposition as the graph is modified, without
+    recomputing it, see :class:`~graph_tool.topology.DynamicKCore`.
+
     Examples
     --------
 
@@ -1751,6 +2392,10 @@ def kcore_decomposition(g, vprop=None):
        networks", Advances in Data Analysis and Classification
        Volume 5, Issue 2, pp 129-145 (2011), :DOI:`10.1007/s11634-010-0079-y`,
        :arxiv:`cs/0310049`
+    .. [kabir-parallel-2017] Humayun Kabir and Kamesh Madduri, "Parallel k-core
+       decomposition on multicore platforms", IEEE International Parallel and
+       Distributed Processing Symposium Workshops (IPDPSW), 1482-1491 (2017),
+       :doi:`10.1109/IPDPSW.2017.151`
 
     """
 
@@ -1761,11 +2406,99 @@ def kcore_decomposition(g, vprop=None):
     _check_prop_scalar(vprop, name="vprop")
 
     libgraph_tool_topology.\
-               kcore_decomposition(g._Graph__graph, _prop("v", g, vprop))
+               kcore_decomposition(g._Graph__graph, _prop("v", g, vprop),
+                                   parallel)
 
     return vprop
 
 
+class DynamicKCore(object):
+    def __init__(self, g):
+        r"""K-core decomposition which is kept up to date as edges are added to and
+        removed from a graph.
+
+        Parameters
+        ----------
+        g : :class:`~graph_tool.Graph`
+            Graph to be used. Filtered graphs are not supported.
+
+        Notes
+        -----
+
+        The core numbers are the same as those computed by
+        :func:`~graph_tool.topology.kcore_decomposition`, and are available via
+        :meth:`~DynamicKCore.get_kcore`.
+
+        The graph should only be modified via the methods
+        :meth:`~DynamicKCore.add_edge` and :meth:`~DynamicKCore.remove_edge` of
+        this class, which update the graph and the decomposition together. If
+        the graph is modified otherwise, :meth:`~DynamicKCore.rebuild` needs to
+        be called. Vertices added to the graph are regarded as isolated until
+        they receive edges via this class, but vertex removals always require a
+        rebuild.
+
+        This implements the subcore algorithm of [li-efficient-2014]_. After an
+        edge :math:`(u,v)` is inserted or removed, only the core numbers of the
+        vertices with core number :math:`K=\min(k_u, k_v)` that are connected to
+        the endpoints via such vertices can change, and only by one (or two, for
+        self-loops). The update runs in time proportional to the sum of the
+        degrees of these vertices, which is typically much smaller than
+        :math:`O(V + E)`.
+
+        Examples
+        --------
+
+        >>> g = gt.complete_graph(5)
+        >>> state = gt.DynamicKCore(g)
+        >>> print(state.get_kcore().a)
+        [4 4 4 4 4]
+        >>> state.remove_edge(g.edge(0, 1))
+        >>> print(state.get_kcore().a)
+        [3 3 3 3 3]
+        >>> e = state.add_edge(0, 1)
+        >>> print(state.get_kcore().a)
+        [4 4 4 4 4]
+
+        References
+        ----------
+        .. [li-efficient-2014] Rong-Hua Li, Jeffrey Xu Yu, and Rui Mao,
+           "Efficient Core Maintenance in Large Dynamic Graphs", IEEE
+           Transactions on Knowledge and Data Engineering 26 (10): 2453-2465
+           (2014), :doi:`10.1109/TKDE.2013.158`, :arxiv:`1207.4567`
+        """
+
+        if (g.get_vertex_filter()[0] is not None or
+            g.get_edge_filter()[0] is not None):
+            raise ValueError("filtered graphs are not supported")
+        self.g = g
+        self.kval = g.new_vertex_property("int32_t")
+        self._state = libgraph_tool_topology.DynamicKCore(g._Graph__graph,
+                                                          _prop("v", g,
+                                                                self.kval))
+
+    def get_kcore(self):
+        """Return the :class:`~graph_tool.VertexPropertyMap` with the current core
+        numbers. This is updated in place as the graph is modified."""
+        return self.kval
+
+    def rebuild(self):
+        """Recompute the decomposition from scratch. This needs to be called if the
+        graph has been modified without going through this class."""
+        self._state.rebuild()
+
+    def add_edge(self, u, v):
+        """Add a new edge from ``u`` to ``v`` to the graph, and return it."""
+        e = self.g.add_edge(u, v)
+        self._state.insert(int(u), int(v))
+        return e
+
+    def remove_edge(self, e):
+        """Remove the edge ``e`` from the graph."""
+        u, v = int(e.source()), int(e.target())
+        self.g.remove_edge(e)
+        self._state.remove(u, v)
+
+
 def shortest_distance(g, source=None, target=None, weights=None,
                       negative_weights=False, max_dist=None, directed=None,
                       dense=False, dist_map=None, pred_map=False,
@@ -2494,7 +3227,7 @@ def all_paths(g, source, target, cutoff=None, edges=False):
     for p in path_iterator:
         yield p
 
-def all_circuits(g, unique=False):
+def all_circuits(g, unique=False, max_length=None, flat=False, count=False):
     """Return an iterator over all the cycles in a directed graph.
 
     Parameters
@@ -2503,17 +3236,51 @@ def all_circuits(g, unique=False):
         A directed graph to be used.
     unique : ``bool`` (optional, default: None)
         If ``True``, parallel edges and self-loops will be ignored.
+    max_length : ``int`` (optional, default: ``None``)
+        If provided, only the circuits with at most this number of edges are
+        returned.
+    flat : ``bool`` (optional, default: ``False``)
+        If ``True``, all circuits are returned at once in a flat array,
+        together with their offsets (see below).
+    count : ``bool`` (optional, default: ``False``)
+        If ``True``, only the number of circuits of each length is returned,
+        without storing them.
 
     Returns
     -------
     cycle_iterator : iterator over a sequence of integers
-        Iterator over sequences of vertices that form a circuit.
+        Iterator over sequences of vertices that form a circuit. If ``flat ==
+        True``, a pair ``(circuits, offsets)`` of :class:`numpy.ndarray` is
+        returned instead, such that ``circuits[offsets[i]:offsets[i+1]]`` are
+        the vertices of the ``i``-th circuit. If ``count == True``, a
+        :class:`numpy.ndarray` is returned, such that its ``l``-th element is
+        the number of circuits with ``l`` edges.
 
     Notes
     -----
     This algorithm [hawick-enumerating-2008]_ runs in worst time
     :math:`O[(V + E)(C + 1)]`, where :math:`C` is the number of circuits.
 
+    If ``max_length``, ``flat`` or ``count`` are given, the circuits are
+    instead enumerated as in Johnson's algorithm [johnson-finding-1975]_, by
+    a depth-first search of simple paths from every vertex :math:`s` that
+    only visits vertices with a larger index than :math:`s`, so that every
+    circuit is found exactly once, starting from its vertex of smallest
+    index. Without ``max_length``, the search uses Johnson's blocking, with
+    the same worst-case time :math:`O[(V + E)(C + 1)]` as above. Otherwise,
+    the search is pruned by the distances back to :math:`s`, so that a path
+    is only extended if it can still be closed into a circuit with at most
+    ``max_length`` edges. This makes the enumeration of short circuits
+    feasible in large graphs, with a cost that depends only on the
+    neighborhoods of radius ``max_length`` around each vertex, but which can
+    grow with the number of simple paths, rather than circuits, inside
+    them. The circuits are returned grouped by their first vertex, in
+    increasing order, so that the result does not depend on the number of
+    threads.
+
+    If enabled during compilation, and ``flat == True`` or ``count == True``,
+    this algorithm runs in parallel.
+
     Examples
     --------
     .. testcode::
@@ -2526,6 +3293,11 @@ def all_circuits(g, unique=False):
     ...     print(c)
     [0 1 6 3 8 4 9]
     [2 5 7]
+    >>> print(gt.all_circuits(g, max_length=5, count=True))
+    [0 0 0 1 0 0]
+    >>> cs, idx = gt.all_circuits(g, flat=True)
+    >>> print(cs[idx[1]:idx[2]])
+    [2 5 7]
 
     References
     ----------
@@ -2534,14 +3306,25 @@ def all_circuits(g, unique=False):
        In Proceedings of FCS. 2008, 14-20,
        http://cssg.massey.ac.nz/cstn/013/cstn-013.html
     .. [hawick-bgl] http://www.boost.org/doc/libs/graph/doc/hawick_circuits.html
+    .. [johnson-finding-1975] D. B. Johnson, "Finding all the elementary
+       circuits of a directed graph", SIAM Journal on Computing 4(1):77-84,
+       1975. :doi:`10.1137/0204007`
 
     """
 
     if not g.is_directed():
         raise ValueError("The graph must be directed.")
-    circuits_iterator = libgraph_tool_topology.get_all_circuits(g._Graph__graph,
-                                                                unique)
-    return circuits_iterator
+    if max_length is None and not (flat or count):
+        circuits_iterator = \
+            libgraph_tool_topology.get_all_circuits(g._Graph__graph, unique)
+        return circuits_iterator
+    if max_length is None:
+        max_length = 0
+    elif max_length < 1:
+        raise ValueError("max_length must be positive.")
+    return libgraph_tool_topology.\
+        get_bounded_circuits(g._Graph__graph, max_length, unique, count,
+                             not (flat or count))
 
 
 def pseudo_diameter(g, source=None, weights=None):
@@ -2624,6 +3407,123 @@ def pseudo_diameter(g, source=None, weights=None):
     return dist, (g.vertex(source), g.vertex(target))
 
 
+def diameter(g, source=None, weights=None, radius=False, max_time=None,
+             history=False, verbose=False):
+    r"""
+    Compute the exact diameter (and optionally the radius) of the graph.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    source : :class:`~graph_tool.Vertex` (optional, default: `None`)
+        Vertex from which the search starts. Only the (strongly) connected
+        component to which it belongs is considered. If not supplied, the vertex
+        with the largest total degree is chosen.
+    weights : :class:`~graph_tool.EdgePropertyMap` (optional, default: `None`)
+        The edge weights. They must be non-negative.
+    radius : bool (optional, default: ``False``)
+        If ``True``, the radius is computed as well.
+    max_time : float (optional, default: ``None``)
+        If given, the algorithm stops after this many seconds, and the returned
+        bounds need not be tight.
+    history : bool (optional, default: ``False``)
+        If ``True``, the evolution of the bounds during the algorithm is also
+        returned.
+    verbose : bool (optional, default: ``False``)
+        If ``True``, the current bounds are printed after each round of
+        traversals.
+
+    Returns
+    -------
+    diam : tuple of two scalars
+        Lower and upper bounds for the diameter. They coincide if the algorithm
+        finished before ``max_time``.
+    radius : tuple of two scalars
+        Lower and upper bounds for the radius. This is only returned if
+        ``radius == True``.
+    history : :class:`numpy.ndarray`
+        Array of shape ``(n, 6)``, where each row contains the number of
+        traversals made, the elapsed time (in seconds), and the lower and upper
+        bounds for the diameter and radius, after each round of the
+        algorithm. This is only returned if ``history == True``.
+
+    Notes
+    -----
+
+    The diameter and radius are the largest and smallest eccentricities among
+    all vertices, where the eccentricity of a vertex is the largest distance
+    from it to any other vertex in the same component. Instead of computing all
+    the eccentricities, the bounding algorithm of Takes and Kosters
+    [takes-diameter]_ is used. A traversal from a vertex :math:`w` yields its
+    exact eccentricity :math:`e(w)`, and bounds the eccentricities of all the
+    other vertices via the triangle inequality,
+
+    .. math::
+
+        \max(d(v,w), e(w) - d(w,v)) \le e(v) \le d(v,w) + e(w).
+
+    Vertices for which the bounds can no longer change the result are
+    discarded, and the next traversals are chosen alternately among the
+    remaining vertices with the largest upper and the smallest lower bounds,
+    until the bounds for the diameter (and radius) coincide. For directed
+    graphs, a traversal in each direction is made.
+
+    The paths are computed with a breadth-first search (BFS) or Dijkstra's
+    algorithm [dijkstra]_, if weights are given.
+
+    In the worst case :math:`O(V)` traversals are needed, but for most empirical
+    networks only a handful of them suffice.
+
+    If enabled during compilation, several traversals are made in parallel.
+
+    Examples
+    --------
+
+    >>> g = gt.lattice([10, 10])
+    >>> diam, rad = gt.diameter(g, radius=True)
+    >>> print(diam, rad)
+    (18, 18) (10, 10)
+
+    References
+    ----------
+    .. [takes-diameter] F. W. Takes, W. A. Kosters, "Computing the eccentricity
+       distribution of large graphs", Algorithms 6, 100-118 (2013),
+       :doi:`10.3390/a6010100`
+    .. [dijkstra] E. Dijkstra, "A note on two problems in connexion with
+       graphs." Numerische Mathematik, 1:269-271, 1959.
+    """
+
+    if g.num_vertices() == 0:
+        ret = [(0, 0)]
+        if radius:
+            ret.append((0, 0))
+        if history:
+            ret.append(numpy.zeros((0, 6)))
+        return ret[0] if len(ret) == 1 else tuple(ret)
+
+    if source is None:
+        vs = g.get_vertices()
+        source = vs[g.get_total_degrees(vs).argmax()]
+
+    if weights is not None and weights.fa.size > 0 and weights.fa.min() < 0:
+        raise ValueError("edge weights must be non-negative")
+
+    if max_time is None:
+        max_time = -1
+
+    dlow, dup, rlow, rup, hist = \
+        libgraph_tool_topology.get_bounding_diam(g._Graph__graph, int(source),
+                                                 _prop("e", g, weights),
+                                                 radius, max_time, verbose)
+    ret = [(dlow, dup)]
+    if radius:
+        ret.append((rlow, rup))
+    if history:
+        ret.append(hist)
+    return ret[0] if len(ret) == 1 else tuple(ret)
+
+
 def is_bipartite(g, partition=False, find_odd_cycle=False):
     """Test if the graph is bipartite.
 
@@ -3054,7 +3954,7 @@ def max_independent_vertex_set(g, high_deg=False, mivs=None):
         Graph to be used.
     high_deg : bool (optional, default: `False`)
         If `True`, vertices with high degree will be included first in the set,
-        otherwise they will be included last.
+        otherwise vertices with low degree will be included first.
     mivs : :class:`~graph_tool.VertexPropertyMap` (optional, default: `None`)
         Vertex property map where the vertex set will be specified.
 
@@ -3069,8 +3969,18 @@ def max_independent_vertex_set(g, high_deg=False, mivs=None):
     other vertex to the set forces the set to contain an edge between two
     vertices of the set.
 
-    This implements the algorithm described in [mivs-luby]_, which runs in time
-    :math:`O(V + E)`.
+    This implements the deterministic parallel greedy algorithm of
+    [blelloch-greedy-2012]_, a variant of [mivs-luby]_. The vertices are
+    ordered by degree, with ties broken randomly, and the result is the same
+    set obtained by visiting them sequentially in this order, and including
+    every vertex not adjacent to one already included. The set is built in
+    rounds, where every vertex whose neighbors that come before it in the
+    order have all been excluded is included, and every vertex adjacent to an
+    included one is excluded. The result does not depend on the number of
+    threads, and the algorithm runs in time :math:`O(V + E)` per round, with a
+    number of rounds that is typically small.
+
+    If enabled during compilation, this algorithm runs in parallel.
 
     Examples
     --------
@@ -3101,6 +4011,11 @@ def max_independent_vertex_set(g, high_deg=False, mivs=None):
     .. [mivs-luby] Luby, M., "A simple parallel algorithm for the maximal independent set problem",
        Proc. 17th Symposium on Theory of Computing, Association for Computing Machinery, pp. 1-10, (1985)
        :doi:`10.1145/22145.22146`.
+    .. [blelloch-greedy-2012] Guy E. Blelloch, Jeremy T. Fineman, and Julian
+       Shun, "Greedy sequential maximal independent set and matching are
+       parallel on average", Proceedings of the 24th ACM Symposium on
+       Parallelism in Algorithms and Architectures (SPAA), pp. 308-317 (2012),
+       :doi:`10.1145/2312005.2312058`, :arxiv:`1202.3205`
 
     """
     if mivs is None:
@@ -3172,7 +4087,8 @@ def edge_reciprocity(g):
     return r
 
 
-def tsp_tour(g, src, weight=None):
+def tsp_tour(g, src, weight=None, improve=False, nn=10, niter=1000,
+             restarts=1, max_time=None):
     r"""Return a traveling salesman tour of the graph, which is guaranteed to be
     twice as long as the optimal tour in the worst case.
 
@@ -3184,6 +4100,22 @@ def tsp_tour(g, src, weight=None):
         The source (and target) of the tour.
     weight : :class:`~graph_tool.EdgePropertyMap` (optional, default: None)
         Edge weights.
+    improve : ``bool`` (optional, default: ``False``)
+        If ``True``, the tour is further improved with a local search (see
+        below).
+    nn : ``int`` (optional, default: ``10``)
+        Number of lightest edges of each vertex considered by the local
+        search. It must be positive if ``improve == True``.
+    niter : ``int`` (optional, default: ``1000``)
+        Number of perturbations of the tour made by each restart of the local
+        search. If ``niter == 0``, the perturbations are only stopped by
+        ``max_time``, and if this is not given either, the tour is only
+        improved by the local search, without any perturbations.
+    restarts : ``int`` (optional, default: ``1``)
+        Number of independent restarts of the local search.
+    max_time : ``float`` (optional, default: ``None``)
+        If provided, the local search is stopped after this number of
+        seconds.
 
     Returns
     -------
@@ -3194,8 +4126,35 @@ def tsp_tour(g, src, weight=None):
     -----
     The algorithm runs with :math:`O(E\log V)` complexity.
 
+    If ``improve == True``, the tour is used as the starting point of a local
+    search with 2-opt [croes-method-1958]_ and Or-opt [or-traveling-1976]_
+    moves, which replace two edges of the tour, or move a segment of up to
+    three vertices to another part of the tour, respectively. Only the moves
+    that introduce one of the ``nn`` lightest edges of a vertex are
+    attempted, and only in the vicinity of the vertices that were changed
+    by previous moves, using "don't look bits" [bentley-fast-1992]_, so that
+    each pass of the local search runs in a time that is close to linear in
+    the number of vertices. The tour is then iteratively perturbed by
+    swapping two short consecutive segments, followed again by the local
+    search, and the perturbation is kept if the tour does not become longer
+    [johnson-traveling-1997]_. This is done ``niter`` times, for each of the
+    ``restarts`` independent runs, and the shortest tour is returned. Pairs
+    of consecutive vertices in the tour which are not adjacent in the graph
+    are given a prohibitive weight, and are avoided whenever possible.
+
+    If enabled during compilation, the restarts run in parallel, and the
+    result does not depend on the number of threads, unless ``max_time`` is
+    given.
+
     Examples
     --------
+    .. testcode::
+       :hide:
+
+       import numpy.random
+       numpy.random.seed(42)
+       gt.seed_rng(42)
+
     >>> g = gt.lattice([10, 10])
     >>> tour = gt.tsp_tour(g, g.vertex(0))
     >>> print(tour)
@@ -3205,31 +4164,68 @@ def tsp_tour(g, src, weight=None):
      57 58 67 68 77 78 87 88 97 98 99 26 36 46 56 66 76 86 96 10 20 30 40 50
      60 70 80 90  0]
 
+    >>> from numpy.random import random
+    >>> points = random((100, 2))
+    >>> g = gt.complete_graph(100)
+    >>> w = g.new_edge_property("double")
+    >>> for e in g.edges():
+    ...     w[e] = linalg.norm(points[int(e.source())] - points[int(e.target())])
+    >>> def length(t):
+    ...     return sum(linalg.norm(points[t[i]] - points[t[i + 1]])
+    ...                for i in range(len(t) - 1))
+    >>> tour = gt.tsp_tour(g, g.vertex(0), w)
+    >>> itour = gt.tsp_tour(g, g.vertex(0), w, improve=True)
+    >>> print(length(itour) < length(tour))
+    True
+
     References
     ----------
     .. [tsp-bgl] http://www.boost.org/libs/graph/doc/metric_tsp_approx.html
     .. [tsp] http://en.wikipedia.org/wiki/Travelling_salesman_problem
+    .. [croes-method-1958] G. A. Croes, "A method for solving
+       traveling-salesman problems", Operations Research 6(6):791-812, 1958.
+       :doi:`10.1287/opre.6.6.791`
+    .. [or-traveling-1976] I. Or, "Traveling salesman-type combinatorial
+       problems and their relation to the logistics of regional blood banking",
+       PhD thesis, Northwestern University, 1976.
+    .. [bentley-fast-1992] J. J. Bentley, "Fast algorithms for geometric
+       traveling salesman problems", ORSA Journal on Computing 4(4):387-411,
+       1992. :doi:`10.1287/ijoc.4.4.387`
+    .. [johnson-traveling-1997] D. S. Johnson and L. A. McGeoch, "The
+       traveling salesman problem: a case study in local optimization", in
+       Local Search in Combinatorial Optimization, pages 215-310, Wiley, 1997.
 
     """
 
     if g.is_directed():
         raise ValueError("The graph must be undirected.")
+    if improve and nn < 1:
+        raise ValueError("nn must be positive if improve == True.")
+    if max_time is None:
+        max_time = 0
     tour = libgraph_tool_topology.\
-        get_tsp(g._Graph__graph, int(src), _prop("e", g, weight))
+        get_tsp(g._Graph__graph, int(src), _prop("e", g, weight),
+                nn if improve else 0, niter, restarts, max_time, _get_rng())
     return tour.a.copy()
 
 
-def sequential_vertex_coloring(g, order=None, color=None):
+def sequential_vertex_coloring(g, order=None, color=None, parallel=False):
     """Returns a vertex coloring of the graph.
 
     Parameters
     ----------
     g : :class:`~graph_tool.Graph`
         Graph to be used.
-    order : :class:`~graph_tool.VertexPropertyMap` (optional, default: None)
-        Order with which the vertices will be colored.
+    order : :class:`~graph_tool.VertexPropertyMap` or ``str`` (optional, default: None)
+        Order with which the vertices will be colored, such that ``order[i]``
+        is the ``i``-th vertex to be colored. It can also be one of
+        ``"ldf"`` (largest degree first) or ``"sl"`` (smallest last). If not
+        given, the vertices are colored in order of their indices.
     color : :class:`~graph_tool.VertexPropertyMap` (optional, default: None)
         Integer-valued vertex property map to store the colors.
+    parallel : bool (optional, default: ``False``)
+        If ``True``, the coloring is obtained with the Jones-Plassmann
+        algorithm (see below), which runs in parallel.
 
     Returns
     -------
@@ -3242,6 +4238,22 @@ def sequential_vertex_coloring(g, order=None, color=None):
     vertices, :math:`d` is the maximum degree of the vertices in the graph, and
     :math:`k` is the number of colors used.
 
+    The ``"ldf"`` order puts the vertices in decreasing order of degree, and
+    the ``"sl"`` order is the reverse of the order in which the vertices are
+    removed, if the vertex of smallest degree is repeatedly removed from the
+    graph [matula-smallest-1983]_. The latter guarantees that at most
+    :math:`d+1` colors are used, where :math:`d` is the degeneracy of the
+    graph. Both are computed in time :math:`O(V + E)`.
+
+    If ``parallel == True``, a vertex is colored with the smallest color not
+    used by its neighbors that come before it in the order, as soon as all of
+    them are colored, following [jones-parallel-1993]_. This yields the same
+    coloring as the sequential algorithm, but all vertices that are ready are
+    colored in parallel, in rounds, whose number is the length of the longest
+    chain of adjacent vertices in increasing order. This is typically small
+    for the ``"ldf"`` and ``"sl"`` orders [hasenplaugh-ordering-2014]_. In this
+    case, edge directions are ignored.
+
     Examples
     --------
     >>> g = gt.lattice([10, 10])
@@ -3250,23 +4262,54 @@ def sequential_vertex_coloring(g, order=None, color=None):
     [0 1 0 1 0 1 0 1 0 1 1 0 1 0 1 0 1 0 1 0 0 1 0 1 0 1 0 1 0 1 1 0 1 0 1 0 1
      0 1 0 0 1 0 1 0 1 0 1 0 1 1 0 1 0 1 0 1 0 1 0 0 1 0 1 0 1 0 1 0 1 1 0 1 0
      1 0 1 0 1 0 0 1 0 1 0 1 0 1 0 1 1 0 1 0 1 0 1 0 1 0]
+    >>> g = gt.collection.data["polblogs"]
+    >>> colors = gt.sequential_vertex_coloring(g, order="sl", parallel=True)
+    >>> print(colors.a.max() + 1)
+    23
 
     References
     ----------
     .. [sgc-bgl] http://www.boost.org/libs/graph/doc/sequential_vertex_coloring.html
     .. [graph-coloring] http://en.wikipedia.org/wiki/Graph_coloring
+    .. [matula-smallest-1983] David W. Matula and Leland L. Beck,
+       "Smallest-last ordering and clustering and graph coloring algorithms",
+       J. ACM 30, 3, 417-427 (1983), :doi:`10.1145/2402.322385`
+    .. [jones-parallel-1993] Mark T. Jones and Paul E. Plassmann, "A parallel
+       graph coloring heuristic", SIAM J. Sci. Comput. 14, 3, 654-669 (1993),
+       :doi:`10.1137/0914041`
+    .. [hasenplaugh-ordering-2014] William Hasenplaugh, Tim Kaler, Tao B.
+       Schardl, and Charles E. Leiserson, "Ordering heuristics for parallel
+       graph coloring", Proceedings of the 26th ACM Symposium on Parallelism in
+       Algorithms and Architectures (SPAA), pp. 166-177 (2014),
+       :doi:`10.1145/2612669.2612697`
 
     """
 
     if order is None:
         order = g.vertex_index
+    elif isinstance(order, str):
+        kinds = {"ldf": 0, "sl": 1}
+        if order not in kinds:
+            raise ValueError("invalid order: " + order)
+        kind = kinds[order]
+        order = g.new_vertex_property("int64_t")
+        u = GraphView(g, directed=False)
+        libgraph_tool_topology.coloring_order(u._Graph__graph,
+                                              _prop("v", u, order), kind)
     if color is None:
         color = g.new_vertex_property("int")
 
-    libgraph_tool_topology.\
-        sequential_coloring(g._Graph__graph,
-                            _prop("v", g, order),
-                            _prop("v", g, color))
+    if parallel:
+        u = GraphView(g, directed=False)
+        libgraph_tool_topology.\
+            parallel_coloring(u._Graph__graph,
+                              _prop("v", u, order),
+                              _prop("v", u, color))
+    else:
+        libgraph_tool_topology.\
+            sequential_coloring(g._Graph__graph,
+                                _prop("v", g, order),
+                                _prop("v", g, color))
     return color
 
 